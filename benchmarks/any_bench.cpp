@@ -0,0 +1,104 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/any.h"
+#include "dap/protocol.h"
+#include "dap/variant.h"
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+namespace {
+
+void AnyAssignInteger(benchmark::State& state) {
+  dap::any value;
+  dap::integer i = 0;
+  for (auto _ : state) {
+    value = i++;
+    benchmark::DoNotOptimize(value.get<dap::integer>());
+  }
+}
+
+void AnyAssignString(benchmark::State& state) {
+  dap::any value;
+  dap::string str = "a string that does not fit in the small string buffer";
+  for (auto _ : state) {
+    value = str;
+    benchmark::DoNotOptimize(value.get<dap::string>());
+  }
+}
+
+void AnyCopyObject(benchmark::State& state) {
+  dap::object obj;
+  for (int i = 0; i < 8; i++) {
+    obj["field" + std::to_string(i)] = dap::integer(i);
+  }
+  dap::any value = obj;
+  for (auto _ : state) {
+    dap::any copy = value;
+    benchmark::DoNotOptimize(copy.is<dap::object>());
+  }
+}
+
+void VariantAssign(benchmark::State& state) {
+  dap::variant<dap::integer, dap::string, dap::boolean> value;
+  dap::integer i = 0;
+  for (auto _ : state) {
+    if (i++ % 2 == 0) {
+      value = dap::integer(i);
+    } else {
+      value = dap::boolean(true);
+    }
+    benchmark::DoNotOptimize(value.is<dap::integer>());
+  }
+}
+
+// stackFrames() returns count stack frames that each hold a source, which is
+// held out of line by its optional.
+std::vector<dap::StackFrame> stackFrames(size_t count) {
+  std::vector<dap::StackFrame> frames(count);
+  for (size_t i = 0; i < count; i++) {
+    frames[i].id = static_cast<dap::integer>(i);
+    frames[i].name = "frame";
+    dap::Source source;
+    source.path = "/path/to/source.cpp";
+    frames[i].source = std::move(source);
+  }
+  return frames;
+}
+
+void OptionalBuildStackFrames(benchmark::State& state) {
+  for (auto _ : state) {
+    auto frames = stackFrames(static_cast<size_t>(state.range(0)));
+    benchmark::DoNotOptimize(frames.data());
+  }
+}
+
+void OptionalCopyStackFrames(benchmark::State& state) {
+  auto frames = stackFrames(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto copy = frames;
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+
+}  // anonymous namespace
+
+BENCHMARK(AnyAssignInteger);
+BENCHMARK(AnyAssignString);
+BENCHMARK(AnyCopyObject);
+BENCHMARK(VariantAssign);
+BENCHMARK(OptionalBuildStackFrames)->Arg(100000);
+BENCHMARK(OptionalCopyStackFrames)->Arg(100000);
@@ -0,0 +1,55 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/bytes.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+std::vector<uint8_t> makeData(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+  return data;
+}
+
+void Base64Encode(benchmark::State& state) {
+  auto data = makeData(static_cast<size_t>(state.range(0)));
+  std::string out(dap::base64EncodedSize(data.size()), '\0');
+  for (auto _ : state) {
+    dap::base64Encode(data.data(), data.size(), &out[0]);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void Base64Decode(benchmark::State& state) {
+  auto data = makeData(static_cast<size_t>(state.range(0)));
+  auto str = dap::base64Encode(data.data(), data.size());
+  std::vector<uint8_t> out;
+  out.reserve(data.size() + 3);
+  for (auto _ : state) {
+    out.clear();
+    dap::base64Decode(str.data(), str.size(), &out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // anonymous namespace
+
+BENCHMARK(Base64Encode)->Arg(64)->Arg(64 << 10);
+BENCHMARK(Base64Decode)->Arg(64)->Arg(64 << 10);
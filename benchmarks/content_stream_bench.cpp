@@ -0,0 +1,78 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "content_stream.h"
+
+#include "dap/io.h"
+
+#include "benchmark/benchmark.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace {
+
+// LoopReader is a Reader that endlessly repeats the same data.
+class LoopReader : public dap::Reader {
+ public:
+  LoopReader(const std::string& data) : data(data) {}
+
+  bool isOpen() override { return true; }
+  void close() override {}
+  size_t read(void* buffer, size_t bytes) override {
+    auto n = std::min(bytes, data.size() - offset);
+    memcpy(buffer, data.data() + offset, n);
+    offset = (offset + n) % data.size();
+    return n;
+  }
+
+ private:
+  const std::string data;
+  size_t offset = 0;
+};
+
+// NullWriter is a Writer that discards all writes.
+class NullWriter : public dap::Writer {
+ public:
+  bool isOpen() override { return true; }
+  void close() override {}
+  bool write(const void*, size_t) override { return true; }
+};
+
+void ContentRead(benchmark::State& state) {
+  std::string content(static_cast<size_t>(state.range(0)), 'x');
+  auto framed =
+      "Content-Length: " + std::to_string(content.size()) + "\r\n\r\n" + content;
+  dap::ContentReader reader(std::make_shared<LoopReader>(framed));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(reader.read());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(framed.size()));
+}
+
+void ContentWrite(benchmark::State& state) {
+  std::string content(static_cast<size_t>(state.range(0)), 'x');
+  dap::ContentWriter writer(std::make_shared<NullWriter>());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(writer.write(content));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(content.size()));
+}
+
+}  // anonymous namespace
+
+BENCHMARK(ContentRead)->Range(64, 64 << 10);
+BENCHMARK(ContentWrite)->Range(64, 64 << 10);
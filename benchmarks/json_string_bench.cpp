@@ -0,0 +1,121 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "json_serializer.h"
+#include "json_string.h"
+
+#include "dap/protocol.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// makeLog() returns size bytes of program output, with the tabs, quotes,
+// backslashes and newlines typical of compiler and test logs.
+std::string makeLog(size_t size) {
+  static const char* const lines[] = {
+      "[ RUN      ] Session.Request\n",
+      "src/session.cpp:123:45: warning: unused variable 'x'\n",
+      "\tat C:\\work\\project\\main.cpp(17)\n",
+      "value = \"hello world\", count = 42\n",
+      "INFO 2026-01-01T00:00:00Z request completed in 1.5ms\n",
+  };
+  std::string out;
+  out.reserve(size);
+  for (size_t i = 0; out.size() < size; i++) {
+    out += lines[i % (sizeof(lines) / sizeof(lines[0]))];
+  }
+  out.resize(size);
+  return out;
+}
+
+void JSONEscape(benchmark::State& state) {
+  auto log = makeLog(static_cast<size_t>(state.range(0)));
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    dap::json::escapeString(log.data(), log.size(), &out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// makeUTF8Log() returns size bytes of program output in a non-Latin script,
+// which is mostly multi-byte UTF-8.
+std::string makeUTF8Log(size_t size) {
+  static const char line[] =
+      "\xd0\x97\xd0\xb0\xd0\xbf\xd1\x80\xd0\xbe\xd1\x81 "
+      "\xd0\xb2\xd1\x8b\xd0\xbf\xd0\xbe\xd0\xbb\xd0\xbd\xd0\xb5\xd0\xbd "
+      "\xe2\x80\x94 \xe5\xae\x8c\xe6\x88\x90 \"ok\"\n";
+  std::string out;
+  out.reserve(size + sizeof(line));
+  while (out.size() < size) {
+    out += line;
+  }
+  // Cut at a line boundary, so that the text stays valid UTF-8.
+  out.resize(out.rfind('\n', size - 1) + 1);
+  return out;
+}
+
+void JSONEscapeUTF8(benchmark::State& state) {
+  auto log = makeUTF8Log(static_cast<size_t>(state.range(0)));
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    dap::json::escapeString(log.data(), log.size(), &out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * log.size());
+}
+
+void JSONUnescape(benchmark::State& state) {
+  auto log = makeLog(static_cast<size_t>(state.range(0)));
+  std::string escaped;
+  dap::json::escapeString(log.data(), log.size(), &escaped);
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    dap::json::unescapeString(escaped.data(), escaped.size(), &out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void JSONValidUTF8(benchmark::State& state) {
+  auto log = makeUTF8Log(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dap::json::validUTF8(log.data(), log.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * log.size());
+}
+
+void SerializeOutputEvent(benchmark::State& state) {
+  dap::OutputEvent event;
+  event.category = "stdout";
+  event.output = makeLog(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    dap::json::Serializer s;
+    s.serialize(event);
+    benchmark::DoNotOptimize(s.dump());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // anonymous namespace
+
+BENCHMARK(JSONEscape)->Arg(4 << 20);
+BENCHMARK(JSONEscapeUTF8)->Arg(4 << 20);
+BENCHMARK(JSONUnescape)->Arg(4 << 20);
+BENCHMARK(JSONValidUTF8)->Arg(4 << 20);
+BENCHMARK(SerializeOutputEvent)->Arg(4 << 20);
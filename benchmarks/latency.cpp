@@ -0,0 +1,303 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// cppdap-latency measures the request to response round-trip latency, and the
+// saturation throughput, between two dap::Sessions over each transport.
+//
+// Usage:
+//   cppdap-latency [--transport=all|pipe|file|tcp] [--size=<bytes>]
+//                  [--concurrency=<n>] [--requests=<n>] [--port=<port>]
+//                  [--help]
+//
+// --size is the size of the request argument and response body strings.
+// --concurrency is the number of threads sending requests at the same time.
+// --requests is the total number of requests sent for each transport.
+
+#include "dap/io.h"
+#include "dap/network.h"
+#include "dap/protocol.h"
+#include "dap/session.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define fdopen _fdopen
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  std::string transport = "all";
+  size_t size = 64;
+  int concurrency = 1;
+  int requests = 10000;
+  int port = 19022;
+};
+
+// Connection is a connected client and server Session.
+struct Connection {
+  std::unique_ptr<dap::Session> client;
+  std::unique_ptr<dap::Session> server;
+  // close is called before the sessions are destructed, to unblock any
+  // pending reads.
+  std::function<void()> close;
+};
+
+// Transport creates a connection, calling bind to bind each Session.
+using Transport = std::function<bool(Connection&)>;
+
+bool pipeTransport(Connection& conn) {
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  conn.client->bind(server2client, client2server);
+  conn.server->bind(client2server, server2client);
+  return true;
+}
+
+// osPipe() returns a dap::file() Reader and Writer pair for a new OS pipe.
+bool osPipe(std::shared_ptr<dap::ReaderWriter>& reader,
+            std::shared_ptr<dap::ReaderWriter>& writer) {
+  int fds[2];
+#ifdef _WIN32
+  if (_pipe(fds, 65536, _O_BINARY) != 0) {
+#else
+  if (::pipe(fds) != 0) {
+#endif
+    return false;
+  }
+  reader = dap::file(fdopen(fds[0], "rb"));
+  writer = dap::file(fdopen(fds[1], "wb"));
+  return true;
+}
+
+bool fileTransport(Connection& conn) {
+  std::shared_ptr<dap::ReaderWriter> c2sRead, c2sWrite, s2cRead, s2cWrite;
+  if (!osPipe(c2sRead, c2sWrite) || !osPipe(s2cRead, s2cWrite)) {
+    return false;
+  }
+  conn.client->bind(s2cRead, c2sWrite);
+  conn.server->bind(c2sRead, s2cWrite);
+  // Closing the write ends signals EOF to the blocked readers.
+  conn.close = [=] {
+    c2sWrite->close();
+    s2cWrite->close();
+  };
+  return true;
+}
+
+Transport tcpTransport(int port) {
+  return [port](Connection& conn) {
+    auto server = std::shared_ptr<dap::net::Server>(dap::net::Server::create());
+    // Accepted is shared with the accept callback, which may outlive this
+    // function if the client fails to connect.
+    struct Accepted {
+      std::mutex mutex;
+      std::condition_variable cv;
+      std::shared_ptr<dap::ReaderWriter> socket;
+    };
+    auto accepted = std::make_shared<Accepted>();
+    if (!server->start(
+            port, [accepted](const std::shared_ptr<dap::ReaderWriter>& s) {
+              std::unique_lock<std::mutex> lock(accepted->mutex);
+              accepted->socket = s;
+              accepted->cv.notify_all();
+            })) {
+      return false;
+    }
+    auto client = dap::net::connect("localhost", port, 5000);
+    if (!client) {
+      server->stop();
+      return false;
+    }
+    std::shared_ptr<dap::ReaderWriter> socket;
+    {
+      std::unique_lock<std::mutex> lock(accepted->mutex);
+      accepted->cv.wait(lock, [&] { return accepted->socket != nullptr; });
+      socket = accepted->socket;
+    }
+    conn.client->bind(client);
+    conn.server->bind(socket);
+    conn.close = [server, client, socket] {
+      server->stop();
+      client->close();
+      socket->close();
+    };
+    return true;
+  };
+}
+
+// percentile() returns the p'th percentile of the sorted latencies.
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto i = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+  return sorted[i];
+}
+
+bool run(const char* name, const Transport& transport, const Config& config) {
+  Connection conn;
+  conn.client = dap::Session::create();
+  conn.server = dap::Session::create();
+  auto body = std::string(config.size, 'x');
+  conn.server->registerHandler([&](const dap::EvaluateRequest&) {
+    dap::EvaluateResponse response;
+    response.result = body;
+    return response;
+  });
+  if (!transport(conn)) {
+    fprintf(stderr, "%s: failed to connect\n", name);
+    return false;
+  }
+
+  dap::EvaluateRequest request;
+  request.expression = body;
+
+  // Warm up the connection before measuring.
+  for (int i = 0; i < 100; i++) {
+    conn.client->send(request).get();
+  }
+
+  std::vector<std::vector<double>> latencies(config.concurrency);
+  std::vector<std::thread> threads;
+  bool ok = true;
+  std::mutex okMutex;
+  auto start = Clock::now();
+  for (int t = 0; t < config.concurrency; t++) {
+    threads.emplace_back([&, t] {
+      auto& out = latencies[t];
+      int count = config.requests / config.concurrency +
+                  (t < config.requests % config.concurrency ? 1 : 0);
+      out.reserve(count);
+      for (int i = 0; i < count; i++) {
+        auto sent = Clock::now();
+        auto response = conn.client->send(request).get();
+        out.push_back(
+            std::chrono::duration<double, std::micro>(Clock::now() - sent)
+                .count());
+        if (response.error) {
+          std::unique_lock<std::mutex> lock(okMutex);
+          ok = false;
+          return;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+  if (conn.close) {
+    conn.close();
+  }
+  conn.client.reset();
+  conn.server.reset();
+
+  if (!ok) {
+    fprintf(stderr, "%s: request failed\n", name);
+    return false;
+  }
+
+  std::vector<double> all;
+  for (auto& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  std::sort(all.begin(), all.end());
+  printf("%-6s %10zu %12d %10zu %14.0f %10.1f %10.1f %10.1f\n", name,
+         config.size, config.concurrency, all.size(),
+         static_cast<double>(all.size()) / elapsed, percentile(all, 0.5),
+         percentile(all, 0.99), percentile(all, 0.999));
+  return true;
+}
+
+// parseArg() returns true and assigns value if arg has the given prefix.
+bool parseArg(const char* arg, const char* prefix, std::string& value) {
+  auto len = strlen(prefix);
+  if (strncmp(arg, prefix, len) != 0) {
+    return false;
+  }
+  value = arg + len;
+  return true;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  Config config;
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (parseArg(argv[i], "--transport=", value)) {
+      config.transport = value;
+    } else if (parseArg(argv[i], "--size=", value)) {
+      config.size = static_cast<size_t>(atol(value.c_str()));
+    } else if (parseArg(argv[i], "--concurrency=", value)) {
+      config.concurrency = std::max(atoi(value.c_str()), 1);
+    } else if (parseArg(argv[i], "--requests=", value)) {
+      config.requests = std::max(atoi(value.c_str()), 1);
+    } else if (parseArg(argv[i], "--port=", value)) {
+      config.port = atoi(value.c_str());
+    } else {
+      bool help = strcmp(argv[i], "--help") == 0;
+      fprintf(help ? stdout : stderr,
+              "Usage: %s [--transport=all|pipe|file|tcp] [--size=<bytes>] "
+              "[--concurrency=<n>] [--requests=<n>] [--port=<port>]\n",
+              argv[0]);
+      return help ? 0 : 1;
+    }
+  }
+
+  struct Entry {
+    const char* name;
+    Transport transport;
+  };
+  std::vector<Entry> transports = {
+      {"pipe", pipeTransport},
+      {"file", fileTransport},
+      {"tcp", tcpTransport(config.port)},
+  };
+
+  printf("%-6s %10s %12s %10s %14s %10s %10s %10s\n", "", "size",
+         "concurrency", "requests", "requests/s", "p50 (us)", "p99 (us)",
+         "p999 (us)");
+  bool found = false;
+  bool ok = true;
+  for (auto& entry : transports) {
+    if (config.transport == "all" || config.transport == entry.name) {
+      found = true;
+      ok = run(entry.name, entry.transport, config) && ok;
+    }
+  }
+  if (!found) {
+    fprintf(stderr, "Unknown transport '%s'\n", config.transport.c_str());
+    return 1;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_benchmarks_messages_h
+#define dap_benchmarks_messages_h
+
+#include "dap/protocol.h"
+
+#include <string>
+
+namespace dap {
+namespace bench {
+
+// stackTraceResponse() returns a StackTraceResponse with numFrames frames.
+inline StackTraceResponse stackTraceResponse(int numFrames = 64) {
+  StackTraceResponse response;
+  response.totalFrames = numFrames;
+  for (int i = 0; i < numFrames; i++) {
+    StackFrame frame;
+    frame.id = i;
+    frame.name = "namespace::Class::method" + std::to_string(i);
+    frame.line = 100 + i;
+    frame.column = 4;
+    Source source;
+    source.name = "file" + std::to_string(i % 8) + ".cpp";
+    source.path = "/home/user/project/src/" + source.name.value();
+    frame.source = source;
+    response.stackFrames.push_back(frame);
+  }
+  return response;
+}
+
+// variablesResponse() returns a VariablesResponse with numVariables
+// variables.
+inline VariablesResponse variablesResponse(int numVariables = 128) {
+  VariablesResponse response;
+  for (int i = 0; i < numVariables; i++) {
+    Variable variable;
+    variable.name = "variable" + std::to_string(i);
+    variable.value = std::to_string(i * 31);
+    variable.type = "int";
+    variable.variablesReference = i % 4 == 0 ? i : 0;
+    response.variables.push_back(variable);
+  }
+  return response;
+}
+
+// setBreakpointsRequest() returns a SetBreakpointsRequest with numBreakpoints
+// breakpoints.
+inline SetBreakpointsRequest setBreakpointsRequest(int numBreakpoints = 32) {
+  SetBreakpointsRequest request;
+  request.source.path = "/home/user/project/src/main.cpp";
+  request.source.name = "main.cpp";
+  array<SourceBreakpoint> breakpoints;
+  for (int i = 0; i < numBreakpoints; i++) {
+    SourceBreakpoint breakpoint;
+    breakpoint.line = 10 * i;
+    if (i % 4 == 0) {
+      breakpoint.condition = "i > " + std::to_string(i);
+    }
+    breakpoints.push_back(breakpoint);
+  }
+  request.breakpoints = breakpoints;
+  return request;
+}
+
+// outputEvent() returns an OutputEvent with a line of program output.
+inline OutputEvent outputEvent() {
+  OutputEvent event;
+  event.category = "stdout";
+  event.output = "The quick brown fox jumps over the lazy dog. 0123456789\n";
+  return event;
+}
+
+}  // namespace bench
+}  // namespace dap
+
+#endif  // dap_benchmarks_messages_h
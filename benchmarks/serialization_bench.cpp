@@ -0,0 +1,81 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "messages.h"
+
+#include "json_serializer.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// serialize() returns the JSON serialization of value.
+template <typename T>
+std::string serialize(const T& value) {
+  dap::json::Serializer s;
+  s.serialize(value);
+  return s.dump();
+}
+
+template <typename T>
+void Serialize(benchmark::State& state, const T& value) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    dap::json::Serializer s;
+    s.serialize(value);
+    auto json = s.dump();
+    bytes += json.size();
+    benchmark::DoNotOptimize(json);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+template <typename T>
+void Deserialize(benchmark::State& state, const T& value) {
+  auto json = serialize(value);
+  for (auto _ : state) {
+    dap::json::Deserializer d(json);
+    T out;
+    benchmark::DoNotOptimize(d.deserialize(&out));
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(json.size()));
+}
+
+}  // anonymous namespace
+
+// The JSON library is chosen when cppdap is built, so these benchmarks measure
+// the library selected with the CPPDAP_USE_EXTERNAL_*_PACKAGE options.
+BENCHMARK_CAPTURE(Serialize,
+                  StackTraceResponse,
+                  dap::bench::stackTraceResponse());
+BENCHMARK_CAPTURE(Serialize,
+                  VariablesResponse,
+                  dap::bench::variablesResponse());
+BENCHMARK_CAPTURE(Serialize,
+                  SetBreakpointsRequest,
+                  dap::bench::setBreakpointsRequest());
+BENCHMARK_CAPTURE(Serialize, OutputEvent, dap::bench::outputEvent());
+
+BENCHMARK_CAPTURE(Deserialize,
+                  StackTraceResponse,
+                  dap::bench::stackTraceResponse());
+BENCHMARK_CAPTURE(Deserialize,
+                  VariablesResponse,
+                  dap::bench::variablesResponse());
+BENCHMARK_CAPTURE(Deserialize,
+                  SetBreakpointsRequest,
+                  dap::bench::setBreakpointsRequest());
+BENCHMARK_CAPTURE(Deserialize, OutputEvent, dap::bench::outputEvent());
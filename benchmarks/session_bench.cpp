@@ -0,0 +1,124 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "messages.h"
+
+#include "dap/io.h"
+#include "dap/session.h"
+
+#include "benchmark/benchmark.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace {
+
+// SessionPair is a client and server Session connected with dap::pipe().
+struct SessionPair {
+  SessionPair() {
+    client = dap::Session::create();
+    server = dap::Session::create();
+    auto client2server = dap::pipe();
+    auto server2client = dap::pipe();
+    client->bind(server2client, client2server);
+    server->bind(client2server, server2client);
+  }
+
+  std::unique_ptr<dap::Session> client;
+  std::unique_ptr<dap::Session> server;
+};
+
+void SessionRoundTrip(benchmark::State& state) {
+  SessionPair pair;
+  auto response = dap::bench::stackTraceResponse(
+      static_cast<int>(state.range(0)));
+  pair.server->registerHandler(
+      [&](const dap::StackTraceRequest&) { return response; });
+  dap::StackTraceRequest request;
+  request.threadId = 1;
+  for (auto _ : state) {
+    auto got = pair.client->send(request).get();
+    benchmark::DoNotOptimize(got);
+  }
+}
+
+void SessionEventThroughput(benchmark::State& state) {
+  SessionPair pair;
+  std::mutex mutex;
+  std::condition_variable cv;
+  int64_t received = 0;
+  pair.client->registerHandler([&](const dap::OutputEvent&) {
+    std::unique_lock<std::mutex> lock(mutex);
+    received++;
+    cv.notify_all();
+  });
+  auto event = dap::bench::outputEvent();
+  int64_t sent = 0;
+  for (auto _ : state) {
+    pair.server->send(event);
+    sent++;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return received == sent; });
+  state.SetItemsProcessed(sent);
+}
+
+// DiscardWriter is a Writer that discards everything written to it.
+class DiscardWriter : public dap::Writer {
+ public:
+  bool isOpen() override { return true; }
+  void close() override {}
+  bool write(const void*, size_t) override { return true; }
+};
+
+// makeOutput() returns size bytes of program output.
+std::string makeOutput(size_t size) {
+  static const char line[] = "[ RUN      ] Session.\"Output\"\tC:\\work\n";
+  std::string out;
+  while (out.size() < size) {
+    out += line;
+  }
+  out.resize(size);
+  return out;
+}
+
+void SessionSendOutputEvent(benchmark::State& state) {
+  auto session = dap::Session::create();
+  session->connect(dap::pipe(), std::make_shared<DiscardWriter>());
+  auto output = makeOutput(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    dap::OutputEvent event;
+    event.category = "stdout";
+    event.output.assign(output.data(), output.size());
+    session->send(event);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void SessionSendOutput(benchmark::State& state) {
+  auto session = dap::Session::create();
+  session->connect(dap::pipe(), std::make_shared<DiscardWriter>());
+  auto output = makeOutput(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    session->sendOutput(output.data(), output.size(), "stdout");
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // anonymous namespace
+
+BENCHMARK(SessionRoundTrip)->Arg(1)->Arg(64)->UseRealTime();
+BENCHMARK(SessionEventThroughput)->UseRealTime();
+BENCHMARK(SessionSendOutputEvent)->Arg(256)->Arg(64 << 10)->Arg(4 << 20);
+BENCHMARK(SessionSendOutput)->Arg(256)->Arg(64 << 10)->Arg(4 << 20);
@@ -96,8 +96,11 @@ any::any(any&& other) noexcept : type(other.type) {
   if (other.isInBuffer(other.value)) {
     alloc(type->size(), type->alignment());
     type->copyConstruct(value, other.value);
+    type->destruct(other.value);
   } else {
     value = other.value;
+    heap = other.heap;
+    other.heap = nullptr;
   }
   other.value = nullptr;
   other.type = nullptr;
@@ -128,8 +131,11 @@ any& any::operator=(any&& rhs) noexcept {
   if (rhs.isInBuffer(rhs.value)) {
     alloc(type->size(), type->alignment());
     type->copyConstruct(value, rhs.value);
+    type->destruct(rhs.value);
   } else {
     value = rhs.value;
+    heap = rhs.heap;
+    rhs.heap = nullptr;
   }
   rhs.value = nullptr;
   rhs.type = nullptr;
@@ -0,0 +1,64 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_broadcast_h
+#define dap_broadcast_h
+
+#include "session.h"
+
+#include <stddef.h>
+#include <memory>
+
+namespace dap {
+
+// BroadcastGroup sends events to a group of sessions, serializing each event
+// once for the whole group. See SerializedEvent.
+class BroadcastGroup {
+ public:
+  virtual ~BroadcastGroup();
+
+  // create() constructs and returns a new, empty BroadcastGroup.
+  static std::unique_ptr<BroadcastGroup> create();
+
+  // add() adds the session to the group. The session must be removed from the
+  // group before it is destructed.
+  virtual void add(Session* session) = 0;
+
+  // remove() removes the session from the group. remove() blocks until any
+  // send() to the session has completed.
+  virtual void remove(Session* session) = 0;
+
+  // size() returns the number of sessions in the group.
+  virtual size_t size() = 0;
+
+  // send() sends the serialized event to each session in the group, returning
+  // the number of sessions that the event was sent to successfully. The group
+  // is not locked while the event is written, so sessions may be added and
+  // removed while send() is blocked on a slow session.
+  virtual size_t send(const SerializedEvent& event) = 0;
+
+  // send() serializes the event, and sends it to each session in the group,
+  // returning the number of sessions that the event was sent to successfully.
+  template <typename T, typename = traits::EnableIfIsType<dap::Event, T>>
+  inline size_t send(const T& event);
+};
+
+template <typename T, typename>
+size_t BroadcastGroup::send(const T& event) {
+  return send(SerializedEvent::create(event));
+}
+
+}  // namespace dap
+
+#endif  // dap_broadcast_h
@@ -0,0 +1,63 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_bytes_h
+#define dap_bytes_h
+
+#include "typeof.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace dap {
+
+// bytes is a sequence of bytes that is serialized as a base64 encoded string,
+// as used by the memory requests. The bytes are encoded directly to, and
+// decoded directly from, the serializer's string storage.
+class bytes : public std::vector<uint8_t> {
+ public:
+  using std::vector<uint8_t>::vector;
+  inline bytes() = default;
+};
+
+template <>
+struct TypeOf<bytes> {
+  static const TypeInfo* type();
+};
+
+// base64EncodedSize() returns the length of the base64 encoding of size
+// bytes, including padding.
+inline size_t base64EncodedSize(size_t size) {
+  return (size + 2) / 3 * 4;
+}
+
+// base64Encode() writes the base64 encoding of the size bytes at data to out,
+// which must have room for base64EncodedSize(size) characters.
+// The encoding uses the standard alphabet with padding, as described by
+// RFC 4648. SIMD instructions are used where the CPU supports them.
+void base64Encode(const void* data, size_t size, char* out);
+
+// base64Encode() returns the base64 encoding of the size bytes at data.
+std::string base64Encode(const void* data, size_t size);
+
+// base64Decode() appends the bytes decoded from the size base64 characters at
+// str to out. Padding is optional. Returns false if str is not valid base64,
+// in which case the contents of out are unspecified.
+bool base64Decode(const char* str, size_t size, std::vector<uint8_t>* out);
+
+}  // namespace dap
+
+#endif  // dap_bytes_h
@@ -0,0 +1,264 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This header provides C++20 coroutine support for cppdap.
+// It is not included by any other cppdap header, and must be explicitly
+// included by code that is compiled with C++20 or later.
+//
+// Example:
+//
+//   dap::task<void> launch(dap::Session* session) {
+//     dap::RunInTerminalRequest request;
+//     auto response = co_await session->send(request);
+//     ...
+//   }
+//
+//   dap::registerCoroutineHandler(
+//       session, [=](const dap::EvaluateRequest& req)
+//                    -> dap::task<dap::ResponseOrError<dap::EvaluateResponse>> {
+//         dap::RunInTerminalRequest request;
+//         auto pid = co_await session->send(request);
+//         ...
+//       });
+
+#ifndef dap_coroutine_h
+#define dap_coroutine_h
+
+#if !defined(__cpp_impl_coroutine)
+#error "dap/coroutine.h requires a compiler with C++20 coroutine support"
+#endif
+
+#include "future.h"
+#include "session.h"
+#include "traits.h"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace dap {
+
+// forward declaration
+template <typename T = void>
+class task;
+
+// internal functionality
+namespace detail {
+
+struct task_promise_base {
+  // final_awaiter resumes the coroutine awaiting the task, if any.
+  struct final_awaiter {
+    inline bool await_ready() noexcept { return false; }
+    template <typename P>
+    inline std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<P> handle) noexcept {
+      if (auto continuation = handle.promise().continuation) {
+        return continuation;
+      }
+      return std::noop_coroutine();
+    }
+    inline void await_resume() noexcept {}
+  };
+
+  inline std::suspend_always initial_suspend() noexcept { return {}; }
+  inline final_awaiter final_suspend() noexcept { return {}; }
+  // cppdap does not use exceptions.
+  inline void unhandled_exception() noexcept { std::terminate(); }
+
+  std::coroutine_handle<> continuation;
+};
+
+template <typename T>
+struct task_promise : public task_promise_base {
+  inline task<T> get_return_object() noexcept;
+
+  template <typename U>
+  inline void return_value(U&& v) {
+    value.emplace(std::forward<U>(v));
+  }
+
+  std::optional<T> value;
+};
+
+template <>
+struct task_promise<void> : public task_promise_base {
+  inline task<void> get_return_object() noexcept;
+  inline void return_void() noexcept {}
+};
+
+// detached_task is the return type of a coroutine that starts immediately, and
+// destroys itself on completion.
+struct detached_task {
+  struct promise_type {
+    inline detached_task get_return_object() noexcept { return {}; }
+    inline std::suspend_never initial_suspend() noexcept { return {}; }
+    inline std::suspend_never final_suspend() noexcept { return {}; }
+    inline void return_void() noexcept {}
+    inline void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+// future_awaiter is the awaiter used to co_await a dap::future.
+template <typename T>
+struct future_awaiter {
+  inline bool await_ready() noexcept { return false; }
+  inline bool await_suspend(std::coroutine_handle<> handle) {
+    return f.setOnReady([handle] { handle.resume(); });
+  }
+  inline T await_resume() { return f.get(); }
+
+  future<T> f;
+};
+
+}  // namespace detail
+
+// task is the return type of a coroutine that produces a value of type T.
+// A task does not start executing until it is awaited with co_await, or
+// passed to spawn().
+template <typename T>
+class task {
+ public:
+  using promise_type = detail::task_promise<T>;
+
+  inline task(task&& other) noexcept
+      : handle(std::exchange(other.handle, {})) {}
+  inline task& operator=(task&& other) noexcept;
+  inline ~task();
+
+  // operator co_await() starts the task, suspending the awaiting coroutine
+  // until the task has completed, and then returns the task's result.
+  inline auto operator co_await() && noexcept;
+
+ private:
+  friend promise_type;
+  task(const task&) = delete;
+  task& operator=(const task&) = delete;
+  inline explicit task(std::coroutine_handle<promise_type> handle)
+      : handle(handle) {}
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+task<T>& task<T>::operator=(task&& other) noexcept {
+  if (this != &other) {
+    if (handle) {
+      handle.destroy();
+    }
+    handle = std::exchange(other.handle, {});
+  }
+  return *this;
+}
+
+template <typename T>
+task<T>::~task() {
+  if (handle) {
+    handle.destroy();
+  }
+}
+
+template <typename T>
+auto task<T>::operator co_await() && noexcept {
+  struct awaiter {
+    bool await_ready() noexcept { return handle.done(); }
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<> caller) noexcept {
+      handle.promise().continuation = caller;
+      return handle;
+    }
+    T await_resume() {
+      if constexpr (!std::is_void_v<T>) {
+        return std::move(*handle.promise().value);
+      }
+    }
+    std::coroutine_handle<promise_type> handle;
+  };
+  return awaiter{handle};
+}
+
+template <typename T>
+task<T> detail::task_promise<T>::get_return_object() noexcept {
+  return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+}
+
+task<void> detail::task_promise<void>::get_return_object() noexcept {
+  return task<void>(
+      std::coroutine_handle<task_promise<void>>::from_promise(*this));
+}
+
+// operator co_await() suspends the awaiting coroutine until the future has a
+// valid result, and then returns the result.
+// The coroutine is resumed on the thread that assigns the future's value. For
+// futures returned by Session::send(), this is the session's message receiving
+// thread, so the coroutine should not block once resumed.
+template <typename T>
+inline detail::future_awaiter<T> operator co_await(future<T>&& f) {
+  return detail::future_awaiter<T>{std::move(f)};
+}
+
+// spawn() starts executing the task t. The task runs until its first
+// suspension point before spawn() returns.
+inline void spawn(task<void> t) {
+  [](task<void> t) -> detail::detached_task {
+    co_await std::move(t);
+  }(std::move(t));
+}
+
+// spawn() starts executing the task t, calling onComplete with the task's
+// result once it has completed. The task runs until its first suspension point
+// before spawn() returns.
+template <typename T, typename F>
+inline void spawn(task<T> t, F&& onComplete) {
+  [](task<T> t, typename std::decay<F>::type onComplete)
+      -> detail::detached_task {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(t);
+      onComplete();
+    } else {
+      onComplete(co_await std::move(t));
+    }
+  }(std::move(t), std::forward<F>(onComplete));
+}
+
+// registerCoroutineHandler() registers the coroutine handler for a specific
+// request type with the session.
+// The function F must have one of the following signatures:
+//   task<ResponseOrError<ResponseType>>(const RequestType&)
+//   task<ResponseType>(const RequestType&)
+//   task<Error>(const RequestType&)
+// The request passed to the handler remains valid until the coroutine has
+// completed.
+template <typename F,
+          typename RequestType = traits::ParameterType<F, 0>,
+          typename ResponseType = typename RequestType::Response>
+inline void registerCoroutineHandler(Session* session, F&& handler) {
+  using Result = ResponseOrError<ResponseType>;
+  using Callback = std::function<void(Result)>;
+  session->registerHandler([handler](const RequestType& request,
+                                     const Callback& callback) {
+    // The coroutine frame holds copies of the handler and request, as the
+    // request is destructed once this function returns.
+    [](typename std::decay<F>::type handler, RequestType request,
+       Callback callback) -> detail::detached_task {
+      Result result = co_await handler(request);
+      callback(std::move(result));
+    }(handler, request, callback);
+  });
+}
+
+}  // namespace dap
+
+#endif  // dap_coroutine_h
@@ -0,0 +1,48 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_executor_h
+#define dap_executor_h
+
+#include <stddef.h>
+#include <functional>
+#include <memory>
+
+namespace dap {
+
+// Executor is an interface for running tasks asynchronously.
+// An Executor can be shared by many Sessions, so that the number of threads
+// used to process incoming messages does not grow with the number of
+// Sessions. See Session::Options.
+class Executor {
+ public:
+  using Task = std::function<void()>;
+
+  virtual ~Executor();
+
+  // enqueue() schedules task to be run on one of the executor's threads.
+  // Tasks may run concurrently, and in any order.
+  virtual void enqueue(Task&& task) = 0;
+
+  // create() returns a work-stealing thread pool Executor with numThreads
+  // worker threads. If numThreads is 0, then the number of worker threads is
+  // the number of hardware threads.
+  // Destructing the Executor waits for all enqueued tasks to complete, and so
+  // must not happen on one of the executor's own threads.
+  static std::shared_ptr<Executor> create(size_t numThreads = 0);
+};
+
+}  // namespace dap
+
+#endif  // dap_executor_h
@@ -15,9 +15,14 @@
 #ifndef dap_future_h
 #define dap_future_h
 
+#include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace dap {
 
@@ -27,9 +32,21 @@ template <typename T>
 struct promise_state {
   T val;
   std::mutex mutex;
-  std::condition_variable cv;
+  // cv is only constructed once a thread blocks waiting for the value, so
+  // futures that are only consumed with then() never allocate one.
+  std::unique_ptr<std::condition_variable> cv;
   bool hasVal = false;
+  // onReady is called once val has been assigned, without the mutex held.
+  std::function<void()> onReady;
 };
+
+template <typename T>
+struct future_awaiter;
+
+// continuation_result is the type returned by calling F with a T.
+template <typename F, typename T>
+using continuation_result =
+    decltype(std::declval<F>()(std::declval<T>()));
 }  // namespace detail
 
 // forward declaration
@@ -46,6 +63,7 @@ enum class future_status {
 // future is a minimal reimplementation of std::future, that does not suffer
 // from TSAN false positives. See:
 // https://gcc.gnu.org/bugzilla//show_bug.cgi?id=69204
+// A default constructed future has no internal state, and does not allocate.
 template <typename T>
 class future {
  public:
@@ -54,6 +72,7 @@ class future {
   // constructors
   inline future() = default;
   inline future(future&&) = default;
+  inline future& operator=(future&&) = default;
 
   // valid() returns true if the future has an internal state.
   bool valid() const;
@@ -80,17 +99,58 @@ class future {
   future_status wait_until(
       const std::chrono::time_point<Clock, Duration>& timeout) const;
 
+  // then() calls f with the future's result once it is available, and returns
+  // a future that is assigned the value returned by f. If f returns void,
+  // then() also returns void.
+  // f is called on the thread that assigns the result, or on the calling
+  // thread if the result is already available, so f must not block.
+  // then() consumes the future's internal state, leaving the future invalid.
+  // The future must have a valid internal state to call this method.
+  template <typename F, typename R = detail::continuation_result<F, T>>
+  inline typename std::enable_if<!std::is_void<R>::value, future<R>>::type
+  then(F&& f);
+  template <typename F, typename R = detail::continuation_result<F, T>>
+  inline typename std::enable_if<std::is_void<R>::value>::type then(F&& f);
+
  private:
   friend promise<T>;
+  friend detail::future_awaiter<T>;
   future(const future&) = delete;
   inline future(const std::shared_ptr<State>& state);
 
-  std::shared_ptr<State> state = std::make_shared<State>();
+  // setOnReady() sets the function to call once the future has a valid
+  // result. Returns false, without setting the function, if the future already
+  // has a valid result.
+  inline bool setOnReady(std::function<void()>&& onReady);
+
+  // waiter() returns the condition variable used to wait for the result,
+  // constructing it if necessary. The state mutex must be locked.
+  inline std::condition_variable& waiter() const;
+
+  std::shared_ptr<State> state;
 };
 
 template <typename T>
 future<T>::future(const std::shared_ptr<State>& s) : state(s) {}
 
+template <typename T>
+bool future<T>::setOnReady(std::function<void()>&& onReady) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  if (state->hasVal) {
+    return false;
+  }
+  state->onReady = std::move(onReady);
+  return true;
+}
+
+template <typename T>
+std::condition_variable& future<T>::waiter() const {
+  if (!state->cv) {
+    state->cv.reset(new std::condition_variable());
+  }
+  return *state->cv;
+}
+
 template <typename T>
 bool future<T>::valid() const {
   return static_cast<bool>(state);
@@ -98,15 +158,16 @@ bool future<T>::valid() const {
 
 template <typename T>
 T future<T>::get() {
-  std::unique_lock<std::mutex> lock(state->mutex);
-  state->cv.wait(lock, [&] { return state->hasVal; });
+  wait();
   return state->val;
 }
 
 template <typename T>
 void future<T>::wait() const {
   std::unique_lock<std::mutex> lock(state->mutex);
-  state->cv.wait(lock, [&] { return state->hasVal; });
+  if (!state->hasVal) {
+    waiter().wait(lock, [&] { return state->hasVal; });
+  }
 }
 
 template <typename T>
@@ -114,7 +175,8 @@ template <class Rep, class Period>
 future_status future<T>::wait_for(
     const std::chrono::duration<Rep, Period>& timeout) const {
   std::unique_lock<std::mutex> lock(state->mutex);
-  return state->cv.wait_for(lock, timeout, [&] { return state->hasVal; })
+  return state->hasVal ||
+                 waiter().wait_for(lock, timeout, [&] { return state->hasVal; })
              ? future_status::ready
              : future_status::timeout;
 }
@@ -124,21 +186,54 @@ template <class Clock, class Duration>
 future_status future<T>::wait_until(
     const std::chrono::time_point<Clock, Duration>& timeout) const {
   std::unique_lock<std::mutex> lock(state->mutex);
-  return state->cv.wait_until(lock, timeout, [&] { return state->hasVal; })
+  return state->hasVal || waiter().wait_until(lock, timeout,
+                                              [&] { return state->hasVal; })
              ? future_status::ready
              : future_status::timeout;
 }
 
+template <typename T>
+template <typename F, typename R>
+typename std::enable_if<!std::is_void<R>::value, future<R>>::type
+future<T>::then(F&& f) {
+  promise<R> p;
+  auto out = p.get_future();
+  typename std::decay<F>::type fn(std::forward<F>(f));
+  then([p, fn](T&& value) mutable { p.set_value(fn(std::move(value))); });
+  return out;
+}
+
+template <typename T>
+template <typename F, typename R>
+typename std::enable_if<std::is_void<R>::value>::type future<T>::then(F&& f) {
+  auto s = std::move(state);
+  // The promise holds a reference on the state while calling onReady, so the
+  // continuation can safely use a raw pointer, avoiding a reference cycle.
+  auto raw = s.get();
+  typename std::decay<F>::type fn(std::forward<F>(f));
+  {
+    std::unique_lock<std::mutex> lock(s->mutex);
+    if (!s->hasVal) {
+      s->onReady = [raw, fn]() mutable { fn(std::move(raw->val)); };
+      return;
+    }
+  }
+  fn(std::move(s->val));
+}
+
 // promise is a minimal reimplementation of std::promise, that does not suffer
 // from TSAN false positives. See:
 // https://gcc.gnu.org/bugzilla//show_bug.cgi?id=69204
+// The shared state is only allocated once the promise is first used or
+// copied, as copies share the state. A promise that has not been used must
+// not be copied concurrently.
 template <typename T>
 class promise {
  public:
   // constructors
   inline promise() = default;
   inline promise(promise&& other) = default;
-  inline promise(const promise& other) = default;
+  inline promise(const promise& other);
 
   // set_value() stores value to the shared state.
   // set_value() must only be called once.
@@ -150,28 +245,118 @@ class promise {
 
  private:
   using State = detail::promise_state<T>;
-  std::shared_ptr<State> state = std::make_shared<State>();
+
+  // notify() marks the value as assigned, waking any blocked threads and
+  // calling any continuation. notify() unlocks lock.
+  inline void notify(std::unique_lock<std::mutex>& lock) const;
+
+  // shared() returns the shared state, allocating it if necessary.
+  inline const std::shared_ptr<State>& shared() const;
+
+  mutable std::shared_ptr<State> state;
 };
 
+template <typename T>
+promise<T>::promise(const promise& other) : state(other.shared()) {}
+
+template <typename T>
+const std::shared_ptr<typename promise<T>::State>& promise<T>::shared() const {
+  if (!state) {
+    state = std::make_shared<State>();
+  }
+  return state;
+}
+
 template <typename T>
 future<T> promise<T>::get_future() {
-  return future<T>(state);
+  return future<T>(shared());
 }
 
 template <typename T>
 void promise<T>::set_value(const T& value) const {
-  std::unique_lock<std::mutex> lock(state->mutex);
+  std::unique_lock<std::mutex> lock(shared()->mutex);
   state->val = value;
-  state->hasVal = true;
-  state->cv.notify_all();
+  notify(lock);
 }
 
 template <typename T>
 void promise<T>::set_value(T&& value) const {
-  std::unique_lock<std::mutex> lock(state->mutex);
+  std::unique_lock<std::mutex> lock(shared()->mutex);
   state->val = std::move(value);
+  notify(lock);
+}
+
+template <typename T>
+void promise<T>::notify(std::unique_lock<std::mutex>& lock) const {
   state->hasVal = true;
-  state->cv.notify_all();
+  if (state->cv) {
+    state->cv->notify_all();
+  }
+  auto onReady = std::move(state->onReady);
+  lock.unlock();
+  if (onReady) {
+    onReady();
+  }
+}
+
+// when_all() returns a future that is assigned the results of all the futures
+// once they all have a result. The results are in the same order as futures.
+template <typename T>
+inline future<std::vector<T>> when_all(std::vector<future<T>>&& futures) {
+  struct Shared {
+    std::vector<T> results;
+    std::atomic<size_t> remaining;
+    promise<std::vector<T>> result;
+  };
+  auto shared = std::make_shared<Shared>();
+  shared->results.resize(futures.size());
+  shared->remaining = futures.size();
+  auto out = shared->result.get_future();
+  if (futures.empty()) {
+    shared->result.set_value(std::vector<T>());
+    return out;
+  }
+  for (size_t i = 0; i < futures.size(); i++) {
+    futures[i].then([shared, i](T&& value) {
+      shared->results[i] = std::move(value);
+      if (shared->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        shared->result.set_value(std::move(shared->results));
+      }
+    });
+  }
+  return out;
+}
+
+// when_any_result is the result type of when_any().
+template <typename T>
+struct when_any_result {
+  // index of the first future to have a result.
+  size_t index = 0;
+  // value of the first future to have a result.
+  T value;
+};
+
+// when_any() returns a future that is assigned the result of the first of the
+// futures to have a result, along with its index. futures must not be empty.
+template <typename T>
+inline future<when_any_result<T>> when_any(std::vector<future<T>>&& futures) {
+  struct Shared {
+    std::atomic<bool> done{false};
+    promise<when_any_result<T>> result;
+  };
+  auto shared = std::make_shared<Shared>();
+  auto out = shared->result.get_future();
+  for (size_t i = 0; i < futures.size(); i++) {
+    futures[i].then([shared, i](T&& value) {
+      if (!shared->done.exchange(true, std::memory_order_acq_rel)) {
+        when_any_result<T> result;
+        result.index = i;
+        result.value = std::move(value);
+        shared->result.set_value(std::move(result));
+      }
+    });
+  }
+  return out;
 }
 
 }  // namespace dap
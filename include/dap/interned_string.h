@@ -0,0 +1,141 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_interned_string_h
+#define dap_interned_string_h
+
+#include "typeof.h"
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+
+namespace dap {
+
+// interned_string is an immutable string that is serialized as a string.
+// interned_strings deserialized by a Deserializer with a StringPool share a
+// single copy of each distinct value, which makes them suited to values
+// repeated across many messages, such as source paths and variable types.
+// interned_strings from the same pool with equal values compare equal with
+// a pointer comparison.
+// interned_string defaults to an empty string.
+class interned_string {
+ public:
+  inline interned_string() = default;
+  inline interned_string(const std::string& str);
+  inline interned_string(const char* str);
+  inline interned_string(const char* str, size_t size);
+
+  // str() returns the string value.
+  inline const std::string& str() const;
+  inline operator const std::string&() const;
+
+  inline bool empty() const;
+  inline size_t size() const;
+
+  inline bool operator==(const interned_string& other) const;
+  inline bool operator!=(const interned_string& other) const;
+
+ private:
+  friend class StringPool;
+  inline explicit interned_string(const std::shared_ptr<const std::string>&);
+
+  static const std::string& emptyString();
+
+  std::shared_ptr<const std::string> ptr;  // null for an empty string
+};
+
+// StringPool holds a single copy of each distinct string interned with it.
+// See Session::setStringPool().
+// StringPool is safe to use from multiple threads.
+class StringPool {
+ public:
+  virtual ~StringPool();
+
+  // intern() returns the interned_string with the value str, adding it to the
+  // pool if this is the first time the value has been seen.
+  virtual interned_string intern(const std::string& str) = 0;
+
+  // intern() returns the interned_string with the value of the size bytes at
+  // str. The default implementation copies the value to a std::string and
+  // calls intern(const std::string&).
+  virtual interned_string intern(const char* str, size_t size);
+
+  // size() returns the number of distinct strings held by the pool.
+  virtual size_t size() = 0;
+
+  // purge() removes the strings that are no longer referenced by any
+  // interned_string, and returns the number of strings removed.
+  virtual size_t purge() = 0;
+
+  // create() returns a new, empty StringPool.
+  static std::shared_ptr<StringPool> create();
+
+ protected:
+  // wrap() returns an interned_string sharing the given string.
+  static inline interned_string wrap(
+      const std::shared_ptr<const std::string>& str);
+};
+
+interned_string::interned_string(const std::string& str)
+    : ptr(str.empty() ? nullptr : std::make_shared<const std::string>(str)) {}
+
+interned_string::interned_string(const char* str)
+    : interned_string(std::string(str)) {}
+
+interned_string::interned_string(const char* str, size_t size)
+    : ptr(size == 0 ? nullptr
+                    : std::make_shared<const std::string>(str, size)) {}
+
+interned_string::interned_string(const std::shared_ptr<const std::string>& ptr)
+    : ptr(ptr) {}
+
+const std::string& interned_string::str() const {
+  return ptr ? *ptr : emptyString();
+}
+
+interned_string::operator const std::string&() const {
+  return str();
+}
+
+bool interned_string::empty() const {
+  return str().empty();
+}
+
+size_t interned_string::size() const {
+  return str().size();
+}
+
+bool interned_string::operator==(const interned_string& other) const {
+  return ptr == other.ptr || str() == other.str();
+}
+
+bool interned_string::operator!=(const interned_string& other) const {
+  return !(*this == other);
+}
+
+interned_string StringPool::wrap(
+    const std::shared_ptr<const std::string>& str) {
+  return interned_string(str);
+}
+
+template <>
+struct TypeOf<interned_string> {
+  static constexpr bool has_custom_serialization = true;
+  static const TypeInfo* type();
+};
+
+}  // namespace dap
+
+#endif  // dap_interned_string_h
@@ -16,13 +16,126 @@
 #define dap_optional_h
 
 #include <assert.h>
+#include <stddef.h>
+#include <memory>
 #include <type_traits>
 #include <utility>  // std::move, std::forward
 
 namespace dap {
 
+// internal functionality
+namespace detail {
+
+// kOptionalMaxInlineSize is the size of the largest type held inline by an
+// optional. Larger types, such as most protocol structs, are held in a heap
+// allocation so that an empty optional costs a single pointer.
+static constexpr size_t kOptionalMaxInlineSize = 64;
+
+// emptyValue() returns the default-constructed value returned by the const
+// accessors of an empty optional when assertions are disabled.
+template <typename T>
+inline const T& emptyValue() {
+  static const T value{};
+  return value;
+}
+
+// OptionalStorage holds the contained value of an optional.
+// Moving leaves the moved-from storage empty, for all sizes of T.
+// Accessing empty storage through the const get() returns emptyValue(), and
+// through the non-const get() first assigns the storage a default value, so
+// that accessing an empty optional is safe when assertions are disabled.
+template <typename T, bool INDIRECT = (sizeof(T) > kOptionalMaxInlineSize)>
+class OptionalStorage {
+ public:
+  inline OptionalStorage() = default;
+  inline OptionalStorage(const OptionalStorage&) = default;
+  inline OptionalStorage(OptionalStorage&& other) noexcept(
+      std::is_nothrow_move_constructible<T>::value)
+      : val(std::move(other.val)), set(other.set) {
+    other.set = false;
+  }
+  inline OptionalStorage& operator=(const OptionalStorage&) = default;
+  inline OptionalStorage& operator=(OptionalStorage&& other) noexcept(
+      std::is_nothrow_move_assignable<T>::value) {
+    val = std::move(other.val);
+    set = other.set;
+    other.set = false;
+    return *this;
+  }
+
+  inline bool has_value() const { return set; }
+  inline T* get() {
+    if (!set) {
+      val = T{};
+      set = true;
+    }
+    return &val;
+  }
+  inline const T* get() const { return set ? &val : &emptyValue<T>(); }
+  template <typename U>
+  inline void assign(U&& value) {
+    val = std::forward<U>(value);
+    set = true;
+  }
+  inline void reset() { set = false; }
+
+ private:
+  T val{};
+  bool set = false;
+};
+
+// OptionalStorage specialization for types larger than
+// kOptionalMaxInlineSize, which allocates the value when it is assigned.
+// Moving transfers the allocation, so moves never allocate or throw.
+template <typename T>
+class OptionalStorage<T, true> {
+ public:
+  inline OptionalStorage() = default;
+  inline OptionalStorage(const OptionalStorage& other)
+      : ptr(other.ptr ? new T(*other.ptr) : nullptr) {}
+  inline OptionalStorage(OptionalStorage&& other) noexcept = default;
+
+  inline OptionalStorage& operator=(const OptionalStorage& other) {
+    if (other.ptr) {
+      assign(*other.ptr);
+    } else {
+      reset();
+    }
+    return *this;
+  }
+  inline OptionalStorage& operator=(OptionalStorage&& other) noexcept =
+      default;
+
+  inline bool has_value() const { return ptr != nullptr; }
+  inline T* get() {
+    if (!ptr) {
+      ptr.reset(new T());
+    }
+    return ptr.get();
+  }
+  inline const T* get() const { return ptr ? ptr.get() : &emptyValue<T>(); }
+  template <typename U>
+  inline void assign(U&& value) {
+    if (ptr) {
+      *ptr = std::forward<U>(value);
+    } else {
+      ptr.reset(new T(std::forward<U>(value)));
+    }
+  }
+  inline void reset() { ptr.reset(); }
+
+ private:
+  std::unique_ptr<T> ptr;
+};
+
+}  // namespace detail
+
 // optional holds an 'optional' contained value.
 // This is similar to C++17's std::optional.
+// Values larger than detail::kOptionalMaxInlineSize are held in a heap
+// allocation, which is only made when the optional is assigned a value.
+// Unlike std::optional, a moved-from optional is left empty, so that moving an
+// optional of a large value never allocates.
 template <typename T>
 class optional {
   template <typename U>
@@ -35,7 +148,8 @@ class optional {
   // constructors
   inline optional() = default;
   inline optional(const optional& other);
-  inline optional(optional&& other);
+  inline optional(optional&& other) noexcept(
+      std::is_nothrow_move_constructible<detail::OptionalStorage<T>>::value);
   template <typename U>
   inline optional(const optional<U>& other);
   template <typename U>
@@ -44,7 +158,11 @@ class optional {
   inline optional(U&& value);
 
   // value() returns the contained value.
-  // If the optional does not contain a value, then value() will assert.
+  // If the optional does not contain a value, then value() will assert. When
+  // assertions are disabled, the const value() of an empty optional returns a
+  // default-constructed value, and the non-const value() first assigns the
+  // optional a default-constructed value. The same applies to operator*() and
+  // operator->().
   inline T& value();
   inline const T& value() const;
 
@@ -75,47 +193,49 @@ class optional {
   inline T& operator*();
 
  private:
-  T val{};
-  bool set = false;
+  detail::OptionalStorage<T> storage;
 };
 
 template <typename T>
-optional<T>::optional(const optional& other) : val(other.val), set(other.set) {}
+optional<T>::optional(const optional& other) : storage(other.storage) {}
 
 template <typename T>
-optional<T>::optional(optional&& other)
-    : val(std::move(other.val)), set(other.set) {}
+optional<T>::optional(optional&& other) noexcept(
+    std::is_nothrow_move_constructible<detail::OptionalStorage<T>>::value)
+    : storage(std::move(other.storage)) {}
 
 template <typename T>
 template <typename U>
-optional<T>::optional(const optional<U>& other) : set(other.has_value()) {
-  if (set) {
-    val = static_cast<T>(other.value());
+optional<T>::optional(const optional<U>& other) {
+  if (other.has_value()) {
+    storage.assign(static_cast<T>(other.value()));
   }
 }
 
 template <typename T>
 template <typename U>
-optional<T>::optional(optional<U>&& other) : set(other.has_value()) {
-  if (set) {
-    val = static_cast<T>(std::move(other.value()));
+optional<T>::optional(optional<U>&& other) {
+  if (other.has_value()) {
+    storage.assign(static_cast<T>(std::move(other.value())));
   }
 }
 
 template <typename T>
 template <typename U /*= T*/, typename>
-optional<T>::optional(U&& value) : val(std::forward<U>(value)), set(true) {}
+optional<T>::optional(U&& value) {
+  storage.assign(std::forward<U>(value));
+}
 
 template <typename T>
 T& optional<T>::value() {
-  assert(set);
-  return val;
+  assert(storage.has_value());
+  return *storage.get();
 }
 
 template <typename T>
 const T& optional<T>::value() const {
-  assert(set);
-  return val;
+  assert(storage.has_value());
+  return *storage.get();
 }
 
 template <typename T>
@@ -123,79 +243,82 @@ const T& optional<T>::value(const T& defaultValue) const {
   if (!has_value()) {
     return defaultValue;
   }
-  return val;
+  return *storage.get();
 }
 
 template <typename T>
 optional<T>::operator bool() const noexcept {
-  return set;
+  return storage.has_value();
 }
 
 template <typename T>
 bool optional<T>::has_value() const {
-  return set;
+  return storage.has_value();
 }
 
 template <typename T>
 optional<T>& optional<T>::operator=(const optional& other) {
-  val = other.val;
-  set = other.set;
+  storage = other.storage;
   return *this;
 }
 
 template <typename T>
 optional<T>& optional<T>::operator=(optional&& other) noexcept {
-  val = std::move(other.val);
-  set = other.set;
+  storage = std::move(other.storage);
   return *this;
 }
 
 template <typename T>
 template <typename U /* = T */, typename>
 optional<T>& optional<T>::operator=(U&& value) {
-  val = std::forward<U>(value);
-  set = true;
+  storage.assign(std::forward<U>(value));
   return *this;
 }
 
 template <typename T>
 template <typename U>
 optional<T>& optional<T>::operator=(const optional<U>& other) {
-  val = other.val;
-  set = other.set;
+  if (other.has_value()) {
+    storage.assign(other.value());
+  } else {
+    storage.reset();
+  }
   return *this;
 }
 
 template <typename T>
 template <typename U>
 optional<T>& optional<T>::operator=(optional<U>&& other) {
-  val = std::move(other.val);
-  set = other.set;
+  if (other.has_value()) {
+    storage.assign(std::move(other.value()));
+  } else {
+    storage.reset();
+  }
   return *this;
 }
 
 template <typename T>
 const T* optional<T>::operator->() const {
-  assert(set);
-  return &val;
+  assert(storage.has_value());
+  return storage.get();
 }
 
 template <typename T>
 T* optional<T>::operator->() {
-  assert(set);
-  return &val;
+  assert(storage.has_value());
+  return storage.get();
 }
 
 template <typename T>
 const T& optional<T>::operator*() const {
-  assert(set);
-  return val;
+  assert(storage.has_value());
+  return *storage.get();
 }
 
 template <typename T>
 T& optional<T>::operator*() {
-  assert(set);
-  return val;
+  assert(storage.has_value());
+  return *storage.get();
 }
 
 template <class T, class U>
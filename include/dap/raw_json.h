@@ -0,0 +1,83 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_raw_json_h
+#define dap_raw_json_h
+
+#include "typeof.h"
+
+#include <string>
+#include <utility>
+
+namespace dap {
+
+// raw_json holds a JSON value as its serialized text.
+// A raw_json is deserialized and serialized without decoding the value into
+// dap::object or dap::any trees, which makes it suited to values that are
+// forwarded without being inspected, such as launch configurations. The
+// value is only decoded when get() is called.
+// When serialized, the text is validated and then written to the output as is.
+// The JsonCpp backend instead parses the text and writes the parsed value.
+// When deserialized, the value is written out from the message's parse tree.
+// raw_json defaults to null.
+class raw_json {
+ public:
+  inline raw_json();
+  inline explicit raw_json(std::string json);
+
+  // create() returns a raw_json holding the serialized value v, or null if v
+  // could not be serialized.
+  template <typename T>
+  static inline raw_json create(const T& v);
+  static raw_json create(const TypeInfo* typeinfo, const void* value);
+
+  // str() returns the serialized JSON value.
+  inline const std::string& str() const;
+
+  // get() deserializes the JSON value into out, returning false if the value
+  // is not of the type T.
+  template <typename T>
+  inline bool get(T* out) const;
+  bool get(const TypeInfo* typeinfo, void* out) const;
+
+ private:
+  std::string json;
+};
+
+raw_json::raw_json() : json("null") {}
+
+raw_json::raw_json(std::string json) : json(std::move(json)) {}
+
+template <typename T>
+raw_json raw_json::create(const T& v) {
+  return create(TypeOf<T>::type(), &v);
+}
+
+const std::string& raw_json::str() const {
+  return json;
+}
+
+template <typename T>
+bool raw_json::get(T* out) const {
+  return get(TypeOf<T>::type(), out);
+}
+
+template <>
+struct TypeOf<raw_json> {
+  static const TypeInfo* type();
+};
+
+}  // namespace dap
+
+#endif  // dap_raw_json_h
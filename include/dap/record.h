@@ -0,0 +1,137 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_record_h
+#define dap_record_h
+
+#include "session.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dap {
+
+// Forward declarations
+class Reader;
+class ReaderWriter;
+class Writer;
+
+// record() returns a ReaderWriter that wraps rw, and writes a capture of every
+// complete message read from, or written to, rw to capture.
+// Unlike spy(), the capture is a binary format that holds each message's
+// content, direction and timestamp, and which can be loaded with
+// Recording::load() and replayed with replay().
+//
+// The capture starts with the 8 byte magic "DAPREC01", followed by a record
+// for each message:
+//   uint8_t  direction  - Recording::Direction of the message.
+//   uint64_t time       - nanoseconds since record() was called.
+//   uint32_t length     - length of the message content in bytes.
+//   uint8_t  content[length]
+// All integers are little-endian.
+std::shared_ptr<ReaderWriter> record(const std::shared_ptr<ReaderWriter>& rw,
+                                     const std::shared_ptr<Writer>& capture);
+
+// Recording is an indexed, in-memory capture written by record().
+class Recording {
+ public:
+  // Direction is the direction of a recorded message, relative to the side
+  // of the connection that was recorded.
+  enum Direction {
+    kReceived = 0,  // The message was read from the wrapped ReaderWriter.
+    kSent = 1,      // The message was written to the wrapped ReaderWriter.
+  };
+
+  // Message is a single recorded message.
+  struct Message {
+    Direction direction = kReceived;
+    // The time the message was recorded, relative to the start of recording.
+    std::chrono::nanoseconds time = std::chrono::nanoseconds(0);
+    // The message content, without the Content-Length header.
+    std::string content;
+  };
+
+  virtual ~Recording();
+
+  // count() returns the number of recorded messages.
+  virtual size_t count() const = 0;
+
+  // get() returns the i'th recorded message.
+  virtual Message get(size_t i) const = 0;
+
+  // load() reads the capture from r until r is closed or exhausted, and
+  // returns the indexed Recording. A truncated final record is ignored.
+  // Returns nullptr if r does not start with a capture written by record().
+  static std::unique_ptr<Recording> load(const std::shared_ptr<Reader>& r);
+};
+
+// ReplayOptions holds the options for replay().
+struct ReplayOptions {
+  // The playback speed as a multiple of the recorded speed. 1 replays in
+  // real time, 10 replays 10 times faster, and 0 replays as fast as possible.
+  double speed = 1;
+  // The recorded direction of the messages that are sent to the adapter.
+  // This is kSent if the client side was recorded, or kReceived if the
+  // adapter side was recorded.
+  Recording::Direction send = Recording::kSent;
+  // The maximum time to wait for a response to a request.
+  std::chrono::milliseconds timeout = std::chrono::milliseconds(5000);
+};
+
+// ReplayResult holds the outcome of replay().
+struct ReplayResult {
+  // The number of requests sent to the adapter.
+  uint64_t requests = 0;
+  // The number of responses received from the adapter.
+  uint64_t responses = 0;
+  // The number of responses that did not match the recorded response's
+  // command and success fields.
+  uint64_t mismatched = 0;
+  // The number of recorded responses that the adapter did not send.
+  uint64_t missing = 0;
+  // A description of each mismatched or missing response.
+  std::vector<std::string> errors;
+  // The time taken to replay the recording.
+  std::chrono::microseconds duration = std::chrono::microseconds(0);
+  // The request to response round-trip times.
+  DurationHistogram latency;
+};
+
+// replay() replays the client side of the recording to the adapter connected
+// to rw, and checks the adapter's responses against the recorded responses.
+// Messages are sent with the recorded timing, scaled by options.speed. A
+// message is not sent until the adapter has responded to each request that
+// had been responded to before the message was recorded, or until
+// options.timeout has elapsed.
+// The sent messages are renumbered from 1, and each response from the adapter
+// is matched to the recorded response by the request it answers. A recorded
+// response to a request from the adapter, such as runInTerminal, is sent in
+// answer to the adapter's request with the same command and position among
+// the requests with that command, once that request has arrived.
+// Only the command and success fields of the responses to the replayed
+// requests are compared, as other fields, such as variable references, are
+// expected to differ between runs. Events and requests from the adapter are
+// not checked.
+// replay() closes rw before returning.
+ReplayResult replay(const Recording& recording,
+                    const std::shared_ptr<ReaderWriter>& rw,
+                    const ReplayOptions& options = {});
+
+}  // namespace dap
+
+#endif  // dap_record_h
@@ -0,0 +1,116 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_request_view_h
+#define dap_request_view_h
+
+#include "typeof.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace dap {
+
+// RequestArguments is the interface to the arguments of a received request,
+// which are deserialized on demand. See RequestView.
+class RequestArguments {
+ public:
+  virtual ~RequestArguments();
+
+  // field() calls cb to deserialize the argument with the given name.
+  virtual bool field(const std::string& name,
+                     const std::function<bool(Deserializer*)>& cb) const = 0;
+
+  // deserialize() deserializes all the arguments into the request object out,
+  // of the type 'typeinfo'.
+  virtual bool deserialize(const TypeInfo* typeinfo, void* out) const = 0;
+};
+
+// RequestView is passed to a request handler in place of the request of type
+// T, and deserializes the request arguments as they are accessed. This avoids
+// deserializing large arguments that the handler does not use. Handlers that
+// take a RequestView are registered with Session::registerHandler(), in the
+// same way as handlers that take the request.
+// A RequestView must not be used once the handler has returned, and must not
+// be used by multiple threads at the same time.
+template <typename T>
+class RequestView {
+ public:
+  using Request = T;
+
+  inline explicit RequestView(const RequestArguments* arguments);
+
+  // field() deserializes the request argument with the given serialized name
+  // into out, returning false if the argument could not be deserialized.
+  // Each call deserializes the argument again.
+  template <typename F>
+  inline bool field(const std::string& name, F* out) const;
+
+  // get() returns the request with all of its arguments deserialized. The
+  // request is deserialized by the first call, and reused by later calls.
+  // If the request could not be deserialized, get() returns a
+  // default-initialized request and valid() returns false.
+  inline const T& get() const;
+
+  // valid() returns false if get() failed to deserialize the request. If the
+  // handler returns once get() has failed, the session responds with an error
+  // in place of the handler's response.
+  inline bool valid() const;
+
+ private:
+  const RequestArguments* const arguments;
+  mutable std::unique_ptr<T> request;  // null until get() is called
+  mutable bool failed = false;         // true if get() failed
+};
+
+template <typename T>
+RequestView<T>::RequestView(const RequestArguments* arguments)
+    : arguments(arguments) {}
+
+template <typename T>
+template <typename F>
+bool RequestView<T>::field(const std::string& name, F* out) const {
+  return arguments->field(name, [&](Deserializer* d) {
+    return TypeOf<F>::type()->deserialize(d, out);
+  });
+}
+
+template <typename T>
+const T& RequestView<T>::get() const {
+  if (!request) {
+    request.reset(new T());
+    if (!arguments->deserialize(TypeOf<T>::type(), request.get())) {
+      failed = true;
+      *request = T();
+    }
+  }
+  return *request;
+}
+
+template <typename T>
+bool RequestView<T>::valid() const {
+  return !failed;
+}
+
+// IsRequestView is true if T is a RequestView.
+template <typename T>
+struct IsRequestView : std::false_type {};
+
+template <typename T>
+struct IsRequestView<RequestView<T>> : std::true_type {};
+
+}  // namespace dap
+
+#endif  // dap_request_view_h
@@ -23,6 +23,11 @@
 
 namespace dap {
 
+class StringPool;
+class bytes;
+class interned_string;
+class raw_json;
+
 // Field describes a single field of a struct.
 struct Field {
   std::string name;      // name of the field
@@ -38,8 +43,29 @@ struct Field {
 // Methods that return a bool use this to indicate success.
 class Deserializer {
  public:
+  // Kind is the kind of a stored value.
+  enum Kind {
+    kUndefined,  // no value, such as a missing struct field
+    kNull,
+    kBoolean,
+    kInteger,
+    kNumber,
+    kString,
+    kArray,
+    kObject,
+    kUnknown,  // the Deserializer does not report kinds
+  };
+
   virtual ~Deserializer() = default;
 
+  // kind() returns the kind of the value referenced by this Deserializer.
+  // The default implementation returns kUnknown.
+  virtual Kind kind() const { return kUnknown; }
+
+  // stringPool() returns the StringPool used to intern deserialized
+  // interned_strings, or nullptr if they are not pooled.
+  virtual StringPool* stringPool() const { return nullptr; }
+
   // deserialization methods for simple data types.
   // If the stored object is not of the correct type, then these function will
   // return false.
@@ -50,6 +76,20 @@ class Deserializer {
   virtual bool deserialize(object*) const = 0;
   virtual bool deserialize(any*) const = 0;
 
+  // deserialize() copies the stored value's JSON text. The default
+  // implementation returns false, for Deserializers that are not backed by
+  // JSON.
+  virtual bool deserialize(raw_json*) const;
+
+  // deserialize() decodes a base64 string. The default implementation
+  // returns false.
+  virtual bool deserialize(bytes*) const;
+
+  // deserialize() decodes a string, interning it with stringPool() if not
+  // null. The default implementation decodes the string to a dap::string
+  // first. Implementations may intern the stored string without the copy.
+  virtual bool deserialize(interned_string*) const;
+
   // count() returns the number of elements in the array object referenced by
   // this Deserializer.
   virtual size_t count() const = 0;
@@ -77,13 +117,105 @@ class Deserializer {
   inline bool deserialize(dap::optional<T>*) const;
 
   // deserialize() decodes an variant.
+  // The variant is assigned the first alternative type that matches the kind()
+  // of the stored value. If no type matches exactly, such as an integer stored
+  // to a variant of number, then the first type that can hold the value is
+  // used, which for an any alternative is every value.
+  // If kind() returns kUnknown, then the variant is assigned the first
+  // alternative type, other than null, that the value decodes as.
+  // The variant is left unchanged if the value decodes as none of the types.
   template <typename T0, typename... Types>
   inline bool deserialize(dap::variant<T0, Types...>*) const;
 
   // deserialize() decodes the struct field f with the given name.
   template <typename T>
   inline bool field(const std::string& name, T* f) const;
+
+ private:
+  template <typename... Types>
+  struct TypeList {};
+
+  // deserializeAlternative() decodes the value into v as the type T, if T
+  // matches the value's kind. exact selects whether T must exactly match, or
+  // only be able to hold the value.
+  template <typename T>
+  inline bool deserializeAlternative(Kind kind, bool exact, any* v) const;
+
+  inline bool deserializeAlternatives(Kind, bool, any*, TypeList<>) const;
+
+  template <typename T, typename... Types>
+  inline bool deserializeAlternatives(Kind kind,
+                                      bool exact,
+                                      any* v,
+                                      TypeList<T, Types...>) const;
+};
+
+namespace detail {
+
+// HasCustomSerialization is true if TypeOf<T> declares
+// has_custom_serialization, as DAP_DECLARE_STRUCT_TYPEINFO() does.
+template <typename T>
+struct HasCustomSerialization {
+  template <typename U>
+  static std::true_type test(decltype(TypeOf<U>::has_custom_serialization)*);
+  template <typename U>
+  static std::false_type test(...);
+  static constexpr bool value = decltype(test<T>(nullptr))::value;
+};
+
+// KindsOf holds the bitmasks of the Deserializer::Kinds that the type T
+// exactly matches, and that it can hold. Types that are not listed, such as
+// any, can hold values of every kind.
+template <typename T, typename Enable = void>
+struct KindsOf {
+  static constexpr int exact = 0;
+  static constexpr int accepted = ~0;
+};
+
+template <int... KINDS>
+struct KindMask {
+  static constexpr int value = 0;
+};
+
+template <int KIND, int... KINDS>
+struct KindMask<KIND, KINDS...> {
+  static constexpr int value = (1 << KIND) | KindMask<KINDS...>::value;
+};
+
+template <int... KINDS>
+struct ExactKinds {
+  static constexpr int exact = KindMask<KINDS...>::value;
+  static constexpr int accepted = exact;
+};
+
+template <>
+struct KindsOf<null> : ExactKinds<Deserializer::kNull> {};
+template <>
+struct KindsOf<boolean> : ExactKinds<Deserializer::kBoolean> {};
+template <>
+struct KindsOf<integer> : ExactKinds<Deserializer::kInteger> {};
+template <>
+struct KindsOf<number> {
+  static constexpr int exact = KindMask<Deserializer::kNumber>::value;
+  static constexpr int accepted =
+      KindMask<Deserializer::kNumber, Deserializer::kInteger>::value;
 };
+template <>
+struct KindsOf<string> : ExactKinds<Deserializer::kString> {};
+template <>
+struct KindsOf<interned_string> : ExactKinds<Deserializer::kString> {};
+template <>
+struct KindsOf<bytes> : ExactKinds<Deserializer::kString> {};
+template <>
+struct KindsOf<object> : ExactKinds<Deserializer::kObject> {};
+template <typename T>
+struct KindsOf<array<T>> : ExactKinds<Deserializer::kArray> {};
+template <typename T>
+struct KindsOf<T,
+               typename std::enable_if<HasCustomSerialization<T>::value>::type>
+    : ExactKinds<Deserializer::kObject> {};
+
+}  // namespace detail
 
 template <typename T, typename>
 bool Deserializer::deserialize(T* ptr) const {
@@ -112,7 +244,60 @@ bool Deserializer::deserialize(dap::optional<T>* opt) const {
 
 template <typename T0, typename... Types>
 bool Deserializer::deserialize(dap::variant<T0, Types...>* var) const {
-  return deserialize(&var->value);
+  auto k = kind();
+  using Alternatives = TypeList<T0, Types...>;
+  if (k == kUnknown) {
+    return deserializeAlternatives(k, false, &var->value, Alternatives());
+  }
+  return deserializeAlternatives(k, true, &var->value, Alternatives()) ||
+         deserializeAlternatives(k, false, &var->value, Alternatives());
+}
+
+template <typename T>
+bool Deserializer::deserializeAlternative(Kind kind,
+                                          bool exact,
+                                          any* v) const {
+  auto kinds =
+      exact ? detail::KindsOf<T>::exact : detail::KindsOf<T>::accepted;
+  if (kind == kUnknown) {
+    if (std::is_same<T, null>::value) {
+      return false;  // a null value cannot be told apart by decoding it
+    }
+  } else if ((kinds & (1 << kind)) == 0) {
+    return false;
+  }
+  if (std::is_same<T, null>::value) {
+    v->reset();  // any holds null as no value
+    return true;
+  }
+  // The value is decoded into a temporary, so that a value that only partly
+  // decodes as T does not replace the variant's value.
+  auto type = TypeOf<T>::type();
+  any decoded;
+  decoded.type = type;
+  decoded.alloc(type->size(), type->alignment());
+  type->construct(decoded.value);
+  if (!type->deserialize(this, decoded.value)) {
+    return false;
+  }
+  *v = std::move(decoded);
+  return true;
+}
+
+bool Deserializer::deserializeAlternatives(Kind,
+                                           bool,
+                                           any*,
+                                           TypeList<>) const {
+  return false;
+}
+
+template <typename T, typename... Types>
+bool Deserializer::deserializeAlternatives(Kind kind,
+                                           bool exact,
+                                           any* v,
+                                           TypeList<T, Types...>) const {
+  return deserializeAlternative<T>(kind, exact, v) ||
+         deserializeAlternatives(kind, exact, v, TypeList<Types...>());
 }
 
 template <typename T>
@@ -144,6 +329,15 @@ class Serializer {
   virtual bool serialize(const dap::object&) = 0;
   virtual bool serialize(const any&) = 0;
 
+  // serialize() encodes the JSON text held by the raw_json. The default
+  // implementation returns false, for Serializers that are not backed by
+  // JSON.
+  virtual bool serialize(const raw_json&);
+
+  // serialize() encodes the bytes as a base64 string. The default
+  // implementation returns false.
+  virtual bool serialize(const bytes&);
+
   // array() encodes count array elements to the array object referenced by this
   // Serializer. The std::function will be called count times, each time with a
   // Serializer that should be used to encode the n'th array element's data.
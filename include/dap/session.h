@@ -15,13 +15,20 @@
 #ifndef dap_session_h
 #define dap_session_h
 
+#include "executor.h"
 #include "future.h"
 #include "io.h"
+#include "request_view.h"
 #include "traits.h"
 #include "typeinfo.h"
 #include "typeof.h"
 
+#include <array>
+#include <chrono>
 #include <functional>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace dap {
 
@@ -29,6 +36,8 @@ namespace dap {
 struct Request;
 struct Response;
 struct Event;
+class StringPool;
+class Tracer;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Error
@@ -99,6 +108,153 @@ ResponseOrError<T>& ResponseOrError<T>::operator=(ResponseOrError&& other) {
   return *this;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// SerializedEvent
+////////////////////////////////////////////////////////////////////////////////
+
+// SerializedEvent is an event that is serialized once, and can then be sent to
+// any number of sessions with Session::send(). Only the message sequence
+// number, which differs for each session, is written per send.
+// SerializedEvents are immutable, and are cheap to copy.
+class SerializedEvent {
+ public:
+  SerializedEvent() = default;
+
+  // create() returns the serialized event.
+  template <typename T, typename = traits::EnableIfIsType<dap::Event, T>>
+  static inline SerializedEvent create(const T& event);
+
+  // create() returns the serialized event of the type 'typeinfo'.
+  // Returns an empty SerializedEvent if the event could not be serialized.
+  static SerializedEvent create(const TypeInfo* typeinfo, const void* event);
+
+  // operator bool() returns true if the event was serialized.
+  inline operator bool() const { return data != nullptr; }
+
+  // typeinfo() returns the type of the event.
+  const TypeInfo* typeinfo() const;
+
+  // event() returns a copy of the event that was serialized.
+  std::shared_ptr<const void> event() const;
+
+  // message() returns the event message with the given sequence number.
+  std::string message(integer seq) const;
+
+ private:
+  struct Data;
+  std::shared_ptr<const Data> data;
+};
+
+template <typename T, typename>
+SerializedEvent SerializedEvent::create(const T& event) {
+  return create(TypeOf<T>::type(), &event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// PendingRequestStats
+////////////////////////////////////////////////////////////////////////////////
+
+// PendingRequestStats holds metrics about the requests sent by a Session that
+// are awaiting a response.
+struct PendingRequestStats {
+  // The number of requests currently awaiting a response.
+  size_t pending = 0;
+  // The highest number of requests that have been awaiting a response at the
+  // same time.
+  size_t peak = 0;
+  // The total number of requests that did not receive a response before their
+  // timeout.
+  uint64_t timedOut = 0;
+  // The total number of send() calls that had to wait for a pending request
+  // to complete due to the limit set by setMaxPendingRequests().
+  uint64_t blocked = 0;
+  // The total number of send() calls that failed as the limit set by
+  // setMaxPendingRequests() was reached.
+  uint64_t rejected = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// SessionStats
+////////////////////////////////////////////////////////////////////////////////
+
+// DurationHistogram is a histogram of durations, with buckets that double in
+// width.
+struct DurationHistogram {
+  static const int kNumBuckets = 28;
+
+  // percentile() returns an upper bound of the duration below which the
+  // fraction p, in the range [0, 1], of the recorded durations fall.
+  // Returns zero if no durations have been recorded.
+  inline std::chrono::microseconds percentile(double p) const;
+
+  // buckets[0] counts the durations of less than 1 microsecond.
+  // buckets[i] counts the durations of at least 2^(i-1) microseconds and less
+  // than 2^i microseconds. The last bucket also counts all longer durations.
+  std::array<uint64_t, kNumBuckets> buckets = {};
+  // The number of recorded durations.
+  uint64_t count = 0;
+  // The sum of the recorded durations.
+  std::chrono::microseconds total = std::chrono::microseconds(0);
+};
+
+std::chrono::microseconds DurationHistogram::percentile(double p) const {
+  if (count == 0) {
+    return std::chrono::microseconds(0);
+  }
+  auto target = static_cast<uint64_t>(p * static_cast<double>(count));
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; i++) {
+    seen += buckets[i];
+    if (seen > target || seen == count) {
+      return std::chrono::microseconds(uint64_t(1) << i);
+    }
+  }
+  return std::chrono::microseconds(uint64_t(1) << (kNumBuckets - 1));
+}
+
+// MessageStats holds the number of messages and bytes of a single message
+// type received and sent by a Session.
+struct MessageStats {
+  uint64_t received = 0;
+  uint64_t bytesReceived = 0;
+  uint64_t sent = 0;
+  uint64_t bytesSent = 0;
+};
+
+// SessionStats holds metrics about a Session, as returned by Session::stats().
+// All counts are totals since the Session was created. Message types that
+// have not been received or sent are omitted from the maps.
+struct SessionStats {
+  // Requests, keyed by command.
+  std::map<std::string, MessageStats> requests;
+  // Responses, keyed by the command of the request.
+  std::map<std::string, MessageStats> responses;
+  // Events, keyed by event name.
+  std::map<std::string, MessageStats> events;
+  // The time taken to parse each received message.
+  DurationHistogram parseTime;
+  // The time taken to serialize each sent message.
+  DurationHistogram serializeTime;
+  // The time taken by each call to a request handler, keyed by command.
+  // For handlers that respond before returning, this includes the time taken
+  // to send the response.
+  std::map<std::string, DurationHistogram> handlerTime;
+  // The number of received messages waiting to be dispatched.
+  size_t inboxDepth = 0;
+  // The number of messages waiting in the outbox. See setEventConflation().
+  size_t outboxDepth = 0;
+  // The number of messages that could not be queued in the outbox, as it was
+  // full. See setOutboxLimit().
+  uint64_t outboxRejected = 0;
+  // The number of messages taken from the outbox that failed to write.
+  uint64_t outboxWriteFailures = 0;
+  // The requests sent by the Session that are awaiting a response.
+  PendingRequestStats pendingRequests;
+  // The number of errors reported to the ErrorHandler, keyed by the kind of
+  // error, which is the error message without its arguments.
+  std::map<std::string, uint64_t> errors;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Session
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +267,41 @@ enum OnInvalidData {
   kClose,
 };
 
+// An enum flag that controls how the Session dispatches a request that arrives
+// while earlier requests with the same command are still pending.
+enum RequestPolicy {
+  // Dispatch every request to the handler. This is the default.
+  kDispatchAll,
+  // A request with identical arguments to a request that is still in flight
+  // is coalesced with the in-flight request. The handler is called once, and
+  // the response is sent to every caller. The arguments are compared by their
+  // serialization as the handler's request type, so requests that differ only
+  // in field order, or in fields the type does not have, are coalesced. For
+  // handlers that take a RequestView, this deserializes the arguments.
+  // Requests whose arguments fail to deserialize are not coalesced.
+  kCoalesce,
+  // A newer request supersedes older requests with the same command that have
+  // not yet been dispatched to the handler. Superseded requests are answered
+  // with a 'cancelled' error response.
+  kLatestWins,
+};
+
+// An enum flag that controls which thread the Session calls a request handler
+// on.
+enum DispatchMode {
+  // The handler is called on the Session's dispatch thread. This is the
+  // default.
+  kQueued,
+  // The handler is called directly on the thread that received the request,
+  // saving a thread hop, as long as no earlier messages are still waiting to
+  // be dispatched. Otherwise the request is queued behind them, preserving
+  // message order. Inline handlers must be quick, and must not block.
+  // This only affects sessions that dispatch on their own thread. It has no
+  // effect for sessions created with an executor, or driven with getPayload()
+  // or feed().
+  kInline,
+};
+
 // Session implements a DAP client or server endpoint.
 // The general usage is as follows:
 // (1) Create a session with Session::create().
@@ -128,6 +319,9 @@ class Session {
   template <typename T>
   using IsEvent = traits::EnableIfIsType<dap::Event, T>;
 
+  template <typename T>
+  using IsRequestViewHandler = traits::EnableIf<IsRequestView<T>::value>;
+
   template <typename F>
   using IsRequestHandlerWithoutCallback = traits::EnableIf<
       traits::CompatibleWith<F, std::function<void(dap::Request)>>::value>;
@@ -149,18 +343,154 @@ class Session {
   // connected endpoint has closed.
   using ClosedHandler = std::function<void()>;
 
+  // StatsHandler is the type of callback function used to periodically report
+  // the Session's stats.
+  using StatsHandler = std::function<void(const SessionStats&)>;
+
+  // Options holds the optional configuration used to construct a Session.
+  struct Options {
+    // executor, if not null, is used to parse and dispatch the incoming
+    // messages, instead of a dedicated dispatch thread for each session.
+    // Messages for a single session are still processed one at a time, in the
+    // order they are received, but many sessions can share the executor's
+    // threads. startProcessingMessages() still uses a dedicated thread to
+    // read from each session's Reader. Sessions driven by feed() need no
+    // thread of their own.
+    // As responses are also processed on the executor, request and event
+    // handlers must not block waiting for the response to a request sent to
+    // the same session. Use future::then() instead.
+    std::shared_ptr<Executor> executor;
+  };
+
   // create() constructs and returns a new Session.
   static std::unique_ptr<Session> create();
 
+  // create() constructs and returns a new Session with the given options.
+  static std::unique_ptr<Session> create(const Options& options);
+
   // Sets how the Session handles invalid data.
   virtual void setOnInvalidData(OnInvalidData) = 0;
 
+  // setRequestPolicy() sets how requests of the type RequestType are
+  // dispatched when earlier requests of the same type are still pending.
+  // The default policy for all request types is kDispatchAll.
+  template <typename RequestType, typename = IsRequest<RequestType>>
+  inline void setRequestPolicy(RequestPolicy policy);
+
+  // setDispatchMode() sets which thread the handler for requests of the type
+  // RequestType is called on.
+  // The default mode for all request types is kQueued.
+  template <typename RequestType, typename = IsRequest<RequestType>>
+  inline void setDispatchMode(DispatchMode mode);
+
+  // setRequestTimeout() sets the default duration that a request sent with
+  // send() waits for a response. If no response is received in time, the
+  // request's future is assigned a 'Request timed out' error. A timeout that
+  // expires while the request is still being written is reported once the
+  // write completes, or not at all if the write fails, as send() then reports
+  // the failure.
+  // A timeout of zero, the default, waits forever.
+  virtual void setRequestTimeout(std::chrono::milliseconds timeout) = 0;
+
+  // setMaxPendingRequests() limits the number of requests sent with send()
+  // that can be awaiting a response. Once the limit is reached, send() fails,
+  // and the request's future is assigned a 'Failed to send request' error.
+  // If maxWait is positive, send() instead first waits for up to maxWait for a
+  // pending request to receive a response or time out. send() never waits on
+  // the thread that processes the session's responses, such as in a response
+  // callback or an inline request handler, as blocking that thread would stop
+  // the responses that free a slot.
+  // A limit of zero, the default, allows any number of pending requests.
+  virtual void setMaxPendingRequests(
+      size_t max,
+      std::chrono::milliseconds maxWait = std::chrono::milliseconds(0)) = 0;
+
+  // pendingRequestStats() returns metrics about the requests sent by this
+  // Session that are awaiting a response.
+  virtual PendingRequestStats pendingRequestStats() = 0;
+
+  // stats() returns a snapshot of the metrics collected by this Session.
+  // Metrics are always collected, using relaxed atomic counters.
+  virtual SessionStats stats() = 0;
+
+  // onStats() registers a callback that is called with a snapshot of stats()
+  // once every interval. The callback is called on a Session-internal thread,
+  // and must not block.
+  // An interval of zero, or an empty callback, stops the periodic callback.
+  virtual void onStats(std::chrono::milliseconds interval,
+                       const StatsHandler& callback) = 0;
+
+  // setTracer() sets the Tracer used to record the time spent in each stage
+  // of the lifecycle of the messages received and sent by this Session.
+  // See dap/tracer.h. A null tracer, the default, disables tracing.
+  virtual void setTracer(const std::shared_ptr<Tracer>& tracer) = 0;
+
+  // setStringPool() sets the StringPool used to intern the interned_string
+  // fields of received messages. A pool may be shared by multiple Sessions.
+  // See dap/interned_string.h. A null pool, the default, disables interning.
+  virtual void setStringPool(const std::shared_ptr<StringPool>& pool) = 0;
+
+  // setOutputAggregation() enables merging of consecutive OutputEvents sent
+  // with send(), to reduce the number of messages sent when the debuggee
+  // writes its output in many small pieces.
+  // Consecutive OutputEvents with the same category and source are merged into
+  // a single event. The merged event is sent once window has elapsed since the
+  // first merged event, once its output reaches maxBytes, or before any other
+  // message is sent by the Session, so message order is preserved.
+  // OutputEvents with a group, line, column, data or variablesReference are
+  // never merged.
+  // Output whose window has elapsed is sent by a thread that is started the
+  // first time aggregation is enabled.
+  // A window of zero, the default, disables aggregation.
+  virtual void setOutputAggregation(std::chrono::milliseconds window,
+                                    size_t maxBytes = 65536) = 0;
+
+  // setEventConflation() enables conflation of events of the type EventType,
+  // for events where only the latest state for a given key matters.
+  // The function F returns the conflation key of an event, and must have the
+  // following signature:
+  //   std::string(const EventType&)
+  // Once conflation is enabled for any event type, messages sent by the
+  // Session are queued in an outbox, which is written in order by a thread
+  // owned by the Session. An event of the type EventType that is sent while an
+  // event with the same key is still waiting in the outbox replaces the
+  // waiting event in place. A slow endpoint then receives only the latest
+  // event for each key.
+  // While the outbox is in use, the methods that send a message return once
+  // the message has been queued. Failures to write it are reported to the
+  // error handler, and counted in SessionStats::outboxWriteFailures. The
+  // number of messages waiting in the outbox is limited, see setOutboxLimit().
+  // A null F disables conflation for EventType. The outbox is no longer used
+  // once conflation is disabled for all event types and the outbox is empty.
+  template <typename EventType,
+            typename F,
+            typename = IsEvent<EventType>>
+  inline void setEventConflation(F&& key);
+
+  // setOutboxLimit() sets the number of messages, not counting conflated
+  // events, that can wait in the outbox, and how long sending a message waits
+  // for room once the outbox is full. A message that still does not fit once
+  // maxWait has elapsed is not sent: the method that sent it returns false,
+  // the failure is reported to the error handler, and it is counted in
+  // SessionStats::outboxRejected.
+  // The defaults are 1024 messages and 1 second. See setEventConflation().
+  virtual void setOutboxLimit(size_t maxMessages,
+                              std::chrono::milliseconds maxWait) = 0;
+
   // onError() registers a error handler that will be called whenever a protocol
   // error is encountered.
   // Only one error handler can be bound at any given time, and later calls
   // will replace the existing error handler.
   virtual void onError(const ErrorHandler&) = 0;
 
+  // freezeHandlers() takes an immutable snapshot of the request, event and
+  // response sent handlers registered so far, after which looking up the
+  // handler for each incoming message no longer takes a lock.
+  // Handlers can still be registered after calling freezeHandlers(), but each
+  // registration rebuilds the snapshot, so freezeHandlers() is best called
+  // once all the handlers have been registered, before bind().
+  virtual void freezeHandlers() = 0;
+
   // registerHandler() registers a request handler for a specific request type.
   // The function F must have one of the following signatures:
   //   ResponseOrError<ResponseType>(const RequestType&)
@@ -195,6 +525,16 @@ class Session {
   inline IsRequestHandlerWithCallback<F, ResponseOrError<ResponseType>>
   registerHandler(F&& handler);
 
+  // registerHandler() registers a request handler for a specific request type,
+  // which is passed a RequestView instead of the deserialized request. The
+  // request arguments are only deserialized as the handler accesses them.
+  // The function F must have one of the following signatures:
+  //   ResponseOrError<ResponseType>(const RequestView<RequestType>&)
+  //   ResponseType(const RequestView<RequestType>&)
+  //   Error(const RequestView<RequestType>&)
+  template <typename F, typename ViewType = ParamType<F, 0>>
+  inline IsRequestViewHandler<ViewType> registerHandler(F&& handler);
+
   // registerHandler() registers a event handler for a specific event type.
   // The function F must have the following signature:
   //   void(const EventType&)
@@ -214,10 +554,38 @@ class Session {
   template <typename T, typename = IsRequest<T>>
   future<ResponseOrError<typename T::Response>> send(const T& request);
 
+  // send() sends the request to the connected endpoint and returns a
+  // future that is assigned the request response or error.
+  // timeout overrides the default timeout set with setRequestTimeout(). A
+  // timeout of zero waits forever, and a negative timeout uses the default.
+  template <typename T, typename = IsRequest<T>>
+  future<ResponseOrError<typename T::Response>> send(
+      const T& request,
+      std::chrono::milliseconds timeout);
+
   // send() sends the event to the connected endpoint.
   template <typename T, typename = IsEvent<T>>
   void send(const T& event);
 
+  // send() sends the serialized event to the connected endpoint. Serialized
+  // events are not aggregated with setOutputAggregation() or conflated with
+  // setEventConflation().
+  virtual bool send(const SerializedEvent& event) = 0;
+
+  // sendOutput() sends an OutputEvent with the given category, and the size
+  // bytes at data as its output. The event message is written directly from
+  // data, without constructing an OutputEvent, making this the cheapest way to
+  // forward the output of the debuggee. A null category omits the field.
+  // Invalid UTF-8 sequences in data are replaced with U+FFFD.
+  // While setOutputAggregation() is enabled, the output is merged with the
+  // pending output like any other OutputEvent, and invalid UTF-8 is only
+  // replaced once the merged output is sent, so that a character split between
+  // two calls is kept. If setEventConflation() sets a key for OutputEvents,
+  // an OutputEvent is constructed to compute the key.
+  virtual bool sendOutput(const void* data,
+                          size_t size,
+                          const char* category = nullptr) = 0;
+
   // bind() connects this Session to an endpoint using connect(), and then
   // starts processing incoming messages with startProcessingMessages().
   // onClose is the optional callback which will be called when the session
@@ -228,6 +596,24 @@ class Session {
   inline void bind(const std::shared_ptr<ReaderWriter>& readerWriter,
                    const ClosedHandler& onClose);
 
+  // pairInProcess() connects the two sessions, which must both have been
+  // created with Session::create(), and starts processing their incoming
+  // messages, as if bind() was called on each with the two ends of a pipe.
+  // Messages are passed between the sessions as copies of the request,
+  // response and event objects, and are never serialized. Handlers, futures
+  // and request policies behave as they do for bound sessions.
+  // If the two sessions register different types for the same request or
+  // event, the message is converted between the types through JSON.
+  // Destructing either session closes the connection, after which onCloseA
+  // and onCloseB, if set, are called on the receiving threads of a and b, as
+  // they would be for bind(). If either session was not created with
+  // Session::create(), the sessions are not connected and an error is reported
+  // to the other session's error handler.
+  static void pairInProcess(Session* a,
+                            Session* b,
+                            const ClosedHandler& onCloseA = {},
+                            const ClosedHandler& onCloseB = {});
+
   //////////////////////////////////////////////////////////////////////////////
   // Note:
   // Methods and members below this point are for advanced usage, and are more
@@ -260,6 +646,23 @@ class Session {
   //       Most users will use bind() instead of calling this method directly.
   virtual std::function<void()> getPayload() = 0;
 
+  // feed() passes the bytes received from the endpoint to the Session, for
+  // integrating with an event loop without blocking on a Reader. feed()
+  // decodes and parses the messages completed by data, and returns their
+  // payloads in the order they were received. As with getPayload(), each
+  // payload is a function that dispatches the message to the Session handler.
+  // data may contain any number of messages, or partial messages.
+  // feed() must not be called concurrently, and must not be used with
+  // startProcessingMessages() or getPayload(). Responses are written to the
+  // Writer passed to connect(), which may be given a null Reader.
+  // For a Session created with an executor, feed() instead parses and
+  // dispatches the messages on the executor, in order, and returns no
+  // payloads, so that one event loop thread can feed many sessions.
+  // Note: This method is used for explicit control over message handling.
+  //       Most users will use bind() instead of calling this method directly.
+  virtual std::vector<std::function<void()>> feed(const void* data,
+                                                  size_t size) = 0;
+
   // The callback function type called when a request handler is invoked, and
   // the request returns a successful result.
   // 'responseTypeInfo' is the type information of the response data structure.
@@ -309,6 +712,13 @@ class Session {
   virtual void registerHandler(const TypeInfo* typeinfo,
                                const GenericRequestHandler& handler) = 0;
 
+  // registerLazyHandler() registers 'handler' as the request handler callback
+  // for requests of the type 'typeinfo'. The handler is passed a pointer to
+  // the RequestArguments of the request, instead of the request data
+  // structure.
+  virtual void registerLazyHandler(const TypeInfo* typeinfo,
+                                   const GenericRequestHandler& handler) = 0;
+
   // registerHandler() registers 'handler' as the event handler callback for
   // events of the type 'typeinfo'.
   virtual void registerHandler(const TypeInfo* typeinfo,
@@ -320,6 +730,25 @@ class Session {
   virtual void registerHandler(const TypeInfo* typeinfo,
                                const GenericResponseSentHandler& handler) = 0;
 
+  // setRequestPolicy() sets the dispatch policy for requests of the type
+  // 'typeinfo'.
+  virtual void setRequestPolicy(const TypeInfo* typeinfo,
+                                RequestPolicy policy) = 0;
+
+  // setDispatchMode() sets the dispatch mode for requests of the type
+  // 'typeinfo'.
+  virtual void setDispatchMode(const TypeInfo* typeinfo,
+                               DispatchMode mode) = 0;
+
+  // The function type used to return the conflation key of an event.
+  using ConflationKey = std::function<std::string(const void* event)>;
+
+  // setEventConflation() enables conflation of events of the type 'typeinfo'
+  // using the given key function, or disables conflation for the type if key
+  // is empty.
+  virtual void setEventConflation(const TypeInfo* typeinfo,
+                                  const ConflationKey& key) = 0;
+
   // send() sends a request to the remote endpoint.
   // 'requestTypeInfo' is the type info of the request data structure.
   // 'requestTypeInfo' is the type info of the response data structure.
@@ -330,6 +759,20 @@ class Session {
                     const void* request,
                     const GenericResponseHandler& responseHandler) = 0;
 
+  // send() sends a request to the remote endpoint.
+  // 'requestTypeInfo' is the type info of the request data structure.
+  // 'requestTypeInfo' is the type info of the response data structure.
+  // 'request' is a pointer to the request data structure.
+  // 'responseHandler' is the handler function for the response.
+  // 'timeout' is the duration to wait for the response before calling
+  // 'responseHandler' with an error. A timeout of zero waits forever, and a
+  // negative timeout uses the timeout set with setRequestTimeout().
+  virtual bool send(const dap::TypeInfo* requestTypeInfo,
+                    const dap::TypeInfo* responseTypeInfo,
+                    const void* request,
+                    const GenericResponseHandler& responseHandler,
+                    std::chrono::milliseconds timeout) = 0;
+
   // send() sends an event to the remote endpoint.
   // 'eventTypeInfo' is the type info for the event data structure.
   // 'event' is a pointer to the event data structure.
@@ -392,6 +835,28 @@ Session::registerHandler(F&& handler) {
       });
 }
 
+template <typename F, typename ViewType>
+Session::IsRequestViewHandler<ViewType> Session::registerHandler(F&& handler) {
+  using RequestType = typename ViewType::Request;
+  using ResponseType = typename RequestType::Response;
+  registerLazyHandler(
+      TypeOf<RequestType>::type(),
+      [handler](const void* args,
+                const RequestHandlerSuccessCallback& onSuccess,
+                const RequestHandlerErrorCallback& onError) {
+        ViewType view(reinterpret_cast<const RequestArguments*>(args));
+        ResponseOrError<ResponseType> res = handler(view);
+        if (!view.valid()) {
+          res = Error("Failed to deserialize request");
+        }
+        if (res.error) {
+          onError(TypeOf<ResponseType>::type(), res.error);
+        } else {
+          onSuccess(TypeOf<ResponseType>::type(), &res.response);
+        }
+      });
+}
+
 template <typename F, typename T>
 Session::IsEvent<T> Session::registerHandler(F&& handler) {
   auto cb = [handler](const void* args) {
@@ -414,19 +879,51 @@ void Session::registerSentHandler(F&& handler) {
   registerHandler(typeinfo, cb);
 }
 
+template <typename RequestType, typename>
+void Session::setRequestPolicy(RequestPolicy policy) {
+  setRequestPolicy(TypeOf<RequestType>::type(), policy);
+}
+
+template <typename RequestType, typename>
+void Session::setDispatchMode(DispatchMode mode) {
+  setDispatchMode(TypeOf<RequestType>::type(), mode);
+}
+
+template <typename EventType, typename F, typename>
+void Session::setEventConflation(F&& key) {
+  std::function<std::string(const EventType&)> fn(std::forward<F>(key));
+  if (!fn) {
+    setEventConflation(TypeOf<EventType>::type(), ConflationKey());
+    return;
+  }
+  setEventConflation(TypeOf<EventType>::type(), [fn](const void* event) {
+    return fn(*reinterpret_cast<const EventType*>(event));
+  });
+}
+
 template <typename T, typename>
 future<ResponseOrError<typename T::Response>> Session::send(const T& request) {
+  // A negative timeout uses the timeout set with setRequestTimeout().
+  return send(request, std::chrono::milliseconds(-1));
+}
+
+template <typename T, typename>
+future<ResponseOrError<typename T::Response>> Session::send(
+    const T& request,
+    std::chrono::milliseconds timeout) {
   using Response = typename T::Response;
   promise<ResponseOrError<Response>> promise;
-  auto sent = send(TypeOf<T>::type(), TypeOf<Response>::type(), &request,
-                   [=](const void* result, const Error* error) {
-                     if (error != nullptr) {
-                       promise.set_value(ResponseOrError<Response>(*error));
-                     } else {
-                       promise.set_value(ResponseOrError<Response>(
-                           *reinterpret_cast<const Response*>(result)));
-                     }
-                   });
+  auto sent = send(
+      TypeOf<T>::type(), TypeOf<Response>::type(), &request,
+      [=](const void* result, const Error* error) {
+        if (error != nullptr) {
+          promise.set_value(ResponseOrError<Response>(*error));
+        } else {
+          promise.set_value(ResponseOrError<Response>(
+              *reinterpret_cast<const Response*>(result)));
+        }
+      },
+      timeout);
   if (!sent) {
     promise.set_value(Error("Failed to send request"));
   }
@@ -0,0 +1,84 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_tracer_h
+#define dap_tracer_h
+
+#include "types.h"
+
+#include <stdint.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace dap {
+
+// Forward declarations
+class Writer;
+
+// Tracer records the time spent in each stage of the lifecycle of the
+// messages received and sent by a Session. See Session::setTracer().
+//
+// Received messages are traced through the following stages:
+//   read      - reading the message content, once its header has arrived.
+//   parse     - parsing the message.
+//   queued    - waiting to be dispatched.
+//   handle    - calling the message handler.
+// Sent messages are traced through the following stages:
+//   serialize - serializing the message.
+//   write     - waiting for, and writing to, the Writer.
+class Tracer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Message identifies a traced message.
+  struct Message {
+    // The message type: "request", "response" or "event".
+    std::string type;
+    // The request command, or the event name.
+    std::string name;
+    // The message sequence number.
+    integer seq = 0;
+  };
+
+  virtual ~Tracer();
+
+  // sample() returns true if the next message should be traced.
+  virtual bool sample() = 0;
+
+  // span() records that the message spent the time between start and end in
+  // the given stage, on the thread with the given identifier, as returned by
+  // currentThread() on the thread that ran the stage.
+  virtual void span(const char* stage,
+                    const Message& message,
+                    Clock::time_point start,
+                    Clock::time_point end,
+                    uint32_t thread) = 0;
+
+  // currentThread() returns a small integer that identifies the calling
+  // thread in traces.
+  static uint32_t currentThread();
+
+  // create() returns a Tracer that writes the spans to w in the Chrome trace
+  // event JSON array format, which can be loaded by chrome://tracing and the
+  // Perfetto UI. The closing ']' of the array is never written, which these
+  // tools permit.
+  // Only one in every sampleEvery messages is traced.
+  static std::shared_ptr<Tracer> create(const std::shared_ptr<Writer>& w,
+                                        uint32_t sampleEvery = 1);
+};
+
+}  // namespace dap
+
+#endif  // dap_tracer_h
@@ -260,3 +260,27 @@ TEST(Any, Reset) {
   any.reset();
   ASSERT_FALSE(any.is<dap::integer>());
 }
+
+TEST(Any, MoveAny) {
+  // dap::string is held in the any's buffer, and dap::object is larger than
+  // the buffer, so it is held on the heap.
+  dap::object obj;
+  obj["a"] = dap::integer(1);
+  dap::any small(dap::string("hello"));
+  dap::any large(obj);
+
+  dap::any movedSmall(std::move(small));
+  dap::any movedLarge(std::move(large));
+  ASSERT_TRUE(small.is<std::nullptr_t>());
+  ASSERT_TRUE(large.is<std::nullptr_t>());
+  ASSERT_EQ(movedSmall.get<dap::string>(), "hello");
+  ASSERT_EQ(movedLarge.get<dap::object>().size(), 1u);
+
+  dap::any assigned;
+  assigned = std::move(movedLarge);
+  ASSERT_TRUE(movedLarge.is<std::nullptr_t>());
+  ASSERT_EQ(assigned.get<dap::object>()["a"].get<dap::integer>(), 1);
+  assigned = std::move(movedSmall);
+  ASSERT_TRUE(movedSmall.is<std::nullptr_t>());
+  ASSERT_EQ(assigned.get<dap::string>(), "hello");
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/broadcast.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+class Impl : public dap::BroadcastGroup {
+ public:
+  void add(dap::Session* session) override {
+    std::unique_lock<std::mutex> lock(mutex);
+    sessions.push_back(session);
+  }
+
+  void remove(dap::Session* session) override {
+    std::unique_lock<std::mutex> lock(mutex);
+    sessions.erase(std::remove(sessions.begin(), sessions.end(), session),
+                   sessions.end());
+    cv.wait(lock, [&] { return sending.count(session) == 0; });
+  }
+
+  size_t size() override {
+    std::unique_lock<std::mutex> lock(mutex);
+    return sessions.size();
+  }
+
+  size_t send(const dap::SerializedEvent& event) override {
+    if (!event) {
+      return 0;
+    }
+    // Take a copy of the sessions, so that the group is not locked while
+    // sending. Each session is marked as sending until its send() completes,
+    // so that remove() can wait for it.
+    std::vector<dap::Session*> targets;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      targets = sessions;
+      for (auto session : targets) {
+        sending[session]++;
+      }
+    }
+    size_t sent = 0;
+    for (auto session : targets) {
+      if (session->send(event)) {
+        sent++;
+      }
+      std::unique_lock<std::mutex> lock(mutex);
+      auto it = sending.find(session);
+      if (--it->second == 0) {
+        sending.erase(it);
+        cv.notify_all();
+      }
+    }
+    return sent;
+  }
+
+ private:
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<dap::Session*> sessions;  // guarded by mutex
+  // The number of send() calls in progress, by session.
+  std::unordered_map<dap::Session*, int> sending;  // guarded by mutex
+};
+
+}  // anonymous namespace
+
+namespace dap {
+
+BroadcastGroup::~BroadcastGroup() = default;
+
+std::unique_ptr<BroadcastGroup> BroadcastGroup::create() {
+  return std::unique_ptr<BroadcastGroup>(new Impl());
+}
+
+}  // namespace dap
@@ -0,0 +1,178 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/broadcast.h"
+#include "dap/io.h"
+#include "dap/protocol.h"
+#include "dap/session.h"
+
+#include "chan.h"
+#include "json_serializer.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// Observer is a client session that receives OutputEvents broadcast by its
+// server session.
+struct Observer {
+  Observer() {
+    client->registerHandler(
+        [&](const dap::OutputEvent& event) { events.put(event); });
+    auto client2server = dap::pipe();
+    auto server2client = dap::pipe();
+    client->bind(server2client, client2server);
+    server->bind(client2server, server2client);
+  }
+
+  std::unique_ptr<dap::Session> client = dap::Session::create();
+  std::unique_ptr<dap::Session> server = dap::Session::create();
+  dap::Chan<dap::OutputEvent> events;
+};
+
+// GatedWriter blocks the first write until released.
+class GatedWriter : public dap::Writer {
+ public:
+  GatedWriter(const std::shared_ptr<dap::Writer>& inner) : inner(inner) {}
+  bool isOpen() override { return inner->isOpen(); }
+  void close() override { inner->close(); }
+  bool write(const void* buffer, size_t n) override {
+    if (!gated.exchange(true)) {
+      entered.put(true);
+      release.take();
+    }
+    return inner->write(buffer, n);
+  }
+  dap::Chan<bool> entered;
+  dap::Chan<bool> release;
+
+ private:
+  std::shared_ptr<dap::Writer> inner;
+  std::atomic<bool> gated = {false};
+};
+
+}  // anonymous namespace
+
+TEST(SerializedEvent, Message) {
+  dap::OutputEvent event;
+  event.output = "hello";
+  auto serialized = dap::SerializedEvent::create(event);
+  ASSERT_TRUE(serialized);
+  ASSERT_EQ(serialized.typeinfo(), dap::TypeOf<dap::OutputEvent>::type());
+
+  // The layout of the message depends on the JSON library, so parse it.
+  for (dap::integer seq : {42, 7}) {
+    dap::json::Deserializer d(serialized.message(seq));
+    dap::integer gotSeq = 0;
+    dap::string type;
+    dap::string name;
+    dap::OutputEvent body;
+    ASSERT_TRUE(d.field("seq", &gotSeq));
+    ASSERT_TRUE(d.field("type", &type));
+    ASSERT_TRUE(d.field("event", &name));
+    ASSERT_TRUE(d.field("body", &body));
+    ASSERT_EQ(gotSeq, seq);
+    ASSERT_EQ(type, "event");
+    ASSERT_EQ(name, "output");
+    ASSERT_EQ(body.output, "hello");
+  }
+
+  auto copy = static_cast<const dap::OutputEvent*>(serialized.event().get());
+  ASSERT_EQ(copy->output, "hello");
+}
+
+TEST(BroadcastGroup, Send) {
+  Observer observers[3];
+  auto group = dap::BroadcastGroup::create();
+  for (auto& observer : observers) {
+    group->add(observer.server.get());
+  }
+  ASSERT_EQ(group->size(), 3u);
+
+  // Give the sessions different sequence numbers.
+  dap::OutputEvent first;
+  first.output = "first";
+  observers[1].server->send(first);
+  ASSERT_EQ(observers[1].events.take()->output, "first");
+
+  dap::OutputEvent event;
+  event.output = "broadcast";
+  ASSERT_EQ(group->send(event), 3u);
+  for (auto& observer : observers) {
+    ASSERT_EQ(observer.events.take()->output, "broadcast");
+  }
+
+  group->remove(observers[0].server.get());
+  ASSERT_EQ(group->size(), 2u);
+  event.output = "again";
+  ASSERT_EQ(group->send(dap::SerializedEvent::create(event)), 2u);
+  ASSERT_EQ(observers[1].events.take()->output, "again");
+  ASSERT_EQ(observers[2].events.take()->output, "again");
+
+  for (auto& observer : observers) {
+    group->remove(observer.server.get());
+  }
+}
+
+TEST(BroadcastGroup, PairInProcess) {
+  auto client = dap::Session::create();
+  auto server = dap::Session::create();
+  dap::Chan<dap::OutputEvent> events;
+  client->registerHandler(
+      [&](const dap::OutputEvent& event) { events.put(event); });
+  dap::Session::pairInProcess(client.get(), server.get());
+
+  auto group = dap::BroadcastGroup::create();
+  group->add(server.get());
+  dap::OutputEvent event;
+  event.output = "in-process";
+  ASSERT_EQ(group->send(event), 1u);
+  ASSERT_EQ(events.take()->output, "in-process");
+  group->remove(server.get());
+}
+
+TEST(BroadcastGroup, SendDoesNotLockGroup) {
+  auto client = dap::Session::create();
+  auto server = dap::Session::create();
+  dap::Chan<dap::OutputEvent> events;
+  client->registerHandler(
+      [&](const dap::OutputEvent& event) { events.put(event); });
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  auto gate = std::make_shared<GatedWriter>(server2client);
+  client->bind(server2client, client2server);
+  server->bind(client2server, gate);
+
+  auto group = dap::BroadcastGroup::create();
+  group->add(server.get());
+  dap::OutputEvent event;
+  event.output = "blocked";
+  std::thread thread([&] { ASSERT_EQ(group->send(event), 1u); });
+  gate->entered.take();
+
+  // The group can be used while a send is blocked.
+  Observer observer;
+  group->add(observer.server.get());
+  ASSERT_EQ(group->size(), 2u);
+  group->remove(observer.server.get());
+
+  gate->release.put(true);
+  thread.join();
+  ASSERT_EQ(events.take()->output, "blocked");
+  group->remove(server.get());
+}
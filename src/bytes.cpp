@@ -0,0 +1,243 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/bytes.h"
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define CPPDAP_BASE64_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+namespace {
+
+const char kEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// kInvalid is the kDecodeTable entry of characters outside the alphabet.
+const uint8_t kInvalid = 0xff;
+
+struct DecodeTable {
+  DecodeTable() {
+    memset(values, kInvalid, sizeof(values));
+    for (uint8_t i = 0; i < 64; i++) {
+      values[static_cast<uint8_t>(kEncodeTable[i])] = i;
+    }
+  }
+  uint8_t values[256];
+};
+
+const DecodeTable kDecodeTable;
+
+// encodeScalar() encodes the size bytes at in to out, and returns the number
+// of characters written.
+size_t encodeScalar(const uint8_t* in, size_t size, char* out) {
+  char* start = out;
+  for (; size >= 3; in += 3, size -= 3) {
+    uint32_t v = (uint32_t(in[0]) << 16) | (uint32_t(in[1]) << 8) | in[2];
+    *out++ = kEncodeTable[(v >> 18) & 63];
+    *out++ = kEncodeTable[(v >> 12) & 63];
+    *out++ = kEncodeTable[(v >> 6) & 63];
+    *out++ = kEncodeTable[v & 63];
+  }
+  if (size > 0) {
+    uint32_t v = uint32_t(in[0]) << 16;
+    if (size == 2) {
+      v |= uint32_t(in[1]) << 8;
+    }
+    *out++ = kEncodeTable[(v >> 18) & 63];
+    *out++ = kEncodeTable[(v >> 12) & 63];
+    *out++ = size == 2 ? kEncodeTable[(v >> 6) & 63] : '=';
+    *out++ = '=';
+  }
+  return out - start;
+}
+
+// decodeScalar() decodes the size characters at in to out, and returns the
+// number of bytes written, or -1 if in is not valid base64.
+ptrdiff_t decodeScalar(const char* in, size_t size, uint8_t* out) {
+  // Strip up to two padding characters.
+  if (size % 4 == 0 && size >= 4) {
+    size -= in[size - 1] == '=' ? (in[size - 2] == '=' ? 2 : 1) : 0;
+  }
+  if (size % 4 == 1) {
+    return -1;
+  }
+  uint8_t* start = out;
+  uint32_t v = 0;
+  size_t n = 0;
+  for (size_t i = 0; i < size; i++) {
+    uint8_t d = kDecodeTable.values[static_cast<uint8_t>(in[i])];
+    if (d == kInvalid) {
+      return -1;
+    }
+    v = (v << 6) | d;
+    if (++n == 4) {
+      *out++ = static_cast<uint8_t>(v >> 16);
+      *out++ = static_cast<uint8_t>(v >> 8);
+      *out++ = static_cast<uint8_t>(v);
+      v = 0;
+      n = 0;
+    }
+  }
+  if (n == 2) {
+    *out++ = static_cast<uint8_t>(v >> 4);
+  } else if (n == 3) {
+    *out++ = static_cast<uint8_t>(v >> 10);
+    *out++ = static_cast<uint8_t>(v >> 2);
+  }
+  return out - start;
+}
+
+#ifdef CPPDAP_BASE64_SSSE3
+
+bool hasSSSE3() {
+  static const bool supported = __builtin_cpu_supports("ssse3");
+  return supported;
+}
+
+// encodeSSSE3() encodes blocks of 12 bytes at in to 16 characters at out,
+// while at least 16 bytes can be read from in. Returns the number of bytes
+// encoded.
+// See "Base64 encoding with SIMD instructions", Wojciech Mula.
+__attribute__((target("ssse3"))) size_t encodeSSSE3(const uint8_t* in,
+                                                     size_t size,
+                                                     char* out) {
+  const __m128i shuffle =
+      _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i offsets = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 12, out += 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    v = _mm_shuffle_epi8(v, shuffle);
+    // Split each 3 bytes into four 6-bit indices.
+    auto t0 = _mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00));
+    auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    auto t2 = _mm_and_si128(v, _mm_set1_epi32(0x003f03f0));
+    auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    auto indices = _mm_or_si128(t1, t3);
+    // Map each index to the offset of its alphabet range.
+    auto range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    auto lower = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(lower, _mm_set1_epi8(13)));
+    auto chars = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+  }
+  return i;
+}
+
+// decodeSSSE3() decodes blocks of 16 characters at in to 12 bytes at out,
+// stopping at the first block with a character outside the alphabet, such as
+// padding. Returns the number of characters decoded.
+// See "Base64 decoding with SIMD instructions", Wojciech Mula.
+__attribute__((target("ssse3"))) size_t decodeSSSE3(const char* in,
+                                                     size_t size,
+                                                     uint8_t* out) {
+  const __m128i shifts =
+      _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  // For each low nibble, the bit of each valid high nibble.
+  const __m128i valid = _mm_setr_epi8(
+      char(0xa8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8),
+      char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf0), 0x54, 0x50,
+      0x50, 0x50, 0x54);
+  const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, char(0x80), 0, 0,
+                                     0, 0, 0, 0, 0, 0);
+  const __m128i pack =
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16, out += 12) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    auto hi = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+    auto lo = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+    auto matches = _mm_and_si128(_mm_shuffle_epi8(valid, lo),
+                                 _mm_shuffle_epi8(bits, hi));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(matches, _mm_setzero_si128()))) {
+      break;
+    }
+    // '+' and '/' share a high nibble, so '/' is shifted separately.
+    auto slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+    auto shift = _mm_or_si128(
+        _mm_andnot_si128(slash, _mm_shuffle_epi8(shifts, hi)),
+        _mm_and_si128(slash, _mm_set1_epi8(16)));
+    auto indices = _mm_add_epi8(v, shift);
+    // Merge each four 6-bit indices into 3 bytes.
+    auto merged = _mm_maddubs_epi16(indices, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    merged = _mm_shuffle_epi8(merged, pack);
+    uint8_t block[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(block), merged);
+    memcpy(out, block, 12);
+  }
+  return i;
+}
+
+#endif  // CPPDAP_BASE64_SSSE3
+
+}  // anonymous namespace
+
+namespace dap {
+
+void base64Encode(const void* data, size_t size, char* out) {
+  auto in = reinterpret_cast<const uint8_t*>(data);
+#ifdef CPPDAP_BASE64_SSSE3
+  if (hasSSSE3()) {
+    size_t n = encodeSSSE3(in, size, out);
+    in += n;
+    size -= n;
+    out += n / 3 * 4;
+  }
+#endif
+  encodeScalar(in, size, out);
+}
+
+std::string base64Encode(const void* data, size_t size) {
+  std::string out(base64EncodedSize(size), '\0');
+  base64Encode(data, size, &out[0]);
+  return out;
+}
+
+bool base64Decode(const char* str, size_t size, std::vector<uint8_t>* out) {
+  size_t offset = out->size();
+  out->resize(offset + size / 4 * 3 + 3);
+  auto dst = out->data() + offset;
+#ifdef CPPDAP_BASE64_SSSE3
+  if (hasSSSE3()) {
+    // decodeSSSE3() stops at any padding, which decodeScalar() handles.
+    size_t n = decodeSSSE3(str, size, dst);
+    str += n;
+    size -= n;
+    dst += n / 4 * 3;
+  }
+#endif
+  auto n = decodeScalar(str, size, dst);
+  if (n < 0) {
+    return false;
+  }
+  out->resize(dst + n - out->data());
+  return true;
+}
+
+bool Deserializer::deserialize(bytes*) const {
+  return false;
+}
+
+bool Serializer::serialize(const bytes&) {
+  return false;
+}
+
+}  // namespace dap
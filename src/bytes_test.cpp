@@ -0,0 +1,138 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/bytes.h"
+#include "json_serializer.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <random>
+
+namespace dap {
+
+struct BytesTestObject {
+  bytes data;
+};
+
+DAP_STRUCT_TYPEINFO(BytesTestObject,
+                    "bytes-test-object",
+                    DAP_FIELD(data, "data"));
+
+}  // namespace dap
+
+namespace {
+
+std::vector<uint8_t> decode(const std::string& str) {
+  std::vector<uint8_t> out;
+  EXPECT_TRUE(dap::base64Decode(str.data(), str.size(), &out)) << str;
+  return out;
+}
+
+bool isValid(const std::string& str) {
+  std::vector<uint8_t> out;
+  return dap::base64Decode(str.data(), str.size(), &out);
+}
+
+std::string toString(const std::vector<uint8_t>& v) {
+  return std::string(v.begin(), v.end());
+}
+
+}  // anonymous namespace
+
+TEST(Base64, RFC4648) {
+  const char* vectors[][2] = {
+      {"", ""},           {"f", "Zg=="},         {"fo", "Zm8="},
+      {"foo", "Zm9v"},    {"foob", "Zm9vYg=="},  {"fooba", "Zm9vYmE="},
+      {"foobar", "Zm9vYmFy"},
+  };
+  for (auto& v : vectors) {
+    std::string in = v[0];
+    ASSERT_EQ(dap::base64Encode(in.data(), in.size()), v[1]);
+    ASSERT_EQ(toString(decode(v[1])), in);
+  }
+}
+
+TEST(Base64, Unpadded) {
+  ASSERT_EQ(toString(decode("Zg")), "f");
+  ASSERT_EQ(toString(decode("Zm8")), "fo");
+}
+
+TEST(Base64, Invalid) {
+  ASSERT_FALSE(isValid("Z"));
+  ASSERT_FALSE(isValid("Zm9v!"));
+  ASSERT_FALSE(isValid("Zm=v"));
+  ASSERT_FALSE(isValid("Zg==Zg=="));
+
+  // Invalid characters in the blocks decoded with SIMD instructions.
+  auto valid = dap::base64Encode(std::string(96, 'x').data(), 96);
+  for (size_t i = 0; i < valid.size(); i += 7) {
+    auto str = valid;
+    str[i] = '-';
+    ASSERT_FALSE(isValid(str)) << i;
+    str[i] = char(0xc3);
+    ASSERT_FALSE(isValid(str)) << i;
+  }
+}
+
+TEST(Base64, RoundTrip) {
+  std::mt19937 rng(1234);
+  for (size_t size = 0; size < 300; size++) {
+    std::vector<uint8_t> in(size);
+    for (auto& b : in) {
+      b = static_cast<uint8_t>(rng());
+    }
+    auto str = dap::base64Encode(in.data(), in.size());
+    ASSERT_EQ(str.size(), dap::base64EncodedSize(size));
+    ASSERT_EQ(decode(str), in) << size;
+  }
+}
+
+TEST(Base64, Alphabet) {
+  // Every 6-bit value, in order, encodes to the alphabet.
+  std::vector<uint8_t> in;
+  for (int i = 0; i < 64; i += 4) {
+    in.push_back(static_cast<uint8_t>((i << 2) | ((i + 1) >> 4)));
+    in.push_back(static_cast<uint8_t>(((i + 1) << 4) | ((i + 2) >> 2)));
+    in.push_back(static_cast<uint8_t>(((i + 2) << 6) | (i + 3)));
+  }
+  auto str = dap::base64Encode(in.data(), in.size());
+  ASSERT_EQ(str,
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+  ASSERT_EQ(decode(str), in);
+}
+
+TEST(Bytes, SerializeDeserialize) {
+  dap::BytesTestObject in;
+  for (int i = 0; i < 1000; i++) {
+    in.data.push_back(static_cast<uint8_t>(i * 7));
+  }
+  dap::json::Serializer s;
+  ASSERT_TRUE(s.serialize(in));
+
+  dap::json::Deserializer d(s.dump());
+  dap::string str;
+  ASSERT_TRUE(d.field("data", &str));
+  ASSERT_EQ(str, dap::base64Encode(in.data.data(), in.data.size()));
+
+  dap::BytesTestObject out;
+  ASSERT_TRUE(d.deserialize(&out));
+  ASSERT_EQ(out.data, in.data);
+}
+
+TEST(Bytes, DeserializeInvalid) {
+  dap::json::Deserializer d(R"({"data":"not base64!"})");
+  dap::BytesTestObject out;
+  ASSERT_FALSE(d.deserialize(&out));
+}
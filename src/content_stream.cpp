@@ -33,6 +33,7 @@ ContentReader& ContentReader::operator=(ContentReader&& rhs) noexcept {
   buf = std::move(rhs.buf);
   reader = std::move(rhs.reader);
   on_invalid_data = std::move(rhs.on_invalid_data);
+  started = rhs.started;
   return *this;
 }
 
@@ -57,6 +58,7 @@ std::string ContentReader::read() {
       return "";
     }
   }
+  started = std::chrono::steady_clock::now();
   // Skip whitespace and tabs
   while (matchAny(" \t")) {
   }
@@ -167,6 +169,112 @@ std::string ContentReader::badHeader() {
   return "";
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// ContentDecoder
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+const char kContentLength[] = "Content-Length:";
+const size_t kContentLengthLen = sizeof(kContentLength) - 1;
+}  // anonymous namespace
+
+ContentDecoder::ContentDecoder(
+    OnInvalidData on_invalid_data /* = OnInvalidData::kIgnore */)
+    : on_invalid_data(on_invalid_data) {}
+
+void ContentDecoder::feed(const void* data, size_t size) {
+  if (!valid) {
+    return;
+  }
+  // Discard the consumed bytes before growing the buffer.
+  if (pos > 0 && pos == buf.size()) {
+    buf.clear();
+    pos = 0;
+  } else if (pos > buf.size() / 2) {
+    buf.erase(0, pos);
+    pos = 0;
+  }
+  buf.append(reinterpret_cast<const char*>(data), size);
+}
+
+bool ContentDecoder::next(std::string& out) {
+  if (length == 0 && !header()) {
+    return false;
+  }
+  if (buf.size() - pos < length) {
+    return false;
+  }
+  out.assign(buf, pos, length);
+  pos += length;
+  length = 0;
+  return true;
+}
+
+bool ContentDecoder::header() {
+  while (valid) {
+    // Find Content-Length header prefix
+    if (on_invalid_data == kClose) {
+      auto n = std::min(buf.size() - pos, kContentLengthLen);
+      if (buf.compare(pos, n, kContentLength, n) != 0) {
+        return invalid();
+      }
+      if (n < kContentLengthLen) {
+        return false;
+      }
+    } else {
+      auto found = buf.find(kContentLength, pos);
+      if (found == std::string::npos) {
+        // Keep any trailing bytes that could be the start of the prefix.
+        if (buf.size() - pos > kContentLengthLen) {
+          pos = buf.size() - kContentLengthLen;
+        }
+        return false;
+      }
+      pos = found;
+    }
+    auto i = pos + kContentLengthLen;
+    // Skip whitespace and tabs
+    while (i < buf.size() && (buf[i] == ' ' || buf[i] == '\t')) {
+      i++;
+    }
+    // Parse length
+    size_t len = 0;
+    while (i < buf.size() && buf[i] >= '0' && buf[i] <= '9') {
+      len = len * 10 + static_cast<size_t>(buf[i] - '0');
+      i++;
+    }
+    // Expect \r\n\r\n
+    static const char kTerminator[] = "\r\n\r\n";
+    auto n = std::min(buf.size() - i, sizeof(kTerminator) - 1);
+    if (n < sizeof(kTerminator) - 1 &&
+        buf.compare(i, n, kTerminator, n) == 0) {
+      return false;  // Incomplete header
+    }
+    if (len == 0 || n < sizeof(kTerminator) - 1 ||
+        buf.compare(i, n, kTerminator, n) != 0) {
+      if (!invalid()) {
+        return false;
+      }
+      continue;
+    }
+    pos = i + n;
+    length = len;
+    return true;
+  }
+  return false;
+}
+
+bool ContentDecoder::invalid() {
+  if (on_invalid_data == kClose) {
+    valid = false;
+    buf.clear();
+    pos = 0;
+    return false;
+  }
+  // Skip the header prefix, and search for the next.
+  pos += kContentLengthLen;
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ContentWriter
 ////////////////////////////////////////////////////////////////////////////////
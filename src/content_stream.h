@@ -15,6 +15,7 @@
 #ifndef dap_content_stream_h
 #define dap_content_stream_h
 
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <string>
@@ -40,6 +41,10 @@ class ContentReader {
   void close();
   std::string read();
 
+  // startTime() returns the time at which the header of the message last
+  // returned by read() was found.
+  std::chrono::steady_clock::time_point startTime() const { return started; }
+
  private:
   bool scan(const uint8_t* seq, size_t len);
   bool scan(const char* str);
@@ -52,6 +57,41 @@ class ContentReader {
   std::shared_ptr<Reader> reader;
   std::deque<uint8_t> buf;
   OnInvalidData on_invalid_data;
+  std::chrono::steady_clock::time_point started;
+};
+
+// ContentDecoder incrementally decodes the messages from a stream of bytes,
+// for when the bytes are pushed to the decoder instead of pulled from a
+// Reader.
+class ContentDecoder {
+ public:
+  ContentDecoder(const OnInvalidData on_invalid_data = kIgnore);
+
+  // feed() appends the data to the bytes to decode.
+  void feed(const void* data, size_t size);
+
+  // next() assigns the content of the next complete message to out, returning
+  // true, or returns false if more data is needed to complete the message.
+  bool next(std::string& out);
+
+  // isValid() returns false if the decoder was constructed with kClose, and
+  // the stream was found to contain invalid data. Once invalid, next() always
+  // returns false.
+  bool isValid() const { return valid; }
+
+ private:
+  // header() parses the header of the next message, returning true once
+  // length has been assigned.
+  bool header();
+  // invalid() handles invalid data at the header starting at offset pos,
+  // returning true if decoding can continue.
+  bool invalid();
+
+  std::string buf;
+  size_t pos = 0;     // offset of the first unconsumed byte of buf
+  size_t length = 0;  // content length of the message, or 0 if not known
+  bool valid = true;
+  OnInvalidData on_invalid_data;
 };
 
 class ContentWriter {
@@ -19,7 +19,10 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace {
 
@@ -124,3 +127,40 @@ TEST(ContentStreamTest, HttpRequest) {
   ASSERT_EQ(cr.read(), "");
   ASSERT_FALSE(cr.isOpen());
 }
+
+TEST(ContentStreamTest, Decode) {
+  const std::string stream =
+      "Content-Length: 26\r\n\r\nContent payload number one"
+      "some unrecognised garbage"
+      "Content-Length: 26\r\n\r\nContent payload number two"
+      "Content-Length: 0\r\n\r\n"
+      "Content-Length: 28\r\n\r\nContent payload number three";
+
+  // Feed the stream in every possible chunk size.
+  for (size_t chunk = 1; chunk <= stream.size(); chunk++) {
+    dap::ContentDecoder decoder;
+    std::vector<std::string> got;
+    for (size_t i = 0; i < stream.size(); i += chunk) {
+      decoder.feed(stream.data() + i, std::min(chunk, stream.size() - i));
+      std::string message;
+      while (decoder.next(message)) {
+        got.emplace_back(message);
+      }
+    }
+    ASSERT_EQ(got, std::vector<std::string>({"Content payload number one",
+                                             "Content payload number two",
+                                             "Content payload number three"}))
+        << "chunk size: " << chunk;
+  }
+}
+
+TEST(ContentStreamTest, DecodeInvalidClose) {
+  dap::ContentDecoder decoder(dap::kClose);
+  const std::string data = "Content-Length: 2\r\n\r\n{}POST / HTTP/1.1\r\n";
+  decoder.feed(data.data(), data.size());
+  std::string message;
+  ASSERT_TRUE(decoder.next(message));
+  ASSERT_EQ(message, "{}");
+  ASSERT_FALSE(decoder.next(message));
+  ASSERT_FALSE(decoder.isValid());
+}
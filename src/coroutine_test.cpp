@@ -0,0 +1,111 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/coroutine.h"
+#include "dap/io.h"
+#include "dap/protocol.h"
+#include "dap/session.h"
+
+#include "chan.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+dap::task<int> add(int a, int b) {
+  co_return a + b;
+}
+
+dap::task<int> addThree(int a, int b, int c) {
+  auto ab = co_await add(a, b);
+  co_return co_await add(ab, c);
+}
+
+}  // anonymous namespace
+
+TEST(Coroutine, Task) {
+  int result = 0;
+  dap::spawn(addThree(1, 2, 3), [&](int r) { result = r; });
+  ASSERT_EQ(result, 6);
+}
+
+TEST(Coroutine, AwaitFuture) {
+  dap::promise<int> promise;
+  int result = 0;
+  dap::spawn(
+      [](dap::future<int> f) -> dap::task<int> {
+        co_return co_await std::move(f) * 2;
+      }(promise.get_future()),
+      [&](int r) { result = r; });
+  ASSERT_EQ(result, 0);
+  promise.set_value(21);
+  ASSERT_EQ(result, 42);
+}
+
+TEST(Coroutine, AwaitReadyFuture) {
+  dap::promise<int> promise;
+  promise.set_value(10);
+  int result = 0;
+  dap::spawn(
+      [](dap::future<int> f) -> dap::task<int> { co_return co_await std::move(f); }(
+          promise.get_future()),
+      [&](int r) { result = r; });
+  ASSERT_EQ(result, 10);
+}
+
+TEST(Coroutine, SessionRequests) {
+  auto client = dap::Session::create();
+  auto server = dap::Session::create();
+
+  client->registerHandler([](const dap::RunInTerminalRequest&) {
+    dap::RunInTerminalResponse response;
+    response.processId = 42;
+    return response;
+  });
+
+  // The server handler issues a reverse request to the client while handling
+  // the evaluate request, without blocking the server's dispatch thread.
+  auto srv = server.get();
+  dap::registerCoroutineHandler(
+      srv, [srv](const dap::EvaluateRequest& request)
+               -> dap::task<dap::ResponseOrError<dap::EvaluateResponse>> {
+        dap::RunInTerminalRequest runInTerminal;
+        auto res = co_await srv->send(runInTerminal);
+        if (res.error) {
+          co_return res.error;
+        }
+        dap::EvaluateResponse response;
+        response.result = request.expression + " " +
+                          std::to_string(res.response.processId.value(0));
+        co_return response;
+      });
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->bind(server2client, client2server);
+  server->bind(client2server, server2client);
+
+  dap::Chan<std::string> results;
+  auto evaluate = [](dap::Session* session,
+                     std::string expression) -> dap::task<std::string> {
+    dap::EvaluateRequest request;
+    request.expression = expression;
+    auto res = co_await session->send(request);
+    co_return res.error ? res.error.message : res.response.result;
+  };
+  dap::spawn(evaluate(client.get(), "pid"),
+             [&](std::string r) { results.put(r); });
+  ASSERT_EQ(results.take().value(), "pid 42");
+}
@@ -0,0 +1,148 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// ThreadPool is a work-stealing Executor. Each worker thread has its own task
+// queue. Tasks enqueued from a worker thread are placed on that worker's
+// queue, other tasks are distributed round-robin. Idle workers steal tasks
+// from the back of the other workers' queues.
+class ThreadPool : public dap::Executor {
+ public:
+  ThreadPool(size_t numThreads) {
+    for (size_t i = 0; i < numThreads; i++) {
+      workers.emplace_back(new Worker());
+    }
+    for (size_t i = 0; i < numThreads; i++) {
+      threads.emplace_back([this, i] { run(i); });
+    }
+  }
+
+  ~ThreadPool() override {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      shutdown = true;
+      cv.notify_all();
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void enqueue(Task&& task) override {
+    auto index = (current == this)
+                     ? currentIndex
+                     : next.fetch_add(1, std::memory_order_relaxed) %
+                           workers.size();
+    // pending is incremented before the task is published, so that a worker
+    // that takes the task never decrements pending below zero.
+    pending.fetch_add(1, std::memory_order_release);
+    {
+      auto& worker = *workers[index];
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      worker.tasks.emplace_back(std::move(task));
+    }
+    // Lock the mutex to ensure a worker that has just observed no pending
+    // tasks is waiting on the condition variable before notifying.
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.notify_one();
+  }
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void run(size_t index) {
+    current = this;
+    currentIndex = index;
+    Task task;
+    while (true) {
+      if (take(index, task)) {
+        task();
+        task = nullptr;
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] {
+        return shutdown || pending.load(std::memory_order_acquire) > 0;
+      });
+      if (shutdown && pending.load(std::memory_order_acquire) == 0) {
+        return;
+      }
+    }
+  }
+
+  // take() pops the task from the front of the worker's own queue, or steals
+  // a task from the back of another worker's queue.
+  bool take(size_t index, Task& task) {
+    for (size_t i = 0; i < workers.size(); i++) {
+      auto& worker = *workers[(index + i) % workers.size()];
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      if (worker.tasks.empty()) {
+        continue;
+      }
+      if (i == 0) {
+        task = std::move(worker.tasks.front());
+        worker.tasks.pop_front();
+      } else {
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+      }
+      pending.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+
+  static thread_local ThreadPool* current;
+  static thread_local size_t currentIndex;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+  std::atomic<size_t> next = {0};
+  std::atomic<size_t> pending = {0};
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool shutdown = false;
+};
+
+thread_local ThreadPool* ThreadPool::current = nullptr;
+thread_local size_t ThreadPool::currentIndex = 0;
+
+}  // anonymous namespace
+
+namespace dap {
+
+Executor::~Executor() = default;
+
+std::shared_ptr<Executor> Executor::create(size_t numThreads /* = 0 */) {
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  return std::make_shared<ThreadPool>(numThreads);
+}
+
+}  // namespace dap
@@ -0,0 +1,88 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/executor.h"
+#include "chan.h"
+#include "strand.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <vector>
+
+TEST(Executor, RunsAllTasks) {
+  std::atomic<int> count = {0};
+  {
+    auto executor = dap::Executor::create(4);
+    auto e = executor.get();
+    for (int i = 0; i < 100; i++) {
+      executor->enqueue([&, e] {
+        count++;
+        // Tasks enqueued from a worker are placed on the worker's own queue.
+        for (int j = 0; j < 10; j++) {
+          e->enqueue([&] { count++; });
+        }
+      });
+    }
+  }
+  ASSERT_EQ(count, 1100);
+}
+
+TEST(Executor, DestructWaitsForTasks) {
+  std::atomic<int> count = {0};
+  {
+    auto executor = dap::Executor::create(2);
+    for (int i = 0; i < 100; i++) {
+      executor->enqueue([&] { count++; });
+    }
+  }
+  ASSERT_EQ(count, 100);
+}
+
+TEST(Strand, RunsInOrder) {
+  auto executor = dap::Executor::create(4);
+  dap::Strand strand(executor);
+  std::vector<int> order;  // only accessed by tasks on the strand
+  dap::Chan<bool> done;
+  for (int i = 0; i < 100; i++) {
+    strand.post([&, i] { order.push_back(i); });
+  }
+  strand.post([&] { done.put(true); });
+  done.take();
+  ASSERT_EQ(order.size(), 100u);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(order[i], i);
+  }
+}
+
+TEST(Strand, Close) {
+  auto executor = dap::Executor::create(1);
+  dap::Strand strand(executor);
+  dap::Chan<bool> started;
+  dap::Chan<bool> release;
+  std::atomic<int> count = {0};
+  strand.post([&] {
+    started.put(true);
+    release.take();
+    count++;
+  });
+  strand.post([&] { count++; });
+  started.take();
+  release.put(true);
+  strand.close();
+  ASSERT_FALSE(strand.post([&] { count++; }));
+  ASSERT_GE(count, 1);
+  ASSERT_LE(count, 2);
+}
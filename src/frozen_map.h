@@ -0,0 +1,122 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_frozen_map_h
+#define dap_frozen_map_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace dap {
+
+// FrozenMap is an immutable hash map, built once from the entries of another
+// map. As a FrozenMap cannot be modified, it can be safely read from multiple
+// threads without synchronization.
+// When built, FrozenMap searches for a table size at which no two keys share a
+// slot, so that most lookups are a single hash, probe and key comparison.
+template <typename K, typename V, typename HASH = std::hash<K>>
+class FrozenMap {
+ public:
+  inline FrozenMap() = default;
+
+  // Constructs the FrozenMap from the entries of map, which must be iterable
+  // as std::pair<K, V>.
+  template <typename MAP>
+  inline explicit FrozenMap(const MAP& map);
+
+  // find() returns a pointer to the value with the given key, or nullptr if
+  // the map does not contain the key.
+  inline const V* find(const K& key) const;
+
+  // size() returns the number of entries in the map.
+  inline size_t size() const { return entries.size(); }
+
+ private:
+  struct Entry {
+    size_t hash;
+    K key;
+    V value;
+  };
+
+  // place() assigns each of the entries a slot in a table of the given size,
+  // returning false if collisionFree is true and two entries share a slot.
+  inline bool place(size_t size, bool collisionFree);
+
+  std::vector<Entry> entries;
+  std::vector<uint32_t> slots;  // entries index + 1, or 0 for an empty slot
+  size_t mask = 0;
+};
+
+template <typename K, typename V, typename HASH>
+template <typename MAP>
+FrozenMap<K, V, HASH>::FrozenMap(const MAP& map) {
+  entries.reserve(map.size());
+  for (auto& it : map) {
+    entries.emplace_back(Entry{HASH()(it.first), it.first, it.second});
+  }
+  size_t size = 8;
+  while (size < entries.size() * 2) {
+    size *= 2;
+  }
+  // Try progressively larger tables for a collision-free placement, falling
+  // back to linear probing in the smallest table.
+  for (size_t attempt = size; attempt <= size * 16; attempt *= 2) {
+    if (place(attempt, true)) {
+      return;
+    }
+  }
+  place(size, false);
+}
+
+template <typename K, typename V, typename HASH>
+bool FrozenMap<K, V, HASH>::place(size_t size, bool collisionFree) {
+  slots.assign(size, 0);
+  mask = size - 1;
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto slot = entries[i].hash & mask;
+    while (slots[slot] != 0) {
+      if (collisionFree) {
+        return false;
+      }
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = static_cast<uint32_t>(i + 1);
+  }
+  return true;
+}
+
+template <typename K, typename V, typename HASH>
+const V* FrozenMap<K, V, HASH>::find(const K& key) const {
+  if (entries.empty()) {
+    return nullptr;
+  }
+  auto hash = HASH()(key);
+  for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+    auto index = slots[slot];
+    if (index == 0) {
+      return nullptr;
+    }
+    auto& entry = entries[index - 1];
+    if (entry.hash == hash && entry.key == key) {
+      return &entry.value;
+    }
+  }
+}
+
+}  // namespace dap
+
+#endif  // dap_frozen_map_h
@@ -0,0 +1,56 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "frozen_map.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <unordered_map>
+
+TEST(FrozenMap, Empty) {
+  dap::FrozenMap<std::string, int> map;
+  ASSERT_EQ(map.size(), 0u);
+  ASSERT_EQ(map.find("launch"), nullptr);
+}
+
+TEST(FrozenMap, Find) {
+  std::unordered_map<std::string, int> src;
+  for (int i = 0; i < 100; i++) {
+    src.emplace("command" + std::to_string(i), i);
+  }
+  dap::FrozenMap<std::string, int> map(src);
+  ASSERT_EQ(map.size(), 100u);
+  for (int i = 0; i < 100; i++) {
+    auto value = map.find("command" + std::to_string(i));
+    ASSERT_NE(value, nullptr);
+    ASSERT_EQ(*value, i);
+  }
+  ASSERT_EQ(map.find("command100"), nullptr);
+  ASSERT_EQ(map.find(""), nullptr);
+}
+
+struct CollidingHash {
+  size_t operator()(int) const { return 3; }
+};
+
+TEST(FrozenMap, Collisions) {
+  std::unordered_map<int, int> src = {{1, 10}, {2, 20}, {3, 30}};
+  dap::FrozenMap<int, int, CollidingHash> map(src);
+  ASSERT_EQ(*map.find(1), 10);
+  ASSERT_EQ(*map.find(2), 20);
+  ASSERT_EQ(*map.find(3), 30);
+  ASSERT_EQ(map.find(4), nullptr);
+}
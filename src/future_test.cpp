@@ -0,0 +1,109 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/future.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+
+TEST(Future, DefaultIsInvalid) {
+  dap::future<int> f;
+  ASSERT_FALSE(f.valid());
+}
+
+TEST(Future, GetAcrossThreads) {
+  dap::promise<int> p;
+  auto f = p.get_future();
+  ASSERT_TRUE(f.valid());
+  ASSERT_EQ(f.wait_for(std::chrono::milliseconds(1)),
+            dap::future_status::timeout);
+  auto thread = std::thread([p] { p.set_value(42); });
+  ASSERT_EQ(f.get(), 42);
+  thread.join();
+  ASSERT_EQ(f.wait_for(std::chrono::milliseconds(0)),
+            dap::future_status::ready);
+}
+
+TEST(Future, CopiedPromiseSharesState) {
+  // The state is allocated lazily, so copies made before first use must still
+  // share it.
+  dap::promise<int> p;
+  dap::promise<int> copy(p);
+  copy.set_value(42);
+  ASSERT_EQ(p.get_future().get(), 42);
+}
+
+TEST(Future, ThenBeforeValue) {
+  dap::promise<int> p;
+  auto f = p.get_future().then([](int i) { return std::to_string(i); });
+  ASSERT_EQ(f.wait_for(std::chrono::milliseconds(0)),
+            dap::future_status::timeout);
+  p.set_value(10);
+  ASSERT_EQ(f.wait_for(std::chrono::milliseconds(0)),
+            dap::future_status::ready);
+  ASSERT_EQ(f.get(), "10");
+}
+
+TEST(Future, ThenAfterValue) {
+  dap::promise<int> p;
+  auto f = p.get_future();
+  p.set_value(10);
+  int got = 0;
+  f.then([&](int i) { got = i; });
+  ASSERT_FALSE(f.valid());
+  ASSERT_EQ(got, 10);
+}
+
+TEST(Future, WhenAll) {
+  std::vector<dap::promise<int>> promises(4);
+  std::vector<dap::future<int>> futures;
+  for (auto& p : promises) {
+    futures.emplace_back(p.get_future());
+  }
+  auto all = dap::when_all(std::move(futures));
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < promises.size(); i++) {
+    auto p = promises[i];
+    threads.emplace_back([p, i] { p.set_value(static_cast<int>(i * 10)); });
+  }
+  ASSERT_EQ(all.get(), std::vector<int>({0, 10, 20, 30}));
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(Future, WhenAllEmpty) {
+  auto all = dap::when_all(std::vector<dap::future<int>>());
+  ASSERT_EQ(all.wait_for(std::chrono::milliseconds(0)),
+            dap::future_status::ready);
+  ASSERT_TRUE(all.get().empty());
+}
+
+TEST(Future, WhenAny) {
+  std::vector<dap::promise<int>> promises(3);
+  std::vector<dap::future<int>> futures;
+  for (auto& p : promises) {
+    futures.emplace_back(p.get_future());
+  }
+  auto any = dap::when_any(std::move(futures));
+  promises[1].set_value(20);
+  promises[0].set_value(10);
+  auto got = any.get();
+  ASSERT_EQ(got.index, 1u);
+  ASSERT_EQ(got.value, 20);
+  promises[2].set_value(30);
+}
@@ -0,0 +1,122 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/interned_string.h"
+#include "dap/serialization.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+class StringPoolImpl : public dap::StringPool {
+ public:
+  dap::interned_string intern(const std::string& str) override {
+    return intern(str.data(), str.size());
+  }
+
+  dap::interned_string intern(const char* str, size_t size) override {
+    if (size == 0) {
+      return dap::interned_string();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = strings.find(Key{str, size});
+    if (it != strings.end()) {
+      return wrap(it->second);
+    }
+    auto interned = std::make_shared<const std::string>(str, size);
+    strings.emplace(Key{interned->data(), size}, interned);
+    return wrap(interned);
+  }
+
+  size_t size() override {
+    std::unique_lock<std::mutex> lock(mutex);
+    return strings.size();
+  }
+
+  size_t purge() override {
+    std::unique_lock<std::mutex> lock(mutex);
+    size_t removed = 0;
+    for (auto it = strings.begin(); it != strings.end();) {
+      if (it->second.use_count() == 1) {
+        it = strings.erase(it);
+        removed++;
+      } else {
+        ++it;
+      }
+    }
+    return removed;
+  }
+
+ private:
+  // Key refers to the characters of a string, so that strings can be looked
+  // up without copying them.
+  struct Key {
+    const char* data;
+    size_t size;
+  };
+  // Hash is the FNV-1a hash of the characters.
+  struct Hash {
+    size_t operator()(const Key& key) const {
+      uint64_t hash = 14695981039346656037ull;
+      for (size_t i = 0; i < key.size; i++) {
+        hash = (hash ^ static_cast<uint8_t>(key.data[i])) * 1099511628211ull;
+      }
+      return static_cast<size_t>(hash);
+    }
+  };
+  struct Equal {
+    bool operator()(const Key& a, const Key& b) const {
+      return a.size == b.size && memcmp(a.data, b.data, a.size) == 0;
+    }
+  };
+
+  std::mutex mutex;
+  // strings is keyed by the characters of the string held by the value.
+  std::unordered_map<Key, std::shared_ptr<const std::string>, Hash, Equal>
+      strings;  // guarded by mutex
+};
+
+}  // anonymous namespace
+
+namespace dap {
+
+const std::string& interned_string::emptyString() {
+  static const std::string empty;
+  return empty;
+}
+
+StringPool::~StringPool() = default;
+
+interned_string StringPool::intern(const char* str, size_t size) {
+  return intern(std::string(str, size));
+}
+
+bool Deserializer::deserialize(interned_string* v) const {
+  string str;
+  if (!deserialize(&str)) {
+    return false;
+  }
+  auto pool = stringPool();
+  *v = pool ? pool->intern(str) : interned_string(str);
+  return true;
+}
+
+std::shared_ptr<StringPool> StringPool::create() {
+  return std::make_shared<StringPoolImpl>();
+}
+
+}  // namespace dap
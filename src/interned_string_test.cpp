@@ -0,0 +1,96 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/interned_string.h"
+#include "json_serializer.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace dap {
+
+struct InternedStringTestObject {
+  interned_string path;
+  array<interned_string> types;
+};
+
+DAP_STRUCT_TYPEINFO(InternedStringTestObject,
+                    "interned-string-test-object",
+                    DAP_FIELD(path, "path"),
+                    DAP_FIELD(types, "types"));
+
+}  // namespace dap
+
+TEST(InternedString, Default) {
+  dap::interned_string str;
+  ASSERT_TRUE(str.empty());
+  ASSERT_EQ(str.str(), "");
+  ASSERT_EQ(str, dap::interned_string(""));
+}
+
+TEST(InternedString, Compare) {
+  dap::interned_string a("meow");
+  dap::interned_string b(std::string("meow"));
+  ASSERT_EQ(a, b);
+  ASSERT_NE(a, dap::interned_string("woof"));
+  ASSERT_EQ(a.size(), 4u);
+  const std::string& str = a;
+  ASSERT_EQ(str, "meow");
+}
+
+TEST(InternedString, Pool) {
+  auto pool = dap::StringPool::create();
+  auto a = pool->intern("meow");
+  auto b = pool->intern("meow");
+  auto c = pool->intern("woof");
+  ASSERT_EQ(&a.str(), &b.str());
+  ASSERT_EQ(a, b);
+  ASSERT_NE(a, c);
+  ASSERT_EQ(pool->size(), 2u);
+
+  // Interning a character range finds the same string.
+  auto d = pool->intern("meowing", 4);
+  ASSERT_EQ(&a.str(), &d.str());
+  ASSERT_TRUE(pool->intern("", 0).empty());
+  ASSERT_EQ(dap::interned_string("woofs", 4), c);
+
+  c = dap::interned_string();
+  ASSERT_EQ(pool->purge(), 1u);
+  ASSERT_EQ(pool->size(), 1u);
+  ASSERT_EQ(a.str(), "meow");
+}
+
+TEST(InternedString, Deserialize) {
+  auto pool = dap::StringPool::create();
+  auto json = R"({"path":"/src/a.cpp","types":["int","int","float"]})";
+  dap::InternedStringTestObject a;
+  dap::InternedStringTestObject b;
+  dap::json::Deserializer da(json, pool.get());
+  dap::json::Deserializer db(json, pool.get());
+  ASSERT_TRUE(da.deserialize(&a));
+  ASSERT_TRUE(db.deserialize(&b));
+  ASSERT_EQ(a.path.str(), "/src/a.cpp");
+  ASSERT_EQ(a.types.size(), 3u);
+  ASSERT_EQ(&a.path.str(), &b.path.str());
+  ASSERT_EQ(&a.types[0].str(), &a.types[1].str());
+  ASSERT_EQ(pool->size(), 3u);
+
+  dap::json::Serializer s;
+  ASSERT_TRUE(s.serialize(a));
+  dap::InternedStringTestObject c;
+  dap::json::Deserializer dc(s.dump());
+  ASSERT_TRUE(dc.deserialize(&c));
+  ASSERT_EQ(c.path, a.path);
+  ASSERT_EQ(c.types, a.types);
+}
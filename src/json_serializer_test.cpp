@@ -14,12 +14,20 @@
 
 #include "json_serializer.h"
 
+#include "dap/raw_json.h"
 #include "dap/typeinfo.h"
 #include "dap/typeof.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#if defined(CPPDAP_JSON_NLOHMANN)
+#define JSON_NOEXCEPTION 1
+#include <nlohmann/json.hpp>
+#endif
+
+#include <limits>
+
 namespace dap {
 
 struct JSONInnerTestObject {
@@ -69,6 +77,42 @@ DAP_STRUCT_TYPEINFO(SimpleJSONTestObject,
 
 }  // namespace dap
 
+namespace {
+
+// KindlessDeserializer forwards to another Deserializer, implementing only
+// the methods that have no default, as a Deserializer written before kind()
+// was added would.
+class KindlessDeserializer : public dap::Deserializer {
+ public:
+  explicit KindlessDeserializer(const dap::Deserializer* d) : d(d) {}
+
+  bool deserialize(dap::boolean* v) const override {
+    return d->deserialize(v);
+  }
+  bool deserialize(dap::integer* v) const override {
+    return d->deserialize(v);
+  }
+  bool deserialize(dap::number* v) const override { return d->deserialize(v); }
+  bool deserialize(dap::string* v) const override { return d->deserialize(v); }
+  bool deserialize(dap::object* v) const override { return d->deserialize(v); }
+  bool deserialize(dap::any* v) const override { return d->deserialize(v); }
+  size_t count() const override { return d->count(); }
+  bool array(const std::function<bool(dap::Deserializer*)>& cb) const override {
+    return d->array(cb);
+  }
+  bool field(const std::string& name,
+             const std::function<bool(dap::Deserializer*)>& cb) const override {
+    return d->field(name, cb);
+  }
+
+  using dap::Deserializer::deserialize;
+
+ private:
+  const dap::Deserializer* const d;
+};
+
+}  // anonymous namespace
+
 class JSONSerializer : public testing::Test {
  protected:
   static dap::object GetSimpleObject() {
@@ -264,3 +308,214 @@ TEST_F(JSONSerializer, SerializeDeserializeObjectWithNulledField) {
   ASSERT_TRUE(d.deserialize(&decoded));
   ASSERT_TRUE(encoded["nulled_field"].is<dap::null>());
 }
+
+TEST_F(JSONSerializer, Kind) {
+  using Kind = dap::Deserializer::Kind;
+  auto kindOf = [](const char* json) {
+    dap::json::Deserializer d(json);
+    return d.kind();
+  };
+  ASSERT_EQ(kindOf("null"), Kind::kNull);
+  ASSERT_EQ(kindOf("true"), Kind::kBoolean);
+  ASSERT_EQ(kindOf("10"), Kind::kInteger);
+  ASSERT_EQ(kindOf("1.5"), Kind::kNumber);
+  ASSERT_EQ(kindOf("\"s\""), Kind::kString);
+  ASSERT_EQ(kindOf("[1]"), Kind::kArray);
+  ASSERT_EQ(kindOf("{}"), Kind::kObject);
+
+  dap::json::Deserializer d("{}");
+  ASSERT_TRUE(d.field("missing", [](dap::Deserializer* d) {
+    return d->kind() == Kind::kUndefined;
+  }));
+}
+
+TEST_F(JSONSerializer, DeserializeVariant) {
+  using Variant = dap::variant<dap::integer, dap::string>;
+  Variant v;
+  dap::json::Deserializer integer("10");
+  ASSERT_TRUE(integer.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::integer>());
+  ASSERT_EQ(v.get<dap::integer>(), 10);
+
+  dap::json::Deserializer string("\"ten\"");
+  ASSERT_TRUE(string.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::string>());
+  ASSERT_EQ(v.get<dap::string>(), "ten");
+
+  // Values of no alternative's kind are rejected.
+  dap::json::Deserializer boolean("true");
+  ASSERT_FALSE(boolean.deserialize(&v));
+
+  dap::variant<dap::string, dap::null> nullable;
+  dap::json::Deserializer null("null");
+  ASSERT_TRUE(null.deserialize(&nullable));
+  ASSERT_TRUE(nullable.is<dap::null>());
+}
+
+TEST_F(JSONSerializer, DeserializeVariantUnknownKind) {
+  using Variant = dap::variant<dap::integer, dap::string>;
+  Variant v;
+  dap::json::Deserializer string("\"ten\"");
+  KindlessDeserializer kindlessString(&string);
+  ASSERT_EQ(kindlessString.kind(), dap::Deserializer::kUnknown);
+  ASSERT_TRUE(kindlessString.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::string>());
+  ASSERT_EQ(v.get<dap::string>(), "ten");
+
+  dap::json::Deserializer integer("10");
+  KindlessDeserializer kindlessInteger(&integer);
+  ASSERT_TRUE(kindlessInteger.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::integer>());
+  ASSERT_EQ(v.get<dap::integer>(), 10);
+
+  dap::json::Deserializer boolean("true");
+  KindlessDeserializer kindlessBoolean(&boolean);
+  ASSERT_FALSE(kindlessBoolean.deserialize(&v));
+}
+
+TEST_F(JSONSerializer, DeserializeVariantPrefersExactKind) {
+  dap::variant<dap::number, dap::integer> v;
+  dap::json::Deserializer integer("10");
+  ASSERT_TRUE(integer.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::integer>());
+
+  // An integer is held by a number when there is no integer alternative.
+  dap::variant<dap::string, dap::number> n;
+  ASSERT_TRUE(integer.deserialize(&n));
+  ASSERT_TRUE(n.is<dap::number>());
+  ASSERT_EQ(n.get<dap::number>(), 10.0);
+}
+
+TEST_F(JSONSerializer, DeserializeVariantStruct) {
+  dap::variant<dap::integer, dap::JSONInnerTestObject> v;
+  dap::json::Deserializer d(R"({"i":5})");
+  ASSERT_TRUE(d.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::JSONInnerTestObject>());
+  ASSERT_EQ(v.get<dap::JSONInnerTestObject>().i, 5);
+}
+
+TEST_F(JSONSerializer, DeserializeVariantFailureKeepsValue) {
+  // The value matches the kind of the struct, but fails to decode as it.
+  dap::json::Deserializer d(R"({"i":"five"})");
+  dap::variant<dap::integer, dap::JSONInnerTestObject> v(dap::integer(10));
+  ASSERT_FALSE(d.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::integer>());
+  ASSERT_EQ(v.get<dap::integer>(), 10);
+
+  dap::variant<dap::JSONInnerTestObject, dap::integer> s(
+      dap::JSONInnerTestObject{});
+  s.get<dap::JSONInnerTestObject>().i = 5;
+  ASSERT_FALSE(d.deserialize(&s));
+  ASSERT_EQ(s.get<dap::JSONInnerTestObject>().i, 5);
+
+  // An any alternative still accepts the value.
+  dap::variant<dap::JSONInnerTestObject, dap::any> a;
+  ASSERT_TRUE(d.deserialize(&a));
+  ASSERT_TRUE(a.is<dap::any>());
+  ASSERT_TRUE(a.get<dap::any>().is<dap::object>());
+}
+
+TEST_F(JSONSerializer, DeserializeVariantData) {
+  // The variant used by protocol fields of any JSON value.
+  dap::variant<dap::array<dap::any>, dap::boolean, dap::integer, dap::null,
+               dap::number, dap::object, dap::string>
+      v;
+  dap::json::Deserializer arr("[1,\"a\"]");
+  ASSERT_TRUE(arr.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::array<dap::any>>());
+  ASSERT_EQ(v.get<dap::array<dap::any>>().size(), 2u);
+
+  dap::json::Deserializer obj(R"({"a":1})");
+  ASSERT_TRUE(obj.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::object>());
+
+  dap::json::Deserializer number("1.5");
+  ASSERT_TRUE(number.deserialize(&v));
+  ASSERT_TRUE(v.is<dap::number>());
+}
+
+#if defined(CPPDAP_JSON_NLOHMANN)
+
+// The nlohmann backend writes JSON text with its own writer, rather than
+// nlohmann::json::dump(), so check that the two agree.
+
+namespace {
+
+// rewrite() parses the JSON text, and writes it back with the writer of the
+// nlohmann backend.
+std::string rewrite(const std::string& text) {
+  dap::json::Deserializer d(text);
+  dap::raw_json raw;
+  EXPECT_TRUE(d.deserialize(&raw));
+  return raw.str();
+}
+
+}  // anonymous namespace
+
+TEST_F(JSONSerializer, NlohmannWriterMatchesDump) {
+  using json = nlohmann::json;
+  const char control[] = "\0\x01\x1f\x7f \" \\ / \b\f\n\r\t";
+  const json values[] = {
+      json(0.0),
+      json(-0.0),
+      json(1.5),
+      json(0.1),
+      json(1e300),
+      json(-1e-300),
+      json(5e-324),
+      json(123456789.125),
+      json(std::numeric_limits<double>::max()),
+      json(std::numeric_limits<int64_t>::max()),
+      json(std::numeric_limits<int64_t>::min()),
+      json(std::numeric_limits<uint64_t>::max()),
+      json(0),
+      json(-1),
+      json(true),
+      json(nullptr),
+      json::array(),
+      json::object(),
+      json::parse(R"([[],{},[{}],{"a":{},"b":[[]]},[[[]]]])"),
+      json(std::string(control, sizeof(control) - 1)),
+      json::object({{std::string(control, sizeof(control) - 1),
+                     json::array({false, nullptr, 1.25, -7})}}),
+  };
+  for (auto& v : values) {
+    auto text = v.dump();
+    ASSERT_EQ(rewrite(text), text);
+  }
+
+  const double numbers[] = {0.1, -2.5e-8, 1e21, 3.0,
+                            std::numeric_limits<double>::lowest()};
+  for (auto n : numbers) {
+    dap::json::Serializer s;
+    ASSERT_TRUE(s.serialize(dap::number(n)));
+    ASSERT_EQ(s.dump(), json(n).dump());
+  }
+  const int64_t integers[] = {std::numeric_limits<int64_t>::min(),
+                              std::numeric_limits<int64_t>::max(), 0};
+  for (auto i : integers) {
+    dap::json::Serializer s;
+    ASSERT_TRUE(s.serialize(dap::integer(i)));
+    ASSERT_EQ(s.dump(), json(i).dump());
+  }
+}
+
+TEST_F(JSONSerializer, NlohmannWriterInvalidUTF8) {
+  // dump() aborts on invalid UTF-8 without exceptions, so compare with its
+  // replace error handler, which the writer matches.
+  const char* strings[] = {"a\xff" "b",    "\xc3",         "\xe2\x82" "a",
+                           "\xed\xa0\x80", "\xf0\x9f\x98", "\xc0\xaf\n",
+                           "\xf4\x90\x80\x80" "ok"};
+  for (auto str : strings) {
+    dap::json::Serializer s;
+    ASSERT_TRUE(s.object([&](dap::FieldSerializer* fs) {
+      return fs->field(str, dap::string(str));
+    }));
+    nlohmann::json j = nlohmann::json::object();
+    j[str] = str;
+    ASSERT_EQ(s.dump(), j.dump(-1, ' ', false,
+                               nlohmann::json::error_handler_t::replace));
+  }
+}
+
+#endif  // defined(CPPDAP_JSON_NLOHMANN)
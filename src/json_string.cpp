@@ -0,0 +1,861 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "json_string.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define CPPDAP_JSON_STRING_SSE2 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CPPDAP_JSON_STRING_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+const char kHex[] = "0123456789abcdef";
+
+// kReplacement is the UTF-8 encoding of U+FFFD, the replacement character.
+const char kReplacement[] = "\xef\xbf\xbd";
+
+// isSpecial() returns true if c must be escaped in a JSON string, or, if
+// kNonASCII is true, is part of a multi-byte UTF-8 sequence, which must be
+// validated.
+template <bool kNonASCII>
+inline bool isSpecial(uint8_t c) {
+  return c < 0x20 || c == '"' || c == '\\' || (kNonASCII && c >= 0x80);
+}
+
+// scanSpecialScalar() returns the index of the first special byte of the size
+// bytes at s, or size if there are none.
+template <bool kNonASCII>
+size_t scanSpecialScalar(const uint8_t* s, size_t size) {
+  size_t i = 0;
+  while (i < size && !isSpecial<kNonASCII>(s[i])) {
+    i++;
+  }
+  return i;
+}
+
+// scanNonASCIIScalar() returns the index of the first byte of the size bytes
+// at s that is not ASCII, or size if there are none.
+size_t scanNonASCIIScalar(const uint8_t* s, size_t size) {
+  size_t i = 0;
+  while (i < size && s[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+#if defined(CPPDAP_JSON_STRING_SSE2) || defined(CPPDAP_JSON_STRING_NEON)
+
+// The tables of the vectorized UTF-8 validation, which follows Keiser and
+// Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte". Each pair
+// of adjacent bytes is looked up by the high and low nibbles of the first byte
+// and the high nibble of the second, and the three results are ANDed, leaving
+// a bit set for each error the pair holds. kTwoConts is expected for the
+// continuation bytes that follow a continuation byte, which are checked
+// against the lead bytes two and three bytes earlier.
+const uint8_t kTooShort = 1 << 0;  // a lead byte not followed by continuation
+const uint8_t kTooLong = 1 << 1;   // ASCII followed by a continuation byte
+const uint8_t kOverlong3 = 1 << 2;
+const uint8_t kTooLarge = 1 << 3;  // above U+10FFFF
+const uint8_t kSurrogate = 1 << 4;
+const uint8_t kOverlong2 = 1 << 5;
+const uint8_t kTooLarge1000 = 1 << 6;
+const uint8_t kOverlong4 = 1 << 6;
+const uint8_t kTwoConts = 1 << 7;
+const uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+// kByte1High is indexed by the high nibble of the first byte.
+const uint8_t kByte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong,      // ASCII
+    kTooLong, kTooLong, kTooLong, kTooLong,      // ASCII
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,  // continuation
+    kTooShort | kOverlong2,                      // 1100____
+    kTooShort,                                   // 1101____
+    kTooShort | kOverlong3 | kSurrogate,         // 1110____
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,  // 1111____
+};
+
+// kByte1Low is indexed by the low nibble of the first byte.
+const uint8_t kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,  // ____0000
+    kCarry | kOverlong2,                            // ____0001
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,                   // ____0100
+    kCarry | kTooLarge | kTooLarge1000,   // ____0101
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,  // ____1101
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+// kByte2High is indexed by the high nibble of the second byte.
+const uint8_t kByte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort,  // ASCII
+    kTooShort, kTooShort, kTooShort, kTooShort,  // ASCII
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 |
+        kOverlong4,                                               // 1000____
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,  // 1001____
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,  // 1010____
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,  // 1011____
+    kTooShort, kTooShort, kTooShort, kTooShort,  // lead byte
+};
+
+// kIncomplete holds the largest values of the last three bytes of a block
+// that do not start a sequence continuing into the next block. A saturating
+// subtraction of kIncomplete from a block is non-zero if it ends with an
+// incomplete sequence.
+const uint8_t kIncomplete[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf,
+};
+
+#endif  // CPPDAP_JSON_STRING_SSE2 || CPPDAP_JSON_STRING_NEON
+
+#ifdef CPPDAP_JSON_STRING_SSE2
+
+#define CPPDAP_TARGET_AVX2 __attribute__((target("avx2")))
+
+// kMinAVX2Size is the minimum number of bytes scanned with AVX2. Shorter
+// strings, such as most names and paths, are faster to scan with SSE2.
+const size_t kMinAVX2Size = 256;
+
+bool hasAVX2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+template <bool kNonASCII>
+size_t scanSpecialSSE2(const uint8_t* s, size_t size) {
+  const __m128i control = _mm_set1_epi8(0x1f);
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    // max(v, 0x1f) == 0x1f only for bytes below 0x20. Bytes with the top bit
+    // set are marked for the movemask by v itself.
+    auto special = _mm_or_si128(
+        _mm_cmpeq_epi8(_mm_max_epu8(v, control), control),
+        _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)));
+    if (kNonASCII) {
+      special = _mm_or_si128(special, v);
+    }
+    if (auto mask = _mm_movemask_epi8(special)) {
+      return i + __builtin_ctz(static_cast<uint32_t>(mask));
+    }
+  }
+  return i + scanSpecialScalar<kNonASCII>(s + i, size - i);
+}
+
+size_t scanNonASCIISSE2(const uint8_t* s, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    if (auto mask = _mm_movemask_epi8(v)) {
+      return i + __builtin_ctz(static_cast<uint32_t>(mask));
+    }
+  }
+  return i + scanNonASCIIScalar(s + i, size - i);
+}
+
+CPPDAP_TARGET_AVX2 size_t scanNonASCIIAVX2(const uint8_t* s, size_t size) {
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    if (auto mask = _mm256_movemask_epi8(v)) {
+      return i + __builtin_ctz(static_cast<uint32_t>(mask));
+    }
+  }
+  return i + scanNonASCIISSE2(s + i, size - i);
+}
+
+// prevAVX2() returns the bytes of the block input moved N bytes later, with
+// the last N bytes of the previous block prev moved in.
+template <int N>
+CPPDAP_TARGET_AVX2 inline __m256i prevAVX2(__m256i input, __m256i prev) {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+// lookupAVX2() returns the entries of table indexed by the nibbles of index.
+CPPDAP_TARGET_AVX2 inline __m256i lookupAVX2(const uint8_t* table,
+                                             __m256i index) {
+  auto t = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+  return _mm256_shuffle_epi8(t, index);
+}
+
+CPPDAP_TARGET_AVX2 bool validUTF8AVX2(const uint8_t* s, size_t size) {
+  const auto nibble = _mm256_set1_epi8(0x0f);
+  const auto incomplete =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kIncomplete));
+  auto error = _mm256_setzero_si256();
+  auto prev = _mm256_setzero_si256();
+  for (size_t i = 0;; i += 32) {
+    // The last block is padded with ASCII, so that a sequence cut short by
+    // the end of the input is reported as too short.
+    bool last = i + 32 > size;
+    __m256i input;
+    if (!last) {
+      input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    } else {
+      uint8_t tail[32] = {};
+      memcpy(tail, s + i, size - i);
+      input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail));
+    }
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = _mm256_or_si256(error, _mm256_subs_epu8(prev, incomplete));
+    } else {
+      auto prev1 = prevAVX2<1>(input, prev);
+      auto special = _mm256_and_si256(
+          _mm256_and_si256(
+              lookupAVX2(kByte1High, _mm256_and_si256(
+                                         _mm256_srli_epi16(prev1, 4), nibble)),
+              lookupAVX2(kByte1Low, _mm256_and_si256(prev1, nibble))),
+          lookupAVX2(kByte2High,
+                     _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+      // The third and fourth bytes of a sequence are the continuation bytes
+      // that must follow a continuation byte.
+      auto must23 = _mm256_or_si256(
+          _mm256_subs_epu8(prevAVX2<2>(input, prev), _mm256_set1_epi8(0x60)),
+          _mm256_subs_epu8(prevAVX2<3>(input, prev), _mm256_set1_epi8(0x70)));
+      must23 = _mm256_and_si256(must23, _mm256_set1_epi8(char(0x80)));
+      error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+    }
+    prev = input;
+    if (last) {
+      break;
+    }
+  }
+  return _mm256_testz_si256(error, error);
+}
+
+#endif  // CPPDAP_JSON_STRING_SSE2
+
+#ifdef CPPDAP_JSON_STRING_NEON
+
+// firstSet() returns the index of the first non-zero byte of v, which must
+// have at least one. The narrowing shift packs each byte of v into 4 bits.
+inline size_t firstSet(uint8x16_t v) {
+  auto packed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+  auto mask = vget_lane_u64(vreinterpret_u64_u8(packed), 0);
+  return __builtin_ctzll(mask) / 4;
+}
+
+template <bool kNonASCII>
+size_t scanSpecialNEON(const uint8_t* s, size_t size) {
+  const uint8x16_t control = vdupq_n_u8(0x20);
+  const uint8x16_t ascii = vdupq_n_u8(0x80);
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    auto v = vld1q_u8(s + i);
+    auto special = vorrq_u8(vcltq_u8(v, control),
+                            vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)));
+    if (kNonASCII) {
+      special = vorrq_u8(special, vcgeq_u8(v, ascii));
+    }
+    if (vmaxvq_u8(special)) {
+      return i + firstSet(special);
+    }
+  }
+  return i + scanSpecialScalar<kNonASCII>(s + i, size - i);
+}
+
+size_t scanNonASCIINEON(const uint8_t* s, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    auto v = vld1q_u8(s + i);
+    if (vmaxvq_u8(v) >= 0x80) {
+      return i + firstSet(vcgeq_u8(v, vdupq_n_u8(0x80)));
+    }
+  }
+  return i + scanNonASCIIScalar(s + i, size - i);
+}
+
+bool validUTF8NEON(const uint8_t* s, size_t size) {
+  const auto byte1High = vld1q_u8(kByte1High);
+  const auto byte1Low = vld1q_u8(kByte1Low);
+  const auto byte2High = vld1q_u8(kByte2High);
+  const auto nibble = vdupq_n_u8(0x0f);
+  const auto incomplete = vld1q_u8(kIncomplete + 16);
+  auto error = vdupq_n_u8(0);
+  auto prev = vdupq_n_u8(0);
+  for (size_t i = 0;; i += 16) {
+    // The last block is padded with ASCII, so that a sequence cut short by
+    // the end of the input is reported as too short.
+    bool last = i + 16 > size;
+    uint8x16_t input;
+    if (!last) {
+      input = vld1q_u8(s + i);
+    } else {
+      uint8_t tail[16] = {};
+      memcpy(tail, s + i, size - i);
+      input = vld1q_u8(tail);
+    }
+    if (vmaxvq_u8(input) < 0x80) {
+      error = vorrq_u8(error, vqsubq_u8(prev, incomplete));
+    } else {
+      auto prev1 = vextq_u8(prev, input, 15);
+      auto special = vandq_u8(
+          vandq_u8(vqtbl1q_u8(byte1High, vshrq_n_u8(prev1, 4)),
+                   vqtbl1q_u8(byte1Low, vandq_u8(prev1, nibble))),
+          vqtbl1q_u8(byte2High, vshrq_n_u8(input, 4)));
+      // The third and fourth bytes of a sequence are the continuation bytes
+      // that must follow a continuation byte.
+      auto must23 =
+          vorrq_u8(vqsubq_u8(vextq_u8(prev, input, 14), vdupq_n_u8(0x60)),
+                   vqsubq_u8(vextq_u8(prev, input, 13), vdupq_n_u8(0x70)));
+      must23 = vandq_u8(must23, vdupq_n_u8(0x80));
+      error = vorrq_u8(error, veorq_u8(must23, special));
+    }
+    prev = input;
+    if (last) {
+      break;
+    }
+  }
+  return vmaxvq_u8(error) == 0;
+}
+
+#endif  // CPPDAP_JSON_STRING_NEON
+
+// scanSpecial() returns the index of the first special byte of the size bytes
+// at s, or size if there are none. See isSpecial().
+template <bool kNonASCII>
+size_t scanSpecial(const uint8_t* s, size_t size) {
+#if defined(CPPDAP_JSON_STRING_SSE2)
+  // Characters that need escaping are frequent in program output, so the runs
+  // between them are too short to benefit from AVX2.
+  return scanSpecialSSE2<kNonASCII>(s, size);
+#elif defined(CPPDAP_JSON_STRING_NEON)
+  return scanSpecialNEON<kNonASCII>(s, size);
+#else
+  return scanSpecialScalar<kNonASCII>(s, size);
+#endif
+}
+
+// scanNonASCII() returns the index of the first byte of the size bytes at s
+// that is not ASCII, or size if there are none.
+size_t scanNonASCII(const uint8_t* s, size_t size) {
+#if defined(CPPDAP_JSON_STRING_SSE2)
+  if (size >= kMinAVX2Size && hasAVX2()) {
+    return scanNonASCIIAVX2(s, size);
+  }
+  return scanNonASCIISSE2(s, size);
+#elif defined(CPPDAP_JSON_STRING_NEON)
+  return scanNonASCIINEON(s, size);
+#else
+  return scanNonASCIIScalar(s, size);
+#endif
+}
+
+// sequenceLength() returns the length of the UTF-8 multi-byte sequence at the
+// start of the size bytes at s, assigning valid to whether it is valid. The
+// length of an invalid sequence is the length of its longest prefix that can
+// start a valid sequence, or 1 if there is none.
+size_t sequenceLength(const uint8_t* s, size_t size, bool* valid) {
+  *valid = false;
+  auto c = s[0];
+  size_t n = 0;
+  uint8_t lo = 0x80, hi = 0xbf;
+  if (c >= 0xc2 && c <= 0xdf) {
+    n = 2;
+  } else if (c >= 0xe0 && c <= 0xef) {
+    n = 3;
+    lo = c == 0xe0 ? 0xa0 : 0x80;  // Overlong.
+    hi = c == 0xed ? 0x9f : 0xbf;  // Surrogates.
+  } else if (c >= 0xf0 && c <= 0xf4) {
+    n = 4;
+    lo = c == 0xf0 ? 0x90 : 0x80;  // Overlong.
+    hi = c == 0xf4 ? 0x8f : 0xbf;  // Above U+10FFFF.
+  } else {
+    return 1;
+  }
+  if (size < 2 || s[1] < lo || s[1] > hi) {
+    return 1;
+  }
+  for (size_t i = 2; i < n; i++) {
+    if (i == size || s[i] < 0x80 || s[i] > 0xbf) {
+      return i;
+    }
+  }
+  *valid = true;
+  return n;
+}
+
+// validUTF8Scalar() returns true if the size bytes at s are valid UTF-8,
+// skipping ASCII with the vector scan.
+bool validUTF8Scalar(const uint8_t* s, size_t size) {
+  size_t i = 0;
+  while (i < size) {
+    i += scanNonASCII(s + i, size - i);
+    if (i == size) {
+      break;
+    }
+    bool valid = false;
+    i += sequenceLength(s + i, size - i, &valid);
+    if (!valid) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// isValidUTF8() returns true if the size bytes at s are valid UTF-8. ASCII is
+// skipped with the scan, and the rest is validated with the vector kernels
+// where the CPU has them.
+bool isValidUTF8(const uint8_t* s, size_t size) {
+  auto i = scanNonASCII(s, size);
+  if (i == size) {
+    return true;
+  }
+#if defined(CPPDAP_JSON_STRING_SSE2)
+  if (hasAVX2()) {
+    return validUTF8AVX2(s + i, size - i);
+  }
+#elif defined(CPPDAP_JSON_STRING_NEON)
+  return validUTF8NEON(s + i, size - i);
+#endif
+  return validUTF8Scalar(s + i, size - i);
+}
+
+// Scanner finds the bytes of JSON string bodies that need handling: quotes,
+// backslashes, control characters and non-ASCII bytes. The first time a
+// non-ASCII byte is found, the rest of the input is validated with the vector
+// kernels, and if it is valid UTF-8, non-ASCII bytes are no longer stopped
+// at, so that text in other scripts stays on the vector scan.
+class Scanner {
+ public:
+  Scanner(const uint8_t* s, size_t size) : s(s), size(size) {}
+
+  // next() returns the index of the next byte at or after i that needs
+  // handling, or size if there are none.
+  size_t next(size_t i) const {
+    return i + (utf8 ? scanSpecial<false>(s + i, size - i)
+                     : scanSpecial<true>(s + i, size - i));
+  }
+
+  // sequence() returns the length of the UTF-8 sequence that starts with the
+  // non-ASCII byte at i, assigning valid to whether it is valid. See
+  // sequenceLength().
+  size_t sequence(size_t i, bool* valid) {
+    if (!checked) {
+      checked = true;
+      utf8 = isValidUTF8(s + i, size - i);
+    }
+    return sequenceLength(s + i, size - i, valid);
+  }
+
+  const uint8_t* const s;
+  const size_t size;
+
+ private:
+  bool checked = false;  // the rest of the input has been validated
+  bool utf8 = false;     // the rest of the input is valid UTF-8
+};
+
+// hexValue() returns the value of the 4 hexadecimal digits at s, or -1 if
+// they are not all hexadecimal digits.
+int32_t hexValue(const uint8_t* s) {
+  int32_t v = 0;
+  for (int i = 0; i < 4; i++) {
+    auto c = s[i];
+    int32_t d;
+    if (c >= '0' && c <= '9') {
+      d = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      d = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      d = c - 'A' + 10;
+    } else {
+      return -1;
+    }
+    v = (v << 4) | d;
+  }
+  return v;
+}
+
+// appendUTF8() appends the UTF-8 encoding of the code point cp to out.
+void appendUTF8(uint32_t cp, std::string* out) {
+  if (cp < 0x80) {
+    out->push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out->push_back(static_cast<char>(0xc0 | (cp >> 6)));
+    out->push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else if (cp < 0x10000) {
+    out->push_back(static_cast<char>(0xe0 | (cp >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    out->push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else {
+    out->push_back(static_cast<char>(0xf0 | (cp >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+    out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    out->push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  }
+}
+
+// unescape() decodes the JSON string body starting at index *i of the
+// scanner's input, up to its closing quote or the end of the input, and
+// assigns *i to the index it stopped at. The decoded body is appended to out,
+// unless out is null. Returns false if the body contains a control character,
+// an invalid escape sequence, or is not valid UTF-8.
+bool unescape(Scanner& scanner, size_t* index, std::string* out) {
+  auto s = scanner.s;
+  auto size = scanner.size;
+  auto str = reinterpret_cast<const char*>(s);
+  size_t i = *index;
+  bool ok = false;
+  while (true) {
+    size_t n = scanner.next(i);
+    if (out) {
+      out->append(str + i, n - i);
+    }
+    i = n;
+    if (i == size || s[i] == '"') {
+      ok = true;
+      break;
+    }
+    if (s[i] >= 0x80) {
+      bool valid = false;
+      n = scanner.sequence(i, &valid);
+      if (!valid) {
+        break;
+      }
+      if (out) {
+        out->append(str + i, n);
+      }
+      i += n;
+      continue;
+    }
+    if (s[i] != '\\' || i + 1 == size) {
+      break;
+    }
+    auto c = s[i + 1];
+    i += 2;
+    char decoded = 0;
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        decoded = static_cast<char>(c);
+        break;
+      case 'b':
+        decoded = '\b';
+        break;
+      case 'f':
+        decoded = '\f';
+        break;
+      case 'n':
+        decoded = '\n';
+        break;
+      case 'r':
+        decoded = '\r';
+        break;
+      case 't':
+        decoded = '\t';
+        break;
+      case 'u': {
+        int32_t cp = size - i >= 4 ? hexValue(s + i) : -1;
+        if (cp < 0 || (cp >= 0xdc00 && cp <= 0xdfff)) {
+          *index = i;
+          return false;
+        }
+        i += 4;
+        if (cp >= 0xd800 && cp <= 0xdbff) {
+          // A high surrogate must be followed by an escaped low surrogate.
+          int32_t low = size - i >= 6 && s[i] == '\\' && s[i + 1] == 'u'
+                            ? hexValue(s + i + 2)
+                            : -1;
+          if (low < 0xdc00 || low > 0xdfff) {
+            *index = i;
+            return false;
+          }
+          i += 6;
+          cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+        }
+        if (out) {
+          appendUTF8(static_cast<uint32_t>(cp), out);
+        }
+        continue;
+      }
+      default:
+        *index = i;
+        return false;
+    }
+    if (out) {
+      out->push_back(decoded);
+    }
+  }
+  *index = i;
+  return ok;
+}
+
+// Reader reads the JSON text of readMembers().
+class Reader {
+ public:
+  Reader(const uint8_t* s, size_t size) : scanner(s, size) {}
+
+  // pos() returns the index of the next byte to read.
+  size_t pos() const { return i; }
+
+  // done() returns true if all of the input has been read.
+  bool done() const { return i == scanner.size; }
+
+  // skipWhitespace() skips the JSON whitespace at the current position.
+  void skipWhitespace() {
+    while (i < scanner.size) {
+      auto c = scanner.s[i];
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+        break;
+      }
+      i++;
+    }
+  }
+
+  // consume() skips the byte c, returning false if the next byte is not c.
+  bool consume(char c) {
+    if (i == scanner.size || scanner.s[i] != static_cast<uint8_t>(c)) {
+      return false;
+    }
+    i++;
+    return true;
+  }
+
+  // string() reads the JSON string at the current position, appending its
+  // decoded value to out, unless out is null.
+  bool string(std::string* out) {
+    return consume('"') && unescape(scanner, &i, out) && consume('"');
+  }
+
+  // value() skips the JSON value at the current position.
+  bool value() {
+    if (done()) {
+      return false;
+    }
+    switch (scanner.s[i]) {
+      case '"':
+        return string(nullptr);
+      case '{':
+      case '[':
+        return container();
+      default:
+        return scalar();
+    }
+  }
+
+ private:
+  // container() skips the JSON object or array at the current position,
+  // checking the strings it holds, and that its brackets are balanced.
+  bool container() {
+    int depth = 0;
+    do {
+      if (done()) {
+        return false;
+      }
+      switch (scanner.s[i]) {
+        case '"':
+          if (!string(nullptr)) {
+            return false;
+          }
+          continue;
+        case '{':
+        case '[':
+          depth++;
+          break;
+        case '}':
+        case ']':
+          depth--;
+          break;
+        default:
+          break;
+      }
+      i++;
+    } while (depth > 0);
+    return true;
+  }
+
+  // scalar() skips the JSON number or literal at the current position.
+  bool scalar() {
+    auto start = i;
+    while (i < scanner.size) {
+      auto c = scanner.s[i];
+      if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' ||
+          c == '\n' || c == '\r') {
+        break;
+      }
+      if (isSpecial<true>(c) || c == ':' || c == '{' || c == '[') {
+        return false;
+      }
+      i++;
+    }
+    return i > start;
+  }
+
+  Scanner scanner;
+  size_t i = 0;
+};
+
+}  // anonymous namespace
+
+namespace dap {
+namespace json {
+
+void escapeString(const char* str, size_t size, std::string* out) {
+  Scanner scanner(reinterpret_cast<const uint8_t*>(str), size);
+  auto s = scanner.s;
+  size_t i = 0;
+  while (i < size) {
+    size_t n = scanner.next(i);
+    out->append(str + i, n - i);
+    i = n;
+    if (i == size) {
+      break;
+    }
+    auto c = s[i];
+    if (c >= 0x80) {
+      bool valid = false;
+      n = scanner.sequence(i, &valid);
+      if (valid) {
+        out->append(str + i, n);
+      } else {
+        out->append(kReplacement, 3);
+      }
+      i += n;
+      continue;
+    }
+    i++;
+    char escaped[6] = {'\\', 0, 0, 0, 0, 0};
+    size_t len = 2;
+    switch (c) {
+      case '"':
+      case '\\':
+        escaped[1] = static_cast<char>(c);
+        break;
+      case '\b':
+        escaped[1] = 'b';
+        break;
+      case '\f':
+        escaped[1] = 'f';
+        break;
+      case '\n':
+        escaped[1] = 'n';
+        break;
+      case '\r':
+        escaped[1] = 'r';
+        break;
+      case '\t':
+        escaped[1] = 't';
+        break;
+      default:
+        escaped[1] = 'u';
+        escaped[2] = '0';
+        escaped[3] = '0';
+        escaped[4] = kHex[c >> 4];
+        escaped[5] = kHex[c & 15];
+        len = 6;
+        break;
+    }
+    out->append(escaped, len);
+  }
+}
+
+bool unescapeString(const char* str, size_t size, std::string* out) {
+  Scanner scanner(reinterpret_cast<const uint8_t*>(str), size);
+  size_t i = 0;
+  return unescape(scanner, &i, out) && i == size;
+}
+
+bool validUTF8(const char* str, size_t size) {
+  return isValidUTF8(reinterpret_cast<const uint8_t*>(str), size);
+}
+
+void replaceInvalidUTF8(std::string* str) {
+  auto s = reinterpret_cast<const uint8_t*>(str->data());
+  auto size = str->size();
+  auto i = scanNonASCII(s, size);
+  if (i == size || isValidUTF8(s + i, size - i)) {
+    return;
+  }
+  std::string out(str->data(), i);
+  while (i < size) {
+    bool valid = false;
+    auto n = sequenceLength(s + i, size - i, &valid);
+    if (valid) {
+      out.append(str->data() + i, n);
+    } else {
+      out.append(kReplacement, 3);
+    }
+    i += n;
+    n = scanNonASCII(s + i, size - i);
+    out.append(str->data() + i, n);
+    i += n;
+  }
+  str->swap(out);
+}
+
+bool readMembers(const char* str, size_t size, const MemberCallback& cb) {
+  Reader reader(reinterpret_cast<const uint8_t*>(str), size);
+  reader.skipWhitespace();
+  if (!reader.consume('{')) {
+    return false;
+  }
+  reader.skipWhitespace();
+  if (!reader.consume('}')) {
+    std::string name;
+    do {
+      reader.skipWhitespace();
+      name.clear();
+      if (!reader.string(&name)) {
+        return false;
+      }
+      reader.skipWhitespace();
+      if (!reader.consume(':')) {
+        return false;
+      }
+      reader.skipWhitespace();
+      auto start = reader.pos();
+      if (!reader.value()) {
+        return false;
+      }
+      if (!cb(name, str + start, reader.pos() - start)) {
+        return true;
+      }
+      reader.skipWhitespace();
+    } while (reader.consume(','));
+    if (!reader.consume('}')) {
+      return false;
+    }
+  }
+  reader.skipWhitespace();
+  return reader.done();
+}
+
+}  // namespace json
+}  // namespace dap
@@ -0,0 +1,62 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_json_string_h
+#define dap_json_string_h
+
+#include <stddef.h>
+#include <functional>
+#include <string>
+
+namespace dap {
+namespace json {
+
+// escapeString() appends the size bytes at str to out as the body of a JSON
+// string, without the surrounding quotes. Quotes, backslashes and control
+// characters are escaped in the same way as nlohmann::json::dump(), and all
+// other characters are copied verbatim. Invalid UTF-8 is replaced with one
+// U+FFFD for each maximal invalid subsequence, as done by the replace error
+// handler of nlohmann::json::dump().
+void escapeString(const char* str, size_t size, std::string* out);
+
+// unescapeString() appends the decoded body of the JSON string at str to out,
+// where str excludes the surrounding quotes. Returns false if str contains
+// an unescaped quote or control character, an invalid escape sequence, or is
+// not valid UTF-8.
+bool unescapeString(const char* str, size_t size, std::string* out);
+
+// validUTF8() returns true if the size bytes at str are valid UTF-8.
+bool validUTF8(const char* str, size_t size);
+
+// replaceInvalidUTF8() replaces invalid UTF-8 in str with U+FFFD, in the same
+// way as escapeString(). Valid text is checked without being copied.
+void replaceInvalidUTF8(std::string* str);
+
+// MemberCallback is called by readMembers() with the decoded name of a member
+// of a JSON object, and the JSON text of its value. Returning false stops
+// reading the object.
+using MemberCallback =
+    std::function<bool(const std::string& name, const char* value, size_t size)>;
+
+// readMembers() calls cb with each member of the JSON object text at str, in
+// order, without decoding the member values. Strings are fully checked, but
+// numbers and literals are only delimited, and nested objects and arrays are
+// only checked for balanced brackets. Returns false if str is not a JSON
+// object.
+bool readMembers(const char* str, size_t size, const MemberCallback& cb);
+
+}  // namespace json
+}  // namespace dap
+
+#endif  // dap_json_string_h
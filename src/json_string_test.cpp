@@ -0,0 +1,309 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "json_string.h"
+#include "json_serializer.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::string escape(const std::string& str) {
+  std::string out;
+  dap::json::escapeString(str.data(), str.size(), &out);
+  return out;
+}
+
+bool unescape(const std::string& str, std::string* out) {
+  out->clear();
+  return dap::json::unescapeString(str.data(), str.size(), out);
+}
+
+bool valid(const std::string& str) {
+  return dap::json::validUTF8(str.data(), str.size());
+}
+
+// validReference() is a bytewise UTF-8 validator, to check validUTF8()
+// against.
+bool validReference(const std::string& str) {
+  auto s = reinterpret_cast<const uint8_t*>(str.data());
+  size_t i = 0;
+  while (i < str.size()) {
+    uint32_t c = s[i];
+    size_t n = c < 0x80 ? 1 : c < 0xc0 ? 0 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+    if (n == 0 || c > 0xf4 || i + n > str.size()) {
+      return false;
+    }
+    uint32_t cp = n == 1 ? c : c & (0x7f >> n);
+    for (size_t j = 1; j < n; j++) {
+      if ((s[i + j] & 0xc0) != 0x80) {
+        return false;
+      }
+      cp = (cp << 6) | (s[i + j] & 0x3f);
+    }
+    const uint32_t min[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < min[n] || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) {
+      return false;
+    }
+    i += n;
+  }
+  return true;
+}
+
+using Members = std::vector<std::pair<std::string, std::string>>;
+
+bool members(const std::string& json, Members* out) {
+  out->clear();
+  return dap::json::readMembers(
+      json.data(), json.size(),
+      [&](const std::string& name, const char* value, size_t size) {
+        out->emplace_back(name, std::string(value, size));
+        return true;
+      });
+}
+
+}  // anonymous namespace
+
+TEST(JSONString, Escape) {
+  ASSERT_EQ(escape(""), "");
+  ASSERT_EQ(escape("hello world"), "hello world");
+  ASSERT_EQ(escape("\"quoted\" \\ path/to"), "\\\"quoted\\\" \\\\ path/to");
+  ASSERT_EQ(escape("\b\f\n\r\t"), "\\b\\f\\n\\r\\t");
+  ASSERT_EQ(escape(std::string("\0\x01\x1f\x7f", 4)),
+            "\\u0000\\u0001\\u001f\x7f");
+  ASSERT_EQ(escape("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80"),
+            "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80");
+}
+
+TEST(JSONString, EscapeInvalidUTF8) {
+  ASSERT_EQ(escape("a\xff" "b"), "a\xef\xbf\xbd" "b");
+  ASSERT_EQ(escape("\xc3"), "\xef\xbf\xbd");
+  ASSERT_EQ(escape("\xc0\xaf\n"), "\xef\xbf\xbd\xef\xbf\xbd\\n");
+  // A truncated sequence is replaced once, and an out of range continuation
+  // byte is replaced on its own.
+  ASSERT_EQ(escape("\xe2\x82" "a"), "\xef\xbf\xbd" "a");
+  ASSERT_EQ(escape("\xed\xa0\x80"),
+            "\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd");
+  ASSERT_EQ(escape("\xf0\x9f\x98"), "\xef\xbf\xbd");
+}
+
+TEST(JSONString, EscapeNonASCII) {
+  // Long valid UTF-8 text is scanned without stopping at each non-ASCII
+  // character, so check that escapes and invalid bytes are still found.
+  std::string str, expect;
+  for (int i = 0; i < 200; i++) {
+    str += "\xd0\x9f\xd1\x80\xd0\xb8\xe2\x82\xac\xf0\x9f\x98\x80";
+    expect += "\xd0\x9f\xd1\x80\xd0\xb8\xe2\x82\xac\xf0\x9f\x98\x80";
+    if (i % 7 == 0) {
+      str += "\"\n";
+      expect += "\\\"\\n";
+    }
+  }
+  ASSERT_EQ(escape(str), expect);
+  ASSERT_EQ(escape(str + "\xff"), expect + "\xef\xbf\xbd");
+}
+
+TEST(JSONString, EscapeEveryOffset) {
+  // Place a special character at each position of strings long enough to
+  // cover the vector blocks and the scalar tails.
+  for (size_t size = 1; size < 80; size++) {
+    for (size_t i = 0; i < size; i++) {
+      std::string str(size, 'x');
+      str[i] = '\n';
+      std::string expect(size + 1, 'x');
+      expect[i] = '\\';
+      expect[i + 1] = 'n';
+      ASSERT_EQ(escape(str), expect) << "size: " << size << " i: " << i;
+    }
+  }
+}
+
+TEST(JSONString, Unescape) {
+  std::string out;
+  ASSERT_TRUE(unescape("", &out));
+  ASSERT_EQ(out, "");
+  ASSERT_TRUE(unescape("hello world", &out));
+  ASSERT_EQ(out, "hello world");
+  ASSERT_TRUE(unescape("\\\"\\\\\\/\\b\\f\\n\\r\\t", &out));
+  ASSERT_EQ(out, "\"\\/\b\f\n\r\t");
+  ASSERT_TRUE(unescape("\\u0041\\u00e9\\u20AC\\ud83d\\ude00", &out));
+  ASSERT_EQ(out, "A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+  ASSERT_TRUE(unescape("\\u0000", &out));
+  ASSERT_EQ(out, std::string(1, '\0'));
+}
+
+TEST(JSONString, UnescapeInvalid) {
+  std::string out;
+  ASSERT_FALSE(unescape("\"", &out));
+  ASSERT_FALSE(unescape("\n", &out));
+  ASSERT_FALSE(unescape("\\", &out));
+  ASSERT_FALSE(unescape("\\x", &out));
+  ASSERT_FALSE(unescape("\\u12", &out));
+  ASSERT_FALSE(unescape("\\u12g4", &out));
+  ASSERT_FALSE(unescape("\\ud83d", &out));
+  ASSERT_FALSE(unescape("\\ud83d\\u0041", &out));
+  ASSERT_FALSE(unescape("\\ude00", &out));
+  ASSERT_FALSE(unescape("\xff", &out));
+  ASSERT_FALSE(unescape(std::string(100, '\xc3') + "\xa9", &out));
+}
+
+TEST(JSONString, RoundTrip) {
+  std::string str;
+  for (int i = 0; i < 1000; i++) {
+    str += static_cast<char>(i % 128);
+    str += "\xe2\x82\xac";
+  }
+  std::string out;
+  ASSERT_TRUE(unescape(escape(str), &out));
+  ASSERT_EQ(out, str);
+}
+
+TEST(JSONString, ValidUTF8) {
+  ASSERT_TRUE(valid(""));
+  ASSERT_TRUE(valid(std::string(100, 'a')));
+  ASSERT_TRUE(valid("\xc2\x80\xdf\xbf"));
+  ASSERT_TRUE(valid("\xe0\xa0\x80\xed\x9f\xbf\xef\xbf\xbf"));
+  ASSERT_TRUE(valid("\xf0\x90\x80\x80\xf4\x8f\xbf\xbf"));
+  ASSERT_FALSE(valid("\x80"));
+  ASSERT_FALSE(valid("\xc1\xbf"));              // Overlong.
+  ASSERT_FALSE(valid("\xe0\x9f\xbf"));          // Overlong.
+  ASSERT_FALSE(valid("\xf0\x8f\xbf\xbf"));      // Overlong.
+  ASSERT_FALSE(valid("\xed\xa0\x80"));          // Surrogate.
+  ASSERT_FALSE(valid("\xf4\x90\x80\x80"));      // Above U+10FFFF.
+  ASSERT_FALSE(valid("\xf5\x80\x80\x80"));      // Invalid lead byte.
+  ASSERT_FALSE(valid("\xc3\xa9\xa9"));          // Extra continuation.
+  ASSERT_FALSE(valid(std::string(40, 'a') + "\xe2\x82"));  // Truncated.
+}
+
+TEST(JSONString, ValidUTF8EveryOffset) {
+  // Place each sequence at every offset of text long enough to cover the
+  // vector blocks, their boundaries and the padded tail, after both ASCII and
+  // multi-byte text.
+  const std::pair<const char*, bool> sequences[] = {
+      {"\xc3\xa9", true},          {"\xe2\x82\xac", true},
+      {"\xf0\x9f\x98\x80", true},  {"\xf4\x8f\xbf\xbf", true},
+      {"\x80", false},              {"\xc3", false},
+      {"\xe2\x82", false},          {"\xf0\x9f\x98", false},
+      {"\xc0\x80", false},          {"\xe0\x80\x80", false},
+      {"\xed\xb0\x80", false},      {"\xf4\x90\x80\x80", false},
+      {"\xf8\x88\x80\x80", false}, {"\xc3\xa9\x80", false},
+  };
+  for (auto fill : {"a", "\xc3\xa9"}) {
+    std::string text;
+    while (text.size() < 100) {
+      text += fill;
+    }
+    for (auto& seq : sequences) {
+      for (size_t i = 0; i <= text.size(); i += strlen(fill)) {
+        auto str = text.substr(0, i) + seq.first + text.substr(i);
+        ASSERT_EQ(valid(str), seq.second) << "offset: " << i;
+        str = text.substr(0, i) + seq.first;
+        ASSERT_EQ(valid(str), seq.second) << "end offset: " << i;
+      }
+    }
+  }
+}
+
+TEST(JSONString, ValidUTF8Random) {
+  // Mutate valid text with random bytes, mostly around the multi-byte
+  // sequences.
+  std::mt19937 rng(1);
+  std::string text;
+  while (text.size() < 300) {
+    text += "ab\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+  }
+  const uint8_t bytes[] = {0x00, 0x41, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0,
+                           0xbf, 0xc0, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0,
+                           0xf4, 0xf5, 0xff};
+  for (int iteration = 0; iteration < 5000; iteration++) {
+    auto str = text.substr(0, rng() % text.size());
+    for (int i = rng() % 3; i > 0 && !str.empty(); i--) {
+      str[rng() % str.size()] =
+          static_cast<char>(bytes[rng() % sizeof(bytes)]);
+    }
+    ASSERT_EQ(valid(str), validReference(str)) << "iteration: " << iteration;
+  }
+}
+
+TEST(JSONString, ReplaceInvalidUTF8) {
+  const char* strings[] = {"", "abc", "caf\xc3\xa9", "a\xff" "b",
+                           "\xe2\x82" "a\xed\xa0\x80", "\xf0\x9f\x98"};
+  for (auto str : strings) {
+    std::string got = str;
+    dap::json::replaceInvalidUTF8(&got);
+    ASSERT_EQ(got, escape(str));
+  }
+}
+
+TEST(JSONString, ReadMembers) {
+  Members got;
+  ASSERT_TRUE(members(
+      " { \"seq\" : 12, \"type\":\"request\", \"na\\u006de\": \"a\\\"}\",\n"
+      "\"body\": {\"a\": [1, \"]\", {}], \"b\": null}, \"ok\": true } ",
+      &got));
+  Members expect = {
+      {"seq", "12"},
+      {"type", "\"request\""},
+      {"name", "\"a\\\"}\""},
+      {"body", "{\"a\": [1, \"]\", {}], \"b\": null}"},
+      {"ok", "true"},
+  };
+  ASSERT_EQ(got, expect);
+  ASSERT_TRUE(members("{}", &got));
+  ASSERT_TRUE(got.empty());
+}
+
+TEST(JSONString, ReadMembersInvalid) {
+  Members got;
+  ASSERT_FALSE(members("", &got));
+  ASSERT_FALSE(members("[]", &got));
+  ASSERT_FALSE(members("{", &got));
+  ASSERT_FALSE(members("{\"a\"}", &got));
+  ASSERT_FALSE(members("{\"a\":}", &got));
+  ASSERT_FALSE(members("{\"a\":1,}", &got));
+  ASSERT_FALSE(members("{\"a\":1} x", &got));
+  ASSERT_FALSE(members("{\"a\":\"\xff\"}", &got));
+  ASSERT_FALSE(members("{\"a\":\"\n\"}", &got));
+  ASSERT_FALSE(members("{\"a\":[\"\\x\"]}", &got));
+  ASSERT_FALSE(members("{\"a\":{\"b\":1}", &got));
+}
+
+TEST(JSONString, ReadMembersStop) {
+  std::vector<std::string> names;
+  ASSERT_TRUE(dap::json::readMembers(
+      "{\"a\":1,\"b\":2,\"c\":3}", 19,
+      [&](const std::string& name, const char*, size_t) {
+        names.push_back(name);
+        return name != "b";
+      }));
+  ASSERT_EQ(names, std::vector<std::string>({"a", "b"}));
+}
+
+TEST(JSONString, Serializer) {
+  dap::json::Serializer s;
+  ASSERT_TRUE(s.object([&](dap::FieldSerializer* fs) {
+    return fs->field("output", dap::string("line 1\n\"quoted\"\t\x01"));
+  }));
+  dap::json::Deserializer d(s.dump());
+  dap::string output;
+  ASSERT_TRUE(d.field("output", &output));
+  ASSERT_EQ(output, "line 1\n\"quoted\"\t\x01");
+}
@@ -16,6 +16,10 @@
 
 #include "null_json_serializer.h"
 
+#include "dap/bytes.h"
+#include "dap/interned_string.h"
+#include "dap/raw_json.h"
+
 #include <json/json.h>
 #include <cstdlib>
 #include <memory>
@@ -23,11 +27,15 @@
 namespace dap {
 namespace json {
 
-JsonCppDeserializer::JsonCppDeserializer(const std::string& str)
-    : json(new Json::Value(JsonCppDeserializer::parse(str))), ownsJson(true) {}
+JsonCppDeserializer::JsonCppDeserializer(const std::string& str,
+                                         StringPool* pool /* = nullptr */)
+    : json(new Json::Value(JsonCppDeserializer::parse(str))),
+      ownsJson(true),
+      pool(pool) {}
 
-JsonCppDeserializer::JsonCppDeserializer(const Json::Value* json)
-    : json(json), ownsJson(false) {}
+JsonCppDeserializer::JsonCppDeserializer(const Json::Value* json,
+                                         StringPool* pool)
+    : json(json), ownsJson(false), pool(pool) {}
 
 JsonCppDeserializer::~JsonCppDeserializer() {
   if (ownsJson) {
@@ -35,6 +43,31 @@ JsonCppDeserializer::~JsonCppDeserializer() {
   }
 }
 
+dap::StringPool* JsonCppDeserializer::stringPool() const {
+  return pool;
+}
+
+dap::Deserializer::Kind JsonCppDeserializer::kind() const {
+  switch (json->type()) {
+    case Json::ValueType::nullValue:
+      return kNull;
+    case Json::ValueType::booleanValue:
+      return kBoolean;
+    case Json::ValueType::intValue:
+    case Json::ValueType::uintValue:
+      return kInteger;
+    case Json::ValueType::realValue:
+      return kNumber;
+    case Json::ValueType::stringValue:
+      return kString;
+    case Json::ValueType::arrayValue:
+      return kArray;
+    case Json::ValueType::objectValue:
+      return kObject;
+  }
+  return kUndefined;
+}
+
 bool JsonCppDeserializer::deserialize(dap::boolean* v) const {
   if (!json->isBool()) {
     return false;
@@ -67,10 +100,21 @@ bool JsonCppDeserializer::deserialize(dap::string* v) const {
   return true;
 }
 
+bool JsonCppDeserializer::deserialize(dap::interned_string* v) const {
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  if (!json->isString() || !json->getString(&begin, &end)) {
+    return false;
+  }
+  auto size = static_cast<size_t>(end - begin);
+  *v = pool ? pool->intern(begin, size) : dap::interned_string(begin, size);
+  return true;
+}
+
 bool JsonCppDeserializer::deserialize(dap::object* v) const {
   v->reserve(json->size());
   for (auto i = json->begin(); i != json->end(); i++) {
-    JsonCppDeserializer d(&*i);
+    JsonCppDeserializer d(&*i, pool);
     dap::any val;
     if (!d.deserialize(&val)) {
       return false;
@@ -111,6 +155,23 @@ bool JsonCppDeserializer::deserialize(dap::any* v) const {
   return true;
 }
 
+bool JsonCppDeserializer::deserialize(dap::raw_json* v) const {
+  Json::StreamWriterBuilder writer;
+  writer["indentation"] = "";
+  *v = dap::raw_json(Json::writeString(writer, *json));
+  return true;
+}
+
+bool JsonCppDeserializer::deserialize(dap::bytes* v) const {
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  if (!json->getString(&begin, &end)) {
+    return false;
+  }
+  v->clear();
+  return dap::base64Decode(begin, end - begin, v);
+}
+
 size_t JsonCppDeserializer::count() const {
   return json->size();
 }
@@ -121,7 +182,7 @@ bool JsonCppDeserializer::array(
     return false;
   }
   for (const auto& value : *json) {
-    JsonCppDeserializer d(&value);
+    JsonCppDeserializer d(&value, pool);
     if (!cb(&d)) {
       return false;
     }
@@ -139,7 +200,7 @@ bool JsonCppDeserializer::field(
   if (value == nullptr) {
     return cb(&NullDeserializer::instance);
   }
-  JsonCppDeserializer d(value);
+  JsonCppDeserializer d(value, pool);
   return cb(&d);
 }
 
@@ -231,6 +292,25 @@ bool JsonCppSerializer::serialize(const dap::any& v) {
   return true;
 }
 
+bool JsonCppSerializer::serialize(const dap::raw_json& v) {
+  Json::CharReaderBuilder builder;
+  auto jsonReader = std::unique_ptr<Json::CharReader>(builder.newCharReader());
+  auto& text = v.str();
+  Json::Value parsed;
+  std::string error;
+  if (!jsonReader->parse(text.data(), text.data() + text.size(), &parsed,
+                         &error)) {
+    return false;
+  }
+  json->swap(parsed);
+  return true;
+}
+
+bool JsonCppSerializer::serialize(const dap::bytes& v) {
+  *json = dap::base64Encode(v.data(), v.size());
+  return true;
+}
+
 bool JsonCppSerializer::array(size_t count,
                               const std::function<bool(dap::Serializer*)>& cb) {
   *json = Json::Value(Json::arrayValue);
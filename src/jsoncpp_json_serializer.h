@@ -25,16 +25,21 @@ namespace dap {
 namespace json {
 
 struct JsonCppDeserializer : public dap::Deserializer {
-  explicit JsonCppDeserializer(const std::string&);
+  explicit JsonCppDeserializer(const std::string&, StringPool* pool = nullptr);
   ~JsonCppDeserializer();
 
   // dap::Deserializer compliance
+  Kind kind() const override;
+  StringPool* stringPool() const override;
   bool deserialize(boolean* v) const override;
   bool deserialize(integer* v) const override;
   bool deserialize(number* v) const override;
   bool deserialize(string* v) const override;
   bool deserialize(object* v) const override;
   bool deserialize(any* v) const override;
+  bool deserialize(raw_json* v) const override;
+  bool deserialize(bytes* v) const override;
+  bool deserialize(interned_string* v) const override;
   size_t count() const override;
   bool array(const std::function<bool(dap::Deserializer*)>&) const override;
   bool field(const std::string& name,
@@ -73,10 +78,11 @@ struct JsonCppDeserializer : public dap::Deserializer {
   }
 
  private:
-  JsonCppDeserializer(const Json::Value*);
+  JsonCppDeserializer(const Json::Value*, StringPool* pool);
   static Json::Value parse(const std::string& text);
   const Json::Value* const json;
   const bool ownsJson;
+  StringPool* const pool;
 };
 
 struct JsonCppSerializer : public dap::Serializer {
@@ -92,6 +98,8 @@ struct JsonCppSerializer : public dap::Serializer {
   bool serialize(const string& v) override;
   bool serialize(const dap::object& v) override;
   bool serialize(const any& v) override;
+  bool serialize(const raw_json& v) override;
+  bool serialize(const bytes& v) override;
   bool array(size_t count,
              const std::function<bool(dap::Serializer*)>&) override;
   bool object(const std::function<bool(dap::FieldSerializer*)>&) override;
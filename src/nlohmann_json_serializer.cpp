@@ -14,22 +14,112 @@
 
 #include "nlohmann_json_serializer.h"
 
+#include "json_string.h"
 #include "null_json_serializer.h"
 
+#include "dap/bytes.h"
+#include "dap/interned_string.h"
+#include "dap/raw_json.h"
+
 // Disable JSON exceptions. We should be guarding against any exceptions being
 // fired in this file.
 #define JSON_NOEXCEPTION 1
 #include <nlohmann/json.hpp>
 
+#include <inttypes.h>
+#include <stdio.h>
+
+namespace {
+
+// write() appends the compact JSON text of j to out. This produces the same
+// output as nlohmann::json::dump(), but escapes strings with the vectorized
+// dap::json::escapeString(), and replaces invalid UTF-8 as dump() does with
+// its replace error handler, instead of aborting.
+// Binary values hold the text of serialized dap::raw_json values, which is
+// appended as is.
+void write(const nlohmann::json& j, std::string* out) {
+  switch (j.type()) {
+    case nlohmann::json::value_t::object: {
+      out->push_back('{');
+      bool first = true;
+      for (auto it = j.begin(); it != j.end(); ++it) {
+        if (!first) {
+          out->push_back(',');
+        }
+        first = false;
+        out->push_back('"');
+        auto& key = it.key();
+        dap::json::escapeString(key.data(), key.size(), out);
+        out->append("\":", 2);
+        write(it.value(), out);
+      }
+      out->push_back('}');
+      break;
+    }
+    case nlohmann::json::value_t::array: {
+      out->push_back('[');
+      bool first = true;
+      for (auto& el : j) {
+        if (!first) {
+          out->push_back(',');
+        }
+        first = false;
+        write(el, out);
+      }
+      out->push_back(']');
+      break;
+    }
+    case nlohmann::json::value_t::string: {
+      auto& str = j.get_ref<const nlohmann::json::string_t&>();
+      out->push_back('"');
+      dap::json::escapeString(str.data(), str.size(), out);
+      out->push_back('"');
+      break;
+    }
+    case nlohmann::json::value_t::binary: {
+      auto& raw = j.get_binary();
+      out->append(reinterpret_cast<const char*>(raw.data()), raw.size());
+      break;
+    }
+    case nlohmann::json::value_t::boolean:
+      out->append(j.get<bool>() ? "true" : "false");
+      break;
+    case nlohmann::json::value_t::null:
+      out->append("null", 4);
+      break;
+    case nlohmann::json::value_t::number_integer: {
+      char buf[24];
+      out->append(buf, snprintf(buf, sizeof(buf), "%" PRId64,
+                                j.get<int64_t>()));
+      break;
+    }
+    case nlohmann::json::value_t::number_unsigned: {
+      char buf[24];
+      out->append(buf, snprintf(buf, sizeof(buf), "%" PRIu64,
+                                j.get<uint64_t>()));
+      break;
+    }
+    default:
+      // Floating point numbers hold no strings, so keep nlohmann's formatting.
+      out->append(j.dump());
+      break;
+  }
+}
+
+}  // anonymous namespace
+
 namespace dap {
 namespace json {
 
-NlohmannDeserializer::NlohmannDeserializer(const std::string& str)
+NlohmannDeserializer::NlohmannDeserializer(const std::string& str,
+                                           StringPool* pool /* = nullptr */)
     : json(new nlohmann::json(nlohmann::json::parse(str, nullptr, false))),
-      ownsJson(true) {}
+      ownsJson(true),
+      pool(pool) {}
 
-NlohmannDeserializer::NlohmannDeserializer(const nlohmann::json* json)
-    : json(json), ownsJson(false) {}
+NlohmannDeserializer::NlohmannDeserializer(const nlohmann::json* json,
+                                           StringPool* pool)
+    : json(json), ownsJson(false), pool(pool) {}
 
 NlohmannDeserializer::~NlohmannDeserializer() {
   if (ownsJson) {
@@ -37,6 +127,32 @@ NlohmannDeserializer::~NlohmannDeserializer() {
   }
 }
 
+dap::Deserializer::Kind NlohmannDeserializer::kind() const {
+  switch (json->type()) {
+    case nlohmann::json::value_t::null:
+      return kNull;
+    case nlohmann::json::value_t::boolean:
+      return kBoolean;
+    case nlohmann::json::value_t::number_integer:
+    case nlohmann::json::value_t::number_unsigned:
+      return kInteger;
+    case nlohmann::json::value_t::number_float:
+      return kNumber;
+    case nlohmann::json::value_t::string:
+      return kString;
+    case nlohmann::json::value_t::array:
+      return kArray;
+    case nlohmann::json::value_t::object:
+      return kObject;
+    default:
+      return kUndefined;
+  }
+}
+
+dap::StringPool* NlohmannDeserializer::stringPool() const {
+  return pool;
+}
+
 bool NlohmannDeserializer::deserialize(dap::boolean* v) const {
   if (!json->is_boolean()) {
     return false;
@@ -69,10 +185,19 @@ bool NlohmannDeserializer::deserialize(dap::string* v) const {
   return true;
 }
 
+bool NlohmannDeserializer::deserialize(dap::interned_string* v) const {
+  if (!json->is_string()) {
+    return false;
+  }
+  auto& str = json->get_ref<const nlohmann::json::string_t&>();
+  *v = pool ? pool->intern(str) : dap::interned_string(str);
+  return true;
+}
+
 bool NlohmannDeserializer::deserialize(dap::object* v) const {
   v->reserve(json->size());
   for (auto& el : json->items()) {
-    NlohmannDeserializer d(&el.value());
+    NlohmannDeserializer d(&el.value(), pool);
     dap::any val;
     if (!d.deserialize(&val)) {
       return false;
@@ -111,6 +236,25 @@ bool NlohmannDeserializer::deserialize(dap::any* v) const {
   return true;
 }
 
+bool NlohmannDeserializer::deserialize(dap::raw_json* v) const {
+  if (json->is_discarded()) {
+    return false;
+  }
+  std::string str;
+  write(*json, &str);
+  *v = dap::raw_json(std::move(str));
+  return true;
+}
+
+bool NlohmannDeserializer::deserialize(dap::bytes* v) const {
+  if (!json->is_string()) {
+    return false;
+  }
+  auto& str = json->get_ref<const nlohmann::json::string_t&>();
+  v->clear();
+  return dap::base64Decode(str.data(), str.size(), v);
+}
+
 size_t NlohmannDeserializer::count() const {
   return json->size();
 }
@@ -121,7 +265,7 @@ bool NlohmannDeserializer::array(
     return false;
   }
   for (size_t i = 0; i < json->size(); i++) {
-    NlohmannDeserializer d(&(*json)[i]);
+    NlohmannDeserializer d(&(*json)[i], pool);
     if (!cb(&d)) {
       return false;
     }
@@ -139,8 +283,7 @@ bool NlohmannDeserializer::field(
   if (it == json->end()) {
     return cb(&NullDeserializer::instance);
   }
-  auto obj = *it;
-  NlohmannDeserializer d(&obj);
+  NlohmannDeserializer d(&*it, pool);
   return cb(&d);
 }
 
@@ -157,7 +300,9 @@ NlohmannSerializer::~NlohmannSerializer() {
 }
 
 std::string NlohmannSerializer::dump() const {
-  return json->dump();
+  std::string out;
+  write(*json, &out);
+  return out;
 }
 
 bool NlohmannSerializer::serialize(dap::boolean v) {
@@ -218,6 +363,25 @@ bool NlohmannSerializer::serialize(const dap::any& v) {
   return true;
 }
 
+bool NlohmannSerializer::serialize(const dap::raw_json& v) {
+  // Hold the text in a binary value, which write() copies into the output.
+  // The text is only validated, without building a tree.
+  auto& str = v.str();
+  if (!nlohmann::json::accept(str)) {
+    return false;
+  }
+  *json = nlohmann::json::binary(
+      std::vector<uint8_t>(str.data(), str.data() + str.size()));
+  return true;
+}
+
+bool NlohmannSerializer::serialize(const dap::bytes& v) {
+  *json = nlohmann::json::string_t(dap::base64EncodedSize(v.size()), '\0');
+  auto& str = json->get_ref<nlohmann::json::string_t&>();
+  dap::base64Encode(v.data(), v.size(), &str[0]);
+  return true;
+}
+
 bool NlohmannSerializer::array(
     size_t count,
     const std::function<bool(dap::Serializer*)>& cb) {
@@ -25,16 +25,21 @@ namespace dap {
 namespace json {
 
 struct NlohmannDeserializer : public dap::Deserializer {
-  explicit NlohmannDeserializer(const std::string&);
+  explicit NlohmannDeserializer(const std::string&, StringPool* pool = nullptr);
   ~NlohmannDeserializer();
 
   // dap::Deserializer compliance
+  Kind kind() const override;
+  StringPool* stringPool() const override;
   bool deserialize(boolean* v) const override;
   bool deserialize(integer* v) const override;
   bool deserialize(number* v) const override;
   bool deserialize(string* v) const override;
   bool deserialize(object* v) const override;
   bool deserialize(any* v) const override;
+  bool deserialize(raw_json* v) const override;
+  bool deserialize(bytes* v) const override;
+  bool deserialize(interned_string* v) const override;
   size_t count() const override;
   bool array(const std::function<bool(dap::Deserializer*)>&) const override;
   bool field(const std::string& name,
@@ -73,9 +78,10 @@ struct NlohmannDeserializer : public dap::Deserializer {
   }
 
  private:
-  NlohmannDeserializer(const nlohmann::json*);
+  NlohmannDeserializer(const nlohmann::json*, StringPool* pool);
   const nlohmann::json* const json;
   const bool ownsJson;
+  StringPool* const pool;
 };
 
 struct NlohmannSerializer : public dap::Serializer {
@@ -91,6 +97,8 @@ struct NlohmannSerializer : public dap::Serializer {
   bool serialize(const string& v) override;
   bool serialize(const dap::object& v) override;
   bool serialize(const any& v) override;
+  bool serialize(const raw_json& v) override;
+  bool serialize(const bytes& v) override;
   bool array(size_t count,
              const std::function<bool(dap::Serializer*)>&) override;
   bool object(const std::function<bool(dap::FieldSerializer*)>&) override;
@@ -25,12 +25,15 @@ namespace json {
 struct NullDeserializer : public dap::Deserializer {
   static NullDeserializer instance;
 
+  Kind kind() const override { return kUndefined; }
   bool deserialize(dap::boolean*) const override { return false; }
   bool deserialize(dap::integer*) const override { return false; }
   bool deserialize(dap::number*) const override { return false; }
   bool deserialize(dap::string*) const override { return false; }
   bool deserialize(dap::object*) const override { return false; }
   bool deserialize(dap::any*) const override { return false; }
+  bool deserialize(dap::raw_json*) const override { return false; }
+  bool deserialize(dap::bytes*) const override { return false; }
   size_t count() const override { return 0; }
   bool array(const std::function<bool(dap::Deserializer*)>&) const override {
     return false;
@@ -17,7 +17,28 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <array>
 #include <string>
+#include <type_traits>
+
+namespace {
+
+// Large is held indirectly by an optional.
+struct Large {
+  std::array<std::string, 4> strings;
+  bool operator==(const Large& other) const { return strings == other.strings; }
+};
+
+static_assert(sizeof(Large) > dap::detail::kOptionalMaxInlineSize,
+              "Large is not large");
+
+Large makeLarge(const char* s) {
+  Large large;
+  large.strings[0] = s;
+  return large;
+}
+
+}  // anonymous namespace
 
 TEST(Optional, EmptyConstruct) {
   dap::optional<std::string> opt;
@@ -51,6 +72,7 @@ TEST(Optional, MoveConstruct) {
   dap::optional<std::string> a("meow");
   dap::optional<std::string> b(std::move(a));
   ASSERT_EQ(b.value(), "meow");
+  ASSERT_FALSE(a.has_value());
 }
 
 TEST(Optional, MoveCastConstruct) {
@@ -80,6 +102,7 @@ TEST(Optional, MoveAssignOptional) {
   dap::optional<std::string> b("meow");
   a = std::move(b);
   ASSERT_EQ(a.value(), "meow");
+  ASSERT_FALSE(b.has_value());
 }
 
 TEST(Optional, StarDeref) {
@@ -167,3 +190,60 @@ TEST(Optional, CompareNEQ) {
   ASSERT_TRUE(dap::optional<int>() != dap::optional<int>(10));
   ASSERT_FALSE(dap::optional<int>() != dap::optional<int>());
 }
+
+TEST(Optional, Indirect) {
+  ASSERT_EQ(sizeof(dap::optional<Large>), sizeof(void*));
+  ASSERT_TRUE(std::is_nothrow_move_constructible<dap::optional<Large>>::value);
+  ASSERT_TRUE(std::is_nothrow_move_assignable<dap::optional<Large>>::value);
+
+  dap::optional<Large> a;
+  ASSERT_FALSE(a.has_value());
+  a = makeLarge("meow");
+  ASSERT_TRUE(a.has_value());
+  ASSERT_EQ(a->strings[0], "meow");
+
+  dap::optional<Large> b(a);
+  ASSERT_EQ(a, b);
+  b->strings[0] = "woof";
+  ASSERT_EQ(a->strings[0], "meow");
+  ASSERT_EQ(b->strings[0], "woof");
+
+  b = dap::optional<Large>();
+  ASSERT_FALSE(b.has_value());
+  b = a;
+  ASSERT_EQ(b.value().strings[0], "meow");
+
+  dap::optional<Large> c(std::move(a));
+  ASSERT_EQ(c.value().strings[0], "meow");
+  ASSERT_FALSE(a.has_value());  // the allocation moved with the value
+  b = std::move(c);
+  ASSERT_EQ(b.value().strings[0], "meow");
+  ASSERT_FALSE(c.has_value());
+  c = dap::optional<Large>();
+  b = std::move(c);
+  ASSERT_FALSE(b.has_value());
+  ASSERT_EQ(dap::optional<Large>().value(makeLarge("purr")).strings[0],
+            "purr");
+}
+
+TEST(Optional, EmptyAccess) {
+  // The storage accessors used by value(), operator*() and operator->(),
+  // which only assert that the optional holds a value.
+  const dap::detail::OptionalStorage<Large> constLarge;
+  ASSERT_EQ(constLarge.get()->strings[0], "");
+  ASSERT_FALSE(constLarge.has_value());
+  const dap::detail::OptionalStorage<std::string> constSmall;
+  ASSERT_TRUE(constSmall.get()->empty());
+
+  dap::detail::OptionalStorage<Large> large;
+  large.get()->strings[0] = "meow";
+  ASSERT_TRUE(large.has_value());
+  large.reset();
+  ASSERT_EQ(large.get()->strings[0], "");
+
+  dap::detail::OptionalStorage<std::string> small;
+  small.assign("meow");
+  small.reset();
+  ASSERT_EQ(*small.get(), "");
+  ASSERT_TRUE(small.has_value());
+}
@@ -0,0 +1,269 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_outbox_h
+#define dap_outbox_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace dap {
+
+// Outbox is a queue of messages of type T that are written in order by a
+// thread owned by the Outbox, for Session::setEventConflation().
+// Messages queued with a conflation key replace the waiting message with the
+// same key, keeping its place in the queue. The number of other messages that
+// can wait in the queue is limited, and queueing a message waits for a bounded
+// time for room.
+// The Outbox is only used while it is active, or while it still holds
+// messages, so that messages are written directly again once it is no longer
+// needed, without reordering them.
+template <typename T>
+class Outbox {
+ public:
+  // Write is the function used to write a message taken from the outbox,
+  // which returns false if the message could not be written.
+  using Write = std::function<bool(T& message)>;
+
+  // Result is the result of put().
+  enum Result {
+    kQueued,    // the message was queued
+    kInactive,  // the outbox is not in use, so the message was not queued
+    kFull,      // the outbox was still full once the wait had elapsed
+    kClosed,    // close() has been called
+  };
+
+  // Stats holds the metrics of the outbox.
+  struct Stats {
+    size_t depth = 0;            // the number of messages waiting
+    uint64_t rejected = 0;       // the messages that put() did not queue
+    uint64_t writeFailures = 0;  // the messages that failed to write
+  };
+
+  inline Outbox(const Write& write);
+
+  // The destructor calls close().
+  inline ~Outbox();
+
+  // setActive() sets whether messages are queued in the outbox, starting the
+  // thread that writes them the first time the outbox is activated. Once
+  // deactivated, the outbox is used until it is empty.
+  inline void setActive(bool active);
+
+  // setLimit() sets the number of messages, not counting conflated messages,
+  // that can wait in the outbox, and how long put() waits for room once the
+  // outbox is full.
+  inline void setLimit(size_t maxMessages, std::chrono::milliseconds maxWait);
+
+  // inUse() returns true if messages are being queued in the outbox.
+  inline bool inUse() const;
+
+  // put() queues the message, if the outbox is in use, waiting while the
+  // outbox is full. The message is only moved from if it was queued.
+  inline Result put(T&& message);
+
+  // conflate() queues the message returned by create() under the conflation
+  // key. If a message with the same key is still waiting, replace() is called
+  // with the waiting message instead, which keeps its place in the queue. Both
+  // functions are called with the outbox lock held. key must not be empty.
+  // conflate() never waits, and returns false if the outbox is not in use or
+  // is closed.
+  template <typename CREATE, typename REPLACE>
+  inline bool conflate(const std::string& key,
+                       CREATE&& create,
+                       REPLACE&& replace);
+
+  // stats() returns the metrics of the outbox.
+  inline Stats stats();
+
+  // close() writes the messages that are still waiting, and stops the
+  // thread. Later calls to put() and conflate() fail.
+  inline void close();
+
+ private:
+  using List = std::list<std::pair<std::string, T>>;
+
+  Outbox(const Outbox&) = delete;
+  Outbox& operator=(const Outbox&) = delete;
+
+  // run() writes the queued messages in order until close() is called.
+  inline void run();
+
+  // deactivateLocked() stops using the outbox once it is inactive and empty.
+  // mutex must be held.
+  inline void deactivateLocked();
+
+  const Write write;
+  std::atomic<bool> used = {false};
+  std::mutex mutex;
+  std::condition_variable cv;
+  // The messages and their conflation keys, in order. Messages that are not
+  // conflated have an empty key.
+  List queue;
+  std::unordered_map<std::string, typename List::iterator> keys;
+  size_t numMessages = 0;  // the queued messages that are not conflated
+  size_t maxMessages = 1024;
+  std::chrono::milliseconds maxWait = std::chrono::seconds(1);
+  Stats counts;  // the counts of stats()
+  bool active = false;
+  bool closed = false;
+  std::thread thread;  // runs run()
+};
+
+template <typename T>
+Outbox<T>::Outbox(const Write& write) : write(write) {}
+
+template <typename T>
+Outbox<T>::~Outbox() {
+  close();
+}
+
+template <typename T>
+void Outbox<T>::setActive(bool a) {
+  std::unique_lock<std::mutex> lock(mutex);
+  active = a;
+  if (active) {
+    used = true;
+    if (!thread.joinable() && !closed) {
+      thread = std::thread([this] { run(); });
+    }
+  } else {
+    deactivateLocked();
+  }
+}
+
+template <typename T>
+void Outbox<T>::setLimit(size_t messages, std::chrono::milliseconds wait) {
+  std::unique_lock<std::mutex> lock(mutex);
+  maxMessages = messages;
+  maxWait = wait;
+  cv.notify_all();
+}
+
+template <typename T>
+bool Outbox<T>::inUse() const {
+  return used.load();
+}
+
+template <typename T>
+typename Outbox<T>::Result Outbox<T>::put(T&& message) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!used) {
+    return kInactive;
+  }
+  cv.wait_for(lock, maxWait,
+              [&] { return closed || numMessages < maxMessages; });
+  if (closed) {
+    return kClosed;
+  }
+  if (!used) {
+    return kInactive;  // The outbox was emptied while waiting.
+  }
+  if (numMessages >= maxMessages) {
+    counts.rejected++;
+    return kFull;
+  }
+  numMessages++;
+  queue.emplace_back(std::string(), std::move(message));
+  cv.notify_all();
+  return kQueued;
+}
+
+template <typename T>
+template <typename CREATE, typename REPLACE>
+bool Outbox<T>::conflate(const std::string& key,
+                         CREATE&& create,
+                         REPLACE&& replace) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!used || closed) {
+    return false;
+  }
+  auto it = keys.find(key);
+  if (it != keys.end()) {
+    replace(it->second->second);
+    return true;
+  }
+  queue.emplace_back(key, create());
+  keys.emplace(key, std::prev(queue.end()));
+  cv.notify_all();
+  return true;
+}
+
+template <typename T>
+typename Outbox<T>::Stats Outbox<T>::stats() {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto out = counts;
+  out.depth = queue.size();
+  return out;
+}
+
+template <typename T>
+void Outbox<T>::close() {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    closed = true;
+    cv.notify_all();
+  }
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+template <typename T>
+void Outbox<T>::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    cv.wait(lock, [&] { return closed || !queue.empty(); });
+    if (queue.empty()) {
+      return;
+    }
+    auto entry = std::move(queue.front());
+    queue.pop_front();
+    if (entry.first.empty()) {
+      numMessages--;
+    } else {
+      keys.erase(entry.first);
+    }
+    cv.notify_all();
+    lock.unlock();
+    auto ok = write(entry.second);
+    lock.lock();
+    if (!ok) {
+      counts.writeFailures++;
+    }
+    deactivateLocked();
+  }
+}
+
+template <typename T>
+void Outbox<T>::deactivateLocked() {
+  if (!active && queue.empty()) {
+    used = false;
+  }
+}
+
+}  // namespace dap
+
+#endif  // dap_outbox_h
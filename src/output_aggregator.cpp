@@ -0,0 +1,138 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "output_aggregator.h"
+
+#include "output_event.h"
+
+namespace dap {
+
+OutputAggregator::OutputAggregator(const Send& send) : send(send) {}
+
+OutputAggregator::~OutputAggregator() {
+  close();
+}
+
+void OutputAggregator::setWindow(std::chrono::milliseconds w, size_t max) {
+  maxBytes = max;
+  window = w;
+  if (w.count() == 0) {
+    flush();
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!thread.joinable() && !closed) {
+    thread = std::thread([this] { run(); });
+  }
+}
+
+bool OutputAggregator::add(const void* event) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (pending && canMergeOutput(pending.get(), event)) {
+    if (appendOutput(pending.get(), event) < maxBytes.load()) {
+      return true;
+    }
+    lock.unlock();
+    return flush();
+  }
+  lock.unlock();
+
+  std::unique_lock<std::mutex> flushLock(flushMutex);
+  flushLocked();
+  if (!canMergeOutput(event, event) || outputSize(event) >= maxBytes.load()) {
+    return send(event);
+  }
+  start(newOutputEvent(event), false);
+  return true;
+}
+
+bool OutputAggregator::add(const char* category,
+                           const char* output,
+                           size_t size,
+                           bool* ok) {
+  if (size >= maxBytes.load()) {
+    return false;
+  }
+  *ok = true;
+  std::unique_lock<std::mutex> lock(mutex);
+  if (pending && canMergeOutput(pending.get(), category)) {
+    raw = true;
+    if (appendOutput(pending.get(), output, size) >= maxBytes.load()) {
+      lock.unlock();
+      *ok = flush();
+    }
+    return true;
+  }
+  lock.unlock();
+
+  std::unique_lock<std::mutex> flushLock(flushMutex);
+  *ok = flushLocked();
+  auto event = newOutputEvent(category, "", 0);
+  appendOutput(event.get(), output, size);
+  start(std::move(event), true);
+  return true;
+}
+
+void OutputAggregator::close() {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    closed = true;
+    cv.notify_all();
+  }
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void OutputAggregator::start(std::shared_ptr<void>&& event, bool isRaw) {
+  std::unique_lock<std::mutex> lock(mutex);
+  pending = std::move(event);
+  raw = isRaw;
+  deadline = Clock::now() + window.load();
+  hasPending = true;
+  cv.notify_one();
+}
+
+bool OutputAggregator::flushLocked() {
+  std::shared_ptr<void> output;
+  bool replace = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::swap(output, pending);
+    std::swap(replace, raw);
+  }
+  if (replace) {
+    replaceInvalidOutput(output.get());
+  }
+  auto ok = !output || send(output.get());
+  hasPending = false;
+  return ok;
+}
+
+void OutputAggregator::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!closed) {
+    if (!pending) {
+      cv.wait(lock);
+    } else if (Clock::now() < deadline) {
+      cv.wait_until(lock, deadline);
+    } else {
+      lock.unlock();
+      flush();
+      lock.lock();
+    }
+  }
+}
+
+}  // namespace dap
@@ -0,0 +1,138 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_output_aggregator_h
+#define dap_output_aggregator_h
+
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dap {
+
+// OutputAggregator merges consecutive OutputEvents into a single event, for
+// Session::setOutputAggregation(). The merged event is sent once the window
+// has elapsed since the first merged event, once its output reaches maxBytes,
+// or when flush() is called.
+// Output whose window has elapsed is sent by a thread that is started the
+// first time aggregation is enabled.
+class OutputAggregator {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Send is the function used to send an OutputEvent, which returns false if
+  // the event could not be sent.
+  using Send = std::function<bool(const void* event)>;
+
+  explicit OutputAggregator(const Send& send);
+
+  // The destructor calls close().
+  ~OutputAggregator();
+
+  // setWindow() sets the aggregation window, and the output size at which the
+  // merged event is sent. A window of zero disables aggregation, sending any
+  // pending output.
+  void setWindow(std::chrono::milliseconds window, size_t maxBytes);
+
+  // enabled() returns true if aggregation is enabled.
+  inline bool enabled() const;
+
+  // add() merges the OutputEvent with the pending output. The pending output
+  // is sent first if the two cannot be merged, and an event that cannot be
+  // merged with any other, or that is already larger than maxBytes, is sent
+  // immediately.
+  bool add(const void* event);
+
+  // add() merges output with the category, held by the size bytes at output,
+  // with the pending output, for Session::sendOutput(). Returns true if the
+  // output was aggregated, with ok assigned false if pending output that could
+  // not be merged failed to send. Returns false, without sending the pending
+  // output, if the output is already larger than maxBytes, in which case the
+  // caller flushes and sends it itself.
+  // Invalid UTF-8 is replaced once the merged output is sent, so that
+  // characters split between calls are kept.
+  bool add(const char* category, const char* output, size_t size, bool* ok);
+
+  // flush() sends the pending output, if there is one. The Session calls
+  // flush() before sending any other message, so that message order is
+  // preserved. flush() returns once the output has been sent, even if it is
+  // being sent by another thread.
+  inline bool flush();
+
+  // close() stops the thread that sends the output whose window has elapsed.
+  // Any pending output is kept until the next call to flush().
+  void close();
+
+ private:
+  OutputAggregator(const OutputAggregator&) = delete;
+  OutputAggregator& operator=(const OutputAggregator&) = delete;
+
+  // start() starts the pending output with the OutputEvent, which is taken
+  // by start(). raw is true if the event holds output added by
+  // add(category, output, size). flushMutex must be held, and there must be
+  // no pending output.
+  void start(std::shared_ptr<void>&& event, bool raw);
+
+  // flushLocked() sends the pending output, if there is one, with flushMutex
+  // held. The output is taken under mutex and sent without it, so aggregating
+  // output never waits for a write. hasPending is only cleared once the
+  // output has been sent, so that flush() on another thread waits for the
+  // write to complete.
+  bool flushLocked();
+
+  // run() sends the pending output once the aggregation window has elapsed,
+  // until close() is called. The output is sent on its own thread, so that a
+  // slow write does not delay the Session's timers.
+  void run();
+
+  const Send send;
+  std::atomic<std::chrono::milliseconds> window = {
+      std::chrono::milliseconds(0)};
+  std::atomic<size_t> maxBytes = {0};
+  std::atomic<bool> hasPending = {false};
+  // Only a thread holding flushMutex sends the pending output, or starts new
+  // pending output, so the pending output is still empty once it has been
+  // sent.
+  std::mutex flushMutex;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::shared_ptr<void> pending;  // guarded by mutex
+  Clock::time_point deadline;     // guarded by mutex
+  // true if the pending output holds output added by add(category, output,
+  // size), which may hold invalid UTF-8.
+  bool raw = false;     // guarded by mutex
+  bool closed = false;            // guarded by mutex
+  std::thread thread;             // runs run()
+};
+
+bool OutputAggregator::enabled() const {
+  return window.load().count() > 0;
+}
+
+bool OutputAggregator::flush() {
+  if (!hasPending.load()) {
+    return true;
+  }
+  std::unique_lock<std::mutex> flushLock(flushMutex);
+  return flushLocked();
+}
+
+}  // namespace dap
+
+#endif  // dap_output_aggregator_h
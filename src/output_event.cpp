@@ -0,0 +1,144 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "output_event.h"
+
+#include "json_string.h"
+
+#include "dap/protocol.h"
+
+namespace {
+
+// equal() compares the Sources field by field. Sources with adapterData are
+// never equal, as adapterData may hold any value.
+bool equal(const dap::Source& a, const dap::Source& b) {
+  if (a.adapterData.has_value() || b.adapterData.has_value() ||
+      a.name != b.name || a.origin != b.origin || a.path != b.path ||
+      a.presentationHint != b.presentationHint ||
+      a.sourceReference != b.sourceReference ||
+      a.checksums.has_value() != b.checksums.has_value() ||
+      a.sources.has_value() != b.sources.has_value()) {
+    return false;
+  }
+  if (a.checksums.has_value()) {
+    auto& ca = a.checksums.value();
+    auto& cb = b.checksums.value();
+    if (ca.size() != cb.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < ca.size(); i++) {
+      if (ca[i].algorithm != cb[i].algorithm ||
+          ca[i].checksum != cb[i].checksum) {
+        return false;
+      }
+    }
+  }
+  if (a.sources.has_value()) {
+    auto& sa = a.sources.value();
+    auto& sb = b.sources.value();
+    if (sa.size() != sb.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < sa.size(); i++) {
+      if (!equal(sa[i], sb[i])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// plain() returns true if the event only carries output.
+bool plain(const dap::OutputEvent& e) {
+  return !e.group.has_value() && !e.line.has_value() &&
+         !e.column.has_value() && !e.data.has_value() &&
+         !e.variablesReference.has_value();
+}
+
+}  // anonymous namespace
+
+namespace dap {
+
+const TypeInfo* outputEventType() {
+  return TypeOf<OutputEvent>::type();
+}
+
+std::shared_ptr<void> newOutputEvent(const void* event) {
+  return std::make_shared<OutputEvent>(
+      *static_cast<const OutputEvent*>(event));
+}
+
+std::shared_ptr<void> newOutputEvent(const char* category,
+                                     const char* output,
+                                     size_t size) {
+  auto event = std::make_shared<OutputEvent>();
+  setOutput(event.get(), category, output, size);
+  return event;
+}
+
+bool canMergeOutput(const void* a, const void* b) {
+  auto& ea = *static_cast<const OutputEvent*>(a);
+  auto& eb = *static_cast<const OutputEvent*>(b);
+  if (!plain(ea) || !plain(eb) || ea.category != eb.category ||
+      ea.source.has_value() != eb.source.has_value()) {
+    return false;
+  }
+  return !ea.source.has_value() ||
+         equal(ea.source.value(), eb.source.value());
+}
+
+bool canMergeOutput(const void* a, const char* category) {
+  auto& e = *static_cast<const OutputEvent*>(a);
+  if (!plain(e) || e.source.has_value()) {
+    return false;
+  }
+  if (category == nullptr) {
+    return !e.category.has_value();
+  }
+  return e.category.has_value() && e.category.value() == category;
+}
+
+size_t outputSize(const void* event) {
+  return static_cast<const OutputEvent*>(event)->output.size();
+}
+
+size_t appendOutput(void* a, const void* b) {
+  auto& ea = *static_cast<OutputEvent*>(a);
+  ea.output += static_cast<const OutputEvent*>(b)->output;
+  return ea.output.size();
+}
+
+size_t appendOutput(void* event, const char* output, size_t size) {
+  auto& e = *static_cast<OutputEvent*>(event);
+  e.output.append(output, size);
+  return e.output.size();
+}
+
+void replaceInvalidOutput(void* event) {
+  dap::json::replaceInvalidUTF8(&static_cast<OutputEvent*>(event)->output);
+}
+
+void setOutput(void* event,
+               const char* category,
+               const char* output,
+               size_t size) {
+  auto& e = *static_cast<OutputEvent*>(event);
+  if (category != nullptr) {
+    e.category = category;
+  }
+  e.output.assign(output, size);
+  dap::json::replaceInvalidUTF8(&e.output);
+}
+
+}  // namespace dap
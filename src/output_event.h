@@ -0,0 +1,78 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_output_event_h
+#define dap_output_event_h
+
+#include <stddef.h>
+#include <memory>
+
+namespace dap {
+
+class TypeInfo;
+
+// The functions below operate on OutputEvents passed by pointer, so that the
+// Session, which aggregates and forwards output, does not depend on the
+// generated protocol types.
+
+// outputEventType() returns the TypeInfo of OutputEvent.
+const TypeInfo* outputEventType();
+
+// newOutputEvent() returns a copy of the OutputEvent event.
+std::shared_ptr<void> newOutputEvent(const void* event);
+
+// newOutputEvent() returns a new OutputEvent with the category and output.
+// See setOutput().
+std::shared_ptr<void> newOutputEvent(const char* category,
+                                     const char* output,
+                                     size_t size);
+
+// canMergeOutput() returns true if the output of the OutputEvent b can be
+// appended to the OutputEvent a. Events that start or end a group, or that
+// carry a location, data or variables are never merged.
+bool canMergeOutput(const void* a, const void* b);
+
+// canMergeOutput() returns true if output with the category can be appended
+// to the OutputEvent a. A null category matches an event without a category.
+bool canMergeOutput(const void* a, const char* category);
+
+// outputSize() returns the size of the output of the OutputEvent event.
+size_t outputSize(const void* event);
+
+// appendOutput() appends the output of the OutputEvent b to the OutputEvent a,
+// and returns the size of the output of a.
+size_t appendOutput(void* a, const void* b);
+
+// appendOutput() appends the size bytes at output to the output of the
+// OutputEvent event, and returns the size of its output. The output is not
+// checked for invalid UTF-8, as it may end part way through a character that
+// is completed by the next append, so the caller calls replaceInvalidOutput()
+// once the event is complete.
+size_t appendOutput(void* event, const char* output, size_t size);
+
+// replaceInvalidOutput() replaces invalid UTF-8 in the output of the
+// OutputEvent event with U+FFFD.
+void replaceInvalidOutput(void* event);
+
+// setOutput() assigns the category and output of the OutputEvent event. A null
+// category leaves the category unset. Invalid UTF-8 in the output is replaced
+// with U+FFFD.
+void setOutput(void* event,
+               const char* category,
+               const char* output,
+               size_t size);
+
+}  // namespace dap
+
+#endif  // dap_output_event_h
@@ -0,0 +1,165 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pending_requests.h"
+
+#include <algorithm>
+
+namespace dap {
+
+constexpr std::chrono::seconds PendingRequests::kExpiredRetention;
+
+PendingRequests::Result PendingRequests::add(std::atomic<uint32_t>& nextSeq,
+                                             const TypeInfo* requestTypeInfo,
+                                             const TypeInfo* typeinfo,
+                                             const Handler& handler,
+                                             bool canWait,
+                                             uint32_t* seq) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!closed && full()) {
+    if (canWait && maxWait.count() > 0) {
+      pendingStats.blocked++;
+      cv.wait_for(lock, maxWait, [&] { return closed || !full(); });
+    }
+    if (!closed && full()) {
+      pendingStats.rejected++;
+      return kFull;
+    }
+  }
+  if (closed) {
+    return kClosed;
+  }
+  *seq = nextSeq++;
+  auto& entry = entries[*seq];
+  entry.request.requestTypeInfo = requestTypeInfo;
+  entry.request.typeinfo = typeinfo;
+  entry.request.handler = handler;
+  pendingStats.peak = std::max(pendingStats.peak, entries.size());
+  return kAdded;
+}
+
+void PendingRequests::setTimer(uint32_t seq, TimerWheel::Id timer) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto it = entries.find(seq);
+  if (it != entries.end()) {
+    it->second.request.timer = timer;
+  }
+}
+
+PendingRequests::Request PendingRequests::sent(uint32_t seq) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto it = entries.find(seq);
+  if (it == entries.end()) {
+    return {};
+  }
+  if (!it->second.expired) {
+    it->second.sending = false;
+    return {};
+  }
+  auto out = std::move(it->second.request);
+  entries.erase(it);
+  pendingStats.timedOut++;
+  remember(seq);
+  cv.notify_one();
+  return out;
+}
+
+PendingRequests::Request PendingRequests::discard(uint32_t seq) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto it = entries.find(seq);
+  if (it == entries.end()) {
+    return {};
+  }
+  auto out = std::move(it->second.request);
+  entries.erase(it);
+  cv.notify_one();
+  return out;
+}
+
+PendingRequests::Request PendingRequests::expire(uint32_t seq) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto it = entries.find(seq);
+  if (it == entries.end()) {
+    return {};
+  }
+  if (it->second.sending) {
+    it->second.expired = true;  // Completed by sent().
+    return {};
+  }
+  auto out = std::move(it->second.request);
+  entries.erase(it);
+  pendingStats.timedOut++;
+  remember(seq);
+  cv.notify_one();
+  return out;
+}
+
+PendingRequests::Request PendingRequests::take(int64_t seq, bool* timedOut) {
+  std::unique_lock<std::mutex> lock(mutex);
+  *timedOut = false;
+  if (seq < 0 || seq > int64_t(UINT32_MAX)) {
+    return {};
+  }
+  auto it = entries.find(uint32_t(seq));
+  if (it == entries.end()) {
+    prune(Clock::now());
+    *timedOut = expired.count(uint32_t(seq)) > 0;
+    return {};
+  }
+  auto out = std::move(it->second.request);
+  entries.erase(it);
+  cv.notify_one();
+  return out;
+}
+
+void PendingRequests::setLimit(size_t max, std::chrono::milliseconds wait) {
+  std::unique_lock<std::mutex> lock(mutex);
+  maxPending = max;
+  maxWait = wait;
+  cv.notify_all();
+}
+
+PendingRequestStats PendingRequests::stats() {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto out = pendingStats;
+  out.pending = entries.size();
+  return out;
+}
+
+void PendingRequests::close() {
+  std::unique_lock<std::mutex> lock(mutex);
+  closed = true;
+  cv.notify_all();
+}
+
+bool PendingRequests::full() const {
+  return maxPending > 0 && entries.size() >= maxPending;
+}
+
+void PendingRequests::remember(uint32_t seq) {
+  auto now = Clock::now();
+  prune(now);
+  expired.emplace(seq);
+  expiredOrder.emplace_back(now, seq);
+}
+
+void PendingRequests::prune(Clock::time_point now) {
+  while (!expiredOrder.empty() &&
+         now - expiredOrder.front().first > kExpiredRetention) {
+    expired.erase(expiredOrder.front().second);
+    expiredOrder.pop_front();
+  }
+}
+
+}  // namespace dap
@@ -0,0 +1,148 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_pending_requests_h
+#define dap_pending_requests_h
+
+#include "timer_wheel.h"
+
+#include "dap/session.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace dap {
+
+// PendingRequests holds the response handlers of the requests sent by a
+// Session that are awaiting a response, and enforces the limit set by
+// Session::setMaxPendingRequests().
+//
+// A request is added before it is written, and is marked as sending until the
+// writer calls sent() or discard(). A timeout that expires while the request
+// is being sent is deferred to sent(), so that the response handler of a
+// request that fails to send is never called.
+class PendingRequests {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Handler = Session::GenericResponseHandler;
+
+  // kExpiredRetention is how long the sequence number of a timed out request
+  // is remembered, so that a late response is dropped without an error.
+  static constexpr std::chrono::seconds kExpiredRetention{60};
+
+  // Request is a request awaiting a response.
+  struct Request {
+    const TypeInfo* requestTypeInfo = nullptr;
+    const TypeInfo* typeinfo = nullptr;  // the type of the response body
+    Handler handler;
+    TimerWheel::Id timer = 0;  // 0 if the request has no timeout
+  };
+
+  // Result is the result of add().
+  enum Result {
+    kAdded,   // the request was added
+    kFull,    // the limit was reached
+    kClosed,  // close() has been called
+  };
+
+  // add() adds a request, numbering it with the next sequence number taken
+  // from nextSeq, which is written to seq. The number is only taken once a
+  // slot is reserved, so a request that waited for a slot is not numbered
+  // older than the messages sent while it waited.
+  // At the limit, add() waits for up to the maxWait passed to setLimit() for
+  // a slot to become free. If canWait is false, add() never waits, as the
+  // calling thread is the one that processes the responses that free a slot.
+  Result add(std::atomic<uint32_t>& nextSeq,
+             const TypeInfo* requestTypeInfo,
+             const TypeInfo* typeinfo,
+             const Handler& handler,
+             bool canWait,
+             uint32_t* seq);
+
+  // setTimer() associates the timeout timer with the request.
+  void setTimer(uint32_t seq, TimerWheel::Id timer);
+
+  // sent() marks the request as written. Returns the request if its timeout
+  // expired while it was being written, in which case the caller completes it
+  // with the timeout error, otherwise an empty Request.
+  Request sent(uint32_t seq);
+
+  // discard() removes and returns the request that failed to send, freeing
+  // its slot. Returns an empty Request if the response has already arrived.
+  Request discard(uint32_t seq);
+
+  // expire() removes and returns the request whose timeout has expired,
+  // counting it as timed out. Returns an empty Request if the response has
+  // already arrived, or if the request is still being sent.
+  Request expire(uint32_t seq);
+
+  // take() removes and returns the request with the given sequence number,
+  // for its response. Returns an empty Request if there is none, assigning
+  // timedOut true if the request timed out within kExpiredRetention.
+  Request take(int64_t seq, bool* timedOut);
+
+  // setLimit() sets the maximum number of pending requests, and how long
+  // add() waits for a slot at the limit. A limit of zero is unbounded.
+  void setLimit(size_t max, std::chrono::milliseconds maxWait);
+
+  // stats() returns the metrics of the pending requests.
+  PendingRequestStats stats();
+
+  // close() unblocks any calls to add() waiting for a slot, and fails all
+  // later calls.
+  void close();
+
+ private:
+  struct Entry {
+    Request request;
+    bool sending = true;   // the request has not yet been written
+    bool expired = false;  // the timeout expired while sending
+  };
+
+  // full() returns true if the number of pending requests is at the limit.
+  // mutex must be held.
+  bool full() const;
+
+  // remember() records the sequence number of a timed out request.
+  // mutex must be held.
+  void remember(uint32_t seq);
+
+  // prune() forgets the timed out requests older than kExpiredRetention.
+  // mutex must be held.
+  void prune(Clock::time_point now);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::unordered_map<uint32_t, Entry> entries;
+  size_t maxPending = 0;
+  std::chrono::milliseconds maxWait = {};
+  PendingRequestStats pendingStats;
+  bool closed = false;
+  // The sequence numbers of the requests that timed out within
+  // kExpiredRetention, and the times they timed out, oldest first.
+  std::unordered_set<uint32_t> expired;
+  std::deque<std::pair<Clock::time_point, uint32_t>> expiredOrder;
+};
+
+}  // namespace dap
+
+#endif  // dap_pending_requests_h
@@ -0,0 +1,144 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_published_h
+#define dap_published_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dap {
+
+// Published holds a shared object that is read by many threads without
+// locking, and occasionally replaced with set().
+// Readers access the object through a Reader, which counts itself as a reader
+// for its lifetime. A replaced object is retired, and its reference is only
+// released once no Reader remains, as one may still be reading it. Readers
+// never wait for set(), and should be short lived, as retired objects are held
+// while any Reader exists.
+template <typename T>
+class Published {
+ public:
+  // Reader reads the object published when the Reader was constructed.
+  class Reader {
+   public:
+    inline explicit Reader(Published* published);
+    inline ~Reader();
+
+    // get() returns the published object, or nullptr if there is none.
+    inline T* get() const { return slot ? slot->get() : nullptr; }
+
+    // share() returns a reference to the published object, which keeps it
+    // alive once the Reader has been destructed.
+    inline std::shared_ptr<T> share() const {
+      return slot ? *slot : std::shared_ptr<T>();
+    }
+
+   private:
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    Published* const published;
+    const std::shared_ptr<T>* slot;
+  };
+
+  inline Published() = default;
+  inline ~Published();
+
+  // set() publishes the object, replacing the currently published object.
+  // A null object unpublishes the current object.
+  inline void set(const std::shared_ptr<T>& object);
+
+  // empty() returns true if no object is published. empty() does not need a
+  // Reader, as it does not access the object.
+  inline bool empty() const { return current.load() == nullptr; }
+
+ private:
+  using Slot = std::shared_ptr<T>;
+
+  Published(const Published&) = delete;
+  Published& operator=(const Published&) = delete;
+
+  // reclaim() releases the retired objects if no Reader exists, without
+  // waiting for mutex.
+  inline void reclaim();
+
+  // reclaimLocked() moves the retired objects to released if no Reader
+  // exists. A Reader constructed after the check loads the current object, as
+  // the retired objects were replaced before they were retired. The caller
+  // releases the objects once mutex is unlocked, in case their destructors
+  // call set().
+  inline void reclaimLocked(std::vector<std::unique_ptr<Slot>>* released);
+
+  std::atomic<Slot*> current = {nullptr};
+  std::atomic<int> readers = {0};
+  std::atomic<bool> retiring = {false};  // true if retired is not empty
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Slot>> retired;  // guarded by mutex
+};
+
+template <typename T>
+Published<T>::Reader::Reader(Published* published) : published(published) {
+  published->readers.fetch_add(1);
+  slot = published->current.load();
+}
+
+template <typename T>
+Published<T>::Reader::~Reader() {
+  if (published->readers.fetch_sub(1) == 1 && published->retiring.load()) {
+    published->reclaim();
+  }
+}
+
+template <typename T>
+Published<T>::~Published() {
+  delete current.load();
+}
+
+template <typename T>
+void Published<T>::set(const std::shared_ptr<T>& object) {
+  std::unique_ptr<Slot> slot(object ? new Slot(object) : nullptr);
+  std::vector<std::unique_ptr<Slot>> released;
+  std::unique_lock<std::mutex> lock(mutex);
+  std::unique_ptr<Slot> replaced(current.exchange(slot.release()));
+  if (replaced) {
+    retired.emplace_back(std::move(replaced));
+    retiring = true;
+  }
+  reclaimLocked(&released);
+}
+
+template <typename T>
+void Published<T>::reclaim() {
+  std::vector<std::unique_ptr<Slot>> released;
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (lock.owns_lock()) {
+    reclaimLocked(&released);
+  }
+}
+
+template <typename T>
+void Published<T>::reclaimLocked(
+    std::vector<std::unique_ptr<Slot>>* released) {
+  if (readers.load() == 0) {
+    std::swap(*released, retired);
+    retiring = false;
+  }
+}
+
+}  // namespace dap
+
+#endif  // dap_published_h
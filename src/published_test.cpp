@@ -0,0 +1,86 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "published.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+TEST(Published, Empty) {
+  dap::Published<int> published;
+  ASSERT_TRUE(published.empty());
+  dap::Published<int>::Reader reader(&published);
+  ASSERT_EQ(reader.get(), nullptr);
+  ASSERT_EQ(reader.share(), nullptr);
+}
+
+TEST(Published, Set) {
+  dap::Published<int> published;
+  auto a = std::make_shared<int>(1);
+  published.set(a);
+  ASSERT_FALSE(published.empty());
+  {
+    dap::Published<int>::Reader reader(&published);
+    ASSERT_EQ(reader.get(), a.get());
+    ASSERT_EQ(reader.share(), a);
+  }
+  published.set(nullptr);
+  ASSERT_TRUE(published.empty());
+  // No Reader exists, so the replaced object has been released.
+  ASSERT_EQ(a.use_count(), 1);
+}
+
+TEST(Published, RetiredWhileRead) {
+  dap::Published<int> published;
+  auto a = std::make_shared<int>(1);
+  auto b = std::make_shared<int>(2);
+  published.set(a);
+  {
+    dap::Published<int>::Reader reader(&published);
+    published.set(b);
+    // The Reader still reads the replaced object, which is retained.
+    ASSERT_EQ(reader.get(), a.get());
+    ASSERT_EQ(a.use_count(), 2);
+    dap::Published<int>::Reader newReader(&published);
+    ASSERT_EQ(newReader.get(), b.get());
+  }
+  // The last Reader released the retired object.
+  ASSERT_EQ(a.use_count(), 1);
+  ASSERT_EQ(b.use_count(), 2);
+}
+
+TEST(Published, Concurrent) {
+  dap::Published<int> published;
+  published.set(std::make_shared<int>(0));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 10000; j++) {
+        dap::Published<int>::Reader reader(&published);
+        ASSERT_GE(*reader.get(), 0);
+      }
+    });
+  }
+  for (int i = 1; i <= 1000; i++) {
+    published.set(std::make_shared<int>(i));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  dap::Published<int>::Reader reader(&published);
+  ASSERT_EQ(*reader.get(), 1000);
+}
@@ -16,23 +16,101 @@
 
 #include "null_json_serializer.h"
 
+#include "dap/bytes.h"
+#include "dap/interned_string.h"
+#include "dap/raw_json.h"
+
 #include <rapidjson/document.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <string.h>
+
+namespace {
+
+// RawValueWriter forwards the values of a document to a writer, writing the
+// strings that hold the text of dap::raw_json values as raw JSON.
+template <typename Writer>
+class RawValueWriter {
+ public:
+  RawValueWriter(Writer* writer, const std::unordered_set<const char*>* raw)
+      : writer(writer), raw(raw) {}
+
+  bool Null() { return writer->Null(); }
+  bool Bool(bool b) { return writer->Bool(b); }
+  bool Int(int i) { return writer->Int(i); }
+  bool Uint(unsigned u) { return writer->Uint(u); }
+  bool Int64(int64_t i) { return writer->Int64(i); }
+  bool Uint64(uint64_t u) { return writer->Uint64(u); }
+  bool Double(double d) { return writer->Double(d); }
+  bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) {
+    return writer->RawNumber(str, length, copy);
+  }
+  bool String(const char* str, rapidjson::SizeType length, bool copy) {
+    if (raw->count(str) > 0) {
+      return writer->RawValue(str, length, rapidjson::kObjectType);
+    }
+    return writer->String(str, length, copy);
+  }
+  bool StartObject() { return writer->StartObject(); }
+  bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+    return writer->Key(str, length, copy);
+  }
+  bool EndObject(rapidjson::SizeType count) {
+    return writer->EndObject(count);
+  }
+  bool StartArray() { return writer->StartArray(); }
+  bool EndArray(rapidjson::SizeType count) { return writer->EndArray(count); }
+
+ private:
+  Writer* const writer;
+  const std::unordered_set<const char*>* const raw;
+};
+
+}  // anonymous namespace
 
 namespace dap {
 namespace json {
 
-RapidDeserializer::RapidDeserializer(const std::string& str)
-    : doc(new rapidjson::Document()) {
+RapidDeserializer::RapidDeserializer(const std::string& str,
+                                     StringPool* pool /* = nullptr */)
+    : doc(new rapidjson::Document()), pool(pool) {
   doc->Parse(str.c_str());
 }
 
-RapidDeserializer::RapidDeserializer(rapidjson::Value* json) : val(json) {}
+RapidDeserializer::RapidDeserializer(rapidjson::Value* json, StringPool* pool)
+    : val(json), pool(pool) {}
 
 RapidDeserializer::~RapidDeserializer() {
   delete doc;
 }
 
+dap::StringPool* RapidDeserializer::stringPool() const {
+  return pool;
+}
+
+dap::Deserializer::Kind RapidDeserializer::kind() const {
+  if (json()->IsNull()) {
+    return kNull;
+  } else if (json()->IsBool()) {
+    return kBoolean;
+  } else if (json()->IsDouble()) {
+    return kNumber;
+  } else if (json()->IsNumber()) {
+    return kInteger;
+  } else if (json()->IsString()) {
+    return kString;
+  } else if (json()->IsArray()) {
+    return kArray;
+  } else if (json()->IsObject()) {
+    return kObject;
+  }
+  return kUndefined;
+}
+
 bool RapidDeserializer::deserialize(dap::boolean* v) const {
   if (!json()->IsBool()) {
     return false;
@@ -70,19 +148,33 @@ bool RapidDeserializer::deserialize(dap::string* v) const {
   if (!json()->IsString()) {
     return false;
   }
-  *v = json()->GetString();
+  v->assign(json()->GetString(), json()->GetStringLength());
+  return true;
+}
+
+bool RapidDeserializer::deserialize(dap::interned_string* v) const {
+  if (!json()->IsString()) {
+    return false;
+  }
+  auto str = json()->GetString();
+  auto size = json()->GetStringLength();
+  *v = pool ? pool->intern(str, size) : dap::interned_string(str, size);
   return true;
 }
 
 bool RapidDeserializer::deserialize(dap::object* v) const {
+  if (!json()->IsObject()) {
+    return false;
+  }
   v->reserve(json()->MemberCount());
   for (auto el = json()->MemberBegin(); el != json()->MemberEnd(); el++) {
     dap::any el_val;
-    RapidDeserializer d(&(el->value));
+    RapidDeserializer d(&(el->value), pool);
     if (!d.deserialize(&el_val)) {
       return false;
     }
-    (*v)[el->name.GetString()] = el_val;
+    (*v)[std::string(el->name.GetString(), el->name.GetStringLength())] =
+        el_val;
   }
   return true;
 }
@@ -92,10 +184,12 @@ bool RapidDeserializer::deserialize(dap::any* v) const {
     *v = dap::boolean(json()->GetBool());
   } else if (json()->IsDouble()) {
     *v = dap::number(json()->GetDouble());
-  } else if (json()->IsInt()) {
-    *v = dap::integer(json()->GetInt());
+  } else if (json()->IsInt64()) {
+    *v = dap::integer(json()->GetInt64());
+  } else if (json()->IsUint64()) {
+    *v = dap::integer(static_cast<int64_t>(json()->GetUint64()));
   } else if (json()->IsString()) {
-    *v = dap::string(json()->GetString());
+    *v = dap::string(json()->GetString(), json()->GetStringLength());
   } else if (json()->IsNull()) {
     *v = null();
   } else if (json()->IsObject()) {
@@ -116,8 +210,26 @@ bool RapidDeserializer::deserialize(dap::any* v) const {
   return true;
 }
 
+bool RapidDeserializer::deserialize(dap::raw_json* v) const {
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+  if (!json()->Accept(writer)) {
+    return false;
+  }
+  *v = dap::raw_json(std::string(sb.GetString(), sb.GetSize()));
+  return true;
+}
+
+bool RapidDeserializer::deserialize(dap::bytes* v) const {
+  if (!json()->IsString()) {
+    return false;
+  }
+  v->clear();
+  return dap::base64Decode(json()->GetString(), json()->GetStringLength(), v);
+}
+
 size_t RapidDeserializer::count() const {
-  return json()->Size();
+  return json()->IsArray() ? json()->Size() : 0;
 }
 
 bool RapidDeserializer::array(
@@ -126,7 +238,7 @@ bool RapidDeserializer::array(
     return false;
   }
   for (uint32_t i = 0; i < json()->Size(); i++) {
-    RapidDeserializer d(&(*json())[i]);
+    RapidDeserializer d(&(*json())[i], pool);
     if (!cb(&d)) {
       return false;
     }
@@ -144,17 +256,19 @@ bool RapidDeserializer::field(
   if (it == json()->MemberEnd()) {
     return cb(&NullDeserializer::instance);
   }
-  RapidDeserializer d(&(it->value));
+  RapidDeserializer d(&(it->value), pool);
   return cb(&d);
 }
 
 RapidSerializer::RapidSerializer()
     : doc(new rapidjson::Document(rapidjson::kObjectType)),
-      allocator(doc->GetAllocator()) {}
+      allocator(doc->GetAllocator()),
+      raw(&rawValues) {}
 
 RapidSerializer::RapidSerializer(rapidjson::Value* json,
-                                 rapidjson::Document::AllocatorType& allocator)
-    : val(json), allocator(allocator) {}
+                                 rapidjson::Document::AllocatorType& allocator,
+                                 RawValues* raw)
+    : val(json), allocator(allocator), raw(raw) {}
 
 RapidSerializer::~RapidSerializer() {
   delete doc;
@@ -162,8 +276,10 @@ RapidSerializer::~RapidSerializer() {
 
 std::string RapidSerializer::dump() const {
   rapidjson::StringBuffer sb;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(sb);
-  json()->Accept(writer);
+  using Writer = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+  Writer writer(sb);
+  RawValueWriter<Writer> handler(&writer, raw);
+  json()->Accept(handler);
   return sb.GetString();
 }
 
@@ -197,7 +313,7 @@ bool RapidSerializer::serialize(const dap::object& v) {
       json()->AddMember(name_value, rapidjson::Value(), allocator);
     }
     rapidjson::Value& member = (*json())[it.first.c_str()];
-    RapidSerializer s(&member, allocator);
+    RapidSerializer s(&member, allocator, raw);
     if (!s.serialize(it.second)) {
       return false;
     }
@@ -232,6 +348,35 @@ bool RapidSerializer::serialize(const dap::any& v) {
   return true;
 }
 
+bool RapidSerializer::serialize(const dap::raw_json& v) {
+  // Hold the text in a string owned by the allocator, which dump() writes
+  // as is. The text is only validated, without building a document.
+  auto& text = v.str();
+  rapidjson::MemoryStream stream(text.data(), text.size());
+  rapidjson::BaseReaderHandler<> validator;
+  rapidjson::Reader reader;
+  if (reader.Parse(stream, validator).IsError()) {
+    return false;
+  }
+  auto str = static_cast<char*>(allocator.Malloc(text.size() + 1));
+  memcpy(str, text.data(), text.size());
+  str[text.size()] = '\0';
+  json()->SetString(
+      rapidjson::StringRef(str, static_cast<uint32_t>(text.size())));
+  raw->insert(str);
+  return true;
+}
+
+bool RapidSerializer::serialize(const dap::bytes& v) {
+  auto size = dap::base64EncodedSize(v.size());
+  auto str = static_cast<char*>(allocator.Malloc(size + 1));
+  dap::base64Encode(v.data(), v.size(), str);
+  str[size] = '\0';
+  // The string is owned by the allocator, which frees it with the document.
+  json()->SetString(rapidjson::StringRef(str, static_cast<uint32_t>(size)));
+  return true;
+}
+
 bool RapidSerializer::array(size_t count,
                             const std::function<bool(dap::Serializer*)>& cb) {
   if (!json()->IsArray()) {
@@ -243,7 +388,7 @@ bool RapidSerializer::array(size_t count,
   }
 
   for (uint32_t i = 0; i < count; i++) {
-    RapidSerializer s(&(*json())[i], allocator);
+    RapidSerializer s(&(*json())[i], allocator, raw);
     if (!cb(&s)) {
       return false;
     }
@@ -256,16 +401,19 @@ bool RapidSerializer::object(
   struct FS : public FieldSerializer {
     rapidjson::Value* const json;
     rapidjson::Document::AllocatorType& allocator;
+    RawValues* const raw;
 
-    FS(rapidjson::Value* json, rapidjson::Document::AllocatorType& allocator)
-        : json(json), allocator(allocator) {}
+    FS(rapidjson::Value* json,
+       rapidjson::Document::AllocatorType& allocator,
+       RawValues* raw)
+        : json(json), allocator(allocator), raw(raw) {}
     bool field(const std::string& name, const SerializeFunc& cb) override {
       if (!json->HasMember(name.c_str())) {
         rapidjson::Value name_value{name.c_str(), allocator};
         json->AddMember(name_value, rapidjson::Value(), allocator);
       }
       rapidjson::Value& member = (*json)[name.c_str()];
-      RapidSerializer s(&member, allocator);
+      RapidSerializer s(&member, allocator, raw);
       auto res = cb(&s);
       if (s.removed) {
         json->RemoveMember(name.c_str());
@@ -277,7 +425,7 @@ bool RapidSerializer::object(
   if (!json()->IsObject()) {
     json()->SetObject();
   }
-  FS fs{json(), allocator};
+  FS fs{json(), allocator, raw};
   return cb(&fs);
 }
 
@@ -21,20 +21,27 @@
 
 #include <rapidjson/document.h>
 
+#include <unordered_set>
+
 namespace dap {
 namespace json {
 
 struct RapidDeserializer : public dap::Deserializer {
-  explicit RapidDeserializer(const std::string&);
+  explicit RapidDeserializer(const std::string&, StringPool* pool = nullptr);
   ~RapidDeserializer();
 
   // dap::Deserializer compliance
+  Kind kind() const override;
+  StringPool* stringPool() const override;
   bool deserialize(boolean* v) const override;
   bool deserialize(integer* v) const override;
   bool deserialize(number* v) const override;
   bool deserialize(string* v) const override;
   bool deserialize(object* v) const override;
   bool deserialize(any* v) const override;
+  bool deserialize(raw_json* v) const override;
+  bool deserialize(bytes* v) const override;
+  bool deserialize(interned_string* v) const override;
   size_t count() const override;
   bool array(const std::function<bool(dap::Deserializer*)>&) const override;
   bool field(const std::string& name,
@@ -75,9 +82,10 @@ struct RapidDeserializer : public dap::Deserializer {
   inline rapidjson::Value* json() const { return (val == nullptr) ? doc : val; }
 
  private:
-  RapidDeserializer(rapidjson::Value*);
+  RapidDeserializer(rapidjson::Value*, StringPool* pool);
   rapidjson::Document* const doc = nullptr;
   rapidjson::Value* const val = nullptr;
+  StringPool* const pool;
 };
 
 struct RapidSerializer : public dap::Serializer {
@@ -93,6 +101,8 @@ struct RapidSerializer : public dap::Serializer {
   bool serialize(const string& v) override;
   bool serialize(const dap::object& v) override;
   bool serialize(const any& v) override;
+  bool serialize(const raw_json& v) override;
+  bool serialize(const bytes& v) override;
   bool array(size_t count,
              const std::function<bool(dap::Serializer*)>&) override;
   bool object(const std::function<bool(dap::FieldSerializer*)>&) override;
@@ -125,10 +135,18 @@ struct RapidSerializer : public dap::Serializer {
   inline rapidjson::Value* json() const { return (val == nullptr) ? doc : val; }
 
  private:
-  RapidSerializer(rapidjson::Value*, rapidjson::Document::AllocatorType&);
+  using RawValues = std::unordered_set<const char*>;
+
+  RapidSerializer(rapidjson::Value*,
+                  rapidjson::Document::AllocatorType&,
+                  RawValues* raw);
   rapidjson::Document* const doc = nullptr;
   rapidjson::Value* const val = nullptr;
   rapidjson::Document::AllocatorType& allocator;
+  // The strings of the document that hold the text of dap::raw_json values,
+  // which dump() writes without quoting. Owned by the root serializer.
+  RawValues rawValues;
+  RawValues* const raw;
   bool removed = false;
 };
 
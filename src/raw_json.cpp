@@ -0,0 +1,42 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/raw_json.h"
+
+#include "json_serializer.h"
+
+namespace dap {
+
+raw_json raw_json::create(const TypeInfo* typeinfo, const void* value) {
+  json::Serializer s;
+  if (!typeinfo->serialize(&s, value)) {
+    return raw_json();
+  }
+  return raw_json(s.dump());
+}
+
+bool raw_json::get(const TypeInfo* typeinfo, void* out) const {
+  json::Deserializer d(json);
+  return typeinfo->deserialize(&d, out);
+}
+
+bool Deserializer::deserialize(raw_json*) const {
+  return false;
+}
+
+bool Serializer::serialize(const raw_json&) {
+  return false;
+}
+
+}  // namespace dap
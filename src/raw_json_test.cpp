@@ -0,0 +1,97 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/raw_json.h"
+#include "json_serializer.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace dap {
+
+struct RawJSONTestObject {
+  string name;
+  raw_json config;
+  optional<raw_json> data;
+};
+
+DAP_STRUCT_TYPEINFO(RawJSONTestObject,
+                    "raw-json-test-object",
+                    DAP_FIELD(name, "name"),
+                    DAP_FIELD(config, "config"),
+                    DAP_FIELD(data, "data"));
+
+}  // namespace dap
+
+TEST(RawJSON, Default) {
+  dap::raw_json json;
+  ASSERT_EQ(json.str(), "null");
+  dap::null null;
+  ASSERT_TRUE(json.get(&null));
+}
+
+TEST(RawJSON, Passthrough) {
+  auto text = R"({"name":"launch","config":{"args":["a","b"],"stop":true}})";
+  dap::json::Deserializer d(text);
+  dap::RawJSONTestObject obj;
+  ASSERT_TRUE(d.deserialize(&obj));
+  ASSERT_EQ(obj.name, "launch");
+  ASSERT_EQ(obj.config.str(), R"({"args":["a","b"],"stop":true})");
+  ASSERT_FALSE(obj.data.has_value());
+
+  dap::json::Serializer s;
+  ASSERT_TRUE(s.serialize(obj));
+  dap::json::Deserializer out(s.dump());
+  dap::raw_json config;
+  ASSERT_TRUE(out.field("config", &config));
+  ASSERT_EQ(config.str(), obj.config.str());
+}
+
+TEST(RawJSON, Get) {
+  auto config = dap::raw_json(R"({"args":["a","b"],"stop":true})");
+  dap::object obj;
+  ASSERT_TRUE(config.get(&obj));
+  ASSERT_EQ(obj.size(), 2u);
+  ASSERT_TRUE(obj["stop"].is<dap::boolean>());
+  ASSERT_TRUE(obj["stop"].get<dap::boolean>());
+
+  dap::string str;
+  ASSERT_FALSE(dap::raw_json("1").get(&str));
+}
+
+TEST(RawJSON, Create) {
+  dap::array<dap::integer> in = {1, 2, 3};
+  auto json = dap::raw_json::create(in);
+  dap::array<dap::integer> out;
+  ASSERT_TRUE(json.get(&out));
+  ASSERT_EQ(out, in);
+}
+
+TEST(RawJSON, SerializeInvalid) {
+  dap::RawJSONTestObject obj;
+  obj.config = dap::raw_json("{");
+  dap::json::Serializer s;
+  ASSERT_FALSE(s.serialize(obj));
+}
+
+#if !defined(CPPDAP_JSON_JSONCPP)
+TEST(RawJSON, SerializeVerbatim) {
+  // The text is written as is, not parsed and reformatted.
+  dap::RawJSONTestObject obj;
+  obj.config = dap::raw_json(R"({ "n" : 1.50 })");
+  dap::json::Serializer s;
+  ASSERT_TRUE(s.serialize(obj));
+  ASSERT_THAT(s.dump(), testing::HasSubstr(R"({ "n" : 1.50 })"));
+}
+#endif  // !defined(CPPDAP_JSON_JSONCPP)
@@ -0,0 +1,467 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/record.h"
+#include "dap/io.h"
+
+#include "content_stream.h"
+#include "json_string.h"
+#include "session_stats.h"
+
+#include <string.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const char kMagic[] = "DAPREC01";
+const size_t kMagicLen = sizeof(kMagic) - 1;
+const size_t kRecordHeaderLen = 1 + 8 + 4;
+
+// putLE() appends the little-endian encoding of value, of the given number of
+// bytes, to out.
+void putLE(std::string& out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) {
+    out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+  }
+}
+
+// getLE() returns the little-endian integer, of the given number of bytes, at
+// data.
+uint64_t getLE(const char* data, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; i++) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (i * 8);
+  }
+  return value;
+}
+
+class RecordingReaderWriter : public dap::ReaderWriter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  RecordingReaderWriter(const std::shared_ptr<dap::ReaderWriter>& rw,
+                        const std::shared_ptr<dap::Writer>& capture)
+      : rw(rw), capture(capture), start(Clock::now()) {
+    capture->write(kMagic, kMagicLen);
+  }
+
+  bool isOpen() override { return rw->isOpen(); }
+
+  void close() override { rw->close(); }
+
+  size_t read(void* buffer, size_t n) override {
+    auto count = rw->read(buffer, n);
+    if (count > 0) {
+      std::unique_lock<std::mutex> lock(mutex);
+      received.feed(buffer, count);
+      flush(received, dap::Recording::kReceived);
+    }
+    return count;
+  }
+
+  bool write(const void* buffer, size_t n) override {
+    if (!rw->write(buffer, n)) {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    sent.feed(buffer, n);
+    flush(sent, dap::Recording::kSent);
+    return true;
+  }
+
+ private:
+  // flush() writes a record for each complete message held by decoder to the
+  // capture.
+  void flush(dap::ContentDecoder& decoder,
+             dap::Recording::Direction direction) {
+    std::string content;
+    while (decoder.next(content)) {
+      auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Clock::now() - start);
+      std::string record;
+      record.reserve(kRecordHeaderLen + content.size());
+      putLE(record, static_cast<uint64_t>(direction), 1);
+      putLE(record, static_cast<uint64_t>(time.count()), 8);
+      putLE(record, content.size(), 4);
+      record += content;
+      capture->write(record.data(), record.size());
+    }
+  }
+
+  const std::shared_ptr<dap::ReaderWriter> rw;
+  const std::shared_ptr<dap::Writer> capture;
+  const Clock::time_point start;
+  std::mutex mutex;
+  dap::ContentDecoder received;  // guarded by mutex
+  dap::ContentDecoder sent;      // guarded by mutex
+};
+
+class IndexedRecording : public dap::Recording {
+ public:
+  // Entry is the index entry of a single recorded message.
+  struct Entry {
+    Direction direction;
+    std::chrono::nanoseconds time;
+    size_t offset;  // offset of the content in data
+    size_t length;  // length of the content
+  };
+
+  IndexedRecording(std::string&& data) : data(std::move(data)) {
+    size_t pos = kMagicLen;
+    while (this->data.size() - pos >= kRecordHeaderLen) {
+      auto header = this->data.data() + pos;
+      Entry entry;
+      entry.direction = getLE(header, 1) == kSent ? kSent : kReceived;
+      entry.time = std::chrono::nanoseconds(getLE(header + 1, 8));
+      entry.length = static_cast<size_t>(getLE(header + 9, 4));
+      entry.offset = pos + kRecordHeaderLen;
+      if (this->data.size() - entry.offset < entry.length) {
+        break;  // Truncated
+      }
+      index.push_back(entry);
+      pos = entry.offset + entry.length;
+    }
+  }
+
+  size_t count() const override { return index.size(); }
+
+  Message get(size_t i) const override {
+    auto& entry = index[i];
+    Message message;
+    message.direction = entry.direction;
+    message.time = entry.time;
+    message.content = data.substr(entry.offset, entry.length);
+    return message;
+  }
+
+ private:
+  const std::string data;
+  std::vector<Entry> index;
+};
+
+// Header holds the fields of a message used by replay().
+struct Header {
+  dap::string type;
+  dap::integer seq = 0;
+  dap::string command;
+  dap::integer request_seq = 0;
+  dap::boolean success = false;
+};
+
+// readString() decodes the JSON string value text, returning false if it is
+// not a string.
+bool readString(const char* value, size_t size, dap::string* out) {
+  if (size < 2 || value[0] != '"' || value[size - 1] != '"') {
+    return false;
+  }
+  out->clear();
+  return dap::json::unescapeString(value + 1, size - 2, out);
+}
+
+// readInteger() decodes the JSON integer value text, returning false if it is
+// not an integer.
+bool readInteger(const char* value, size_t size, dap::integer* out) {
+  bool negative = size > 0 && value[0] == '-';
+  size_t i = negative ? 1 : 0;
+  if (i == size) {
+    return false;
+  }
+  uint64_t v = 0;
+  for (; i < size; i++) {
+    if (value[i] < '0' || value[i] > '9' || v > uint64_t(INT64_MAX) / 10) {
+      return false;
+    }
+    v = v * 10 + uint64_t(value[i] - '0');
+  }
+  if (v > uint64_t(INT64_MAX)) {
+    return false;
+  }
+  *out = negative ? -int64_t(v) : int64_t(v);
+  return true;
+}
+
+// parse() returns the Header of the message content. Only the header fields
+// are decoded, with dap::json::readMembers(), so that the message bodies are
+// not parsed.
+Header parse(const std::string& content) {
+  Header header;
+  dap::json::readMembers(
+      content.data(), content.size(),
+      [&](const std::string& name, const char* value, size_t size) {
+        if (name == "type") {
+          readString(value, size, &header.type);
+        } else if (name == "seq") {
+          readInteger(value, size, &header.seq);
+        } else if (name == "command") {
+          readString(value, size, &header.command);
+        } else if (name == "request_seq") {
+          readInteger(value, size, &header.request_seq);
+        } else if (name == "success") {
+          header.success = size == 4 && memcmp(value, "true", 4) == 0;
+        }
+        return true;
+      });
+  return header;
+}
+
+// setInteger() assigns value to the integer field with the given name of the
+// JSON object held by content, leaving the rest of the content unchanged.
+// Fields of nested objects are ignored. Returns false if the object has no
+// such integer field.
+bool setInteger(std::string* content, const char* name, int64_t value) {
+  bool found = false;
+  size_t start = 0;
+  size_t length = 0;
+  dap::json::readMembers(
+      content->data(), content->size(),
+      [&](const std::string& member, const char* text, size_t size) {
+        if (member != name) {
+          return true;
+        }
+        dap::integer old;
+        found = readInteger(text, size, &old);
+        start = static_cast<size_t>(text - content->data());
+        length = size;
+        return false;
+      });
+  if (!found) {
+    return false;
+  }
+  content->replace(start, length, std::to_string(value));
+  return true;
+}
+
+// Replayer holds the state of a call to replay().
+class Replayer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  Replayer(const dap::Recording& recording,
+           const std::shared_ptr<dap::ReaderWriter>& rw,
+           const dap::ReplayOptions& options)
+      : recording(recording), rw(rw), options(options), writer(rw) {}
+
+  dap::ReplayResult run() {
+    auto start = Clock::now();
+    std::thread thread([this] { receive(); });
+
+    // The request sequence numbers of the recorded responses that arrived
+    // since the last message was sent.
+    std::vector<dap::integer> pending;
+    // The number of recorded requests from the adapter, by command.
+    std::map<std::string, size_t> numAdapterRequests;
+    dap::integer nextSeq = 1;
+    for (size_t i = 0; i < recording.count(); i++) {
+      auto message = recording.get(i);
+      auto header = parse(message.content);
+      if (message.direction != options.send) {
+        if (header.type == "response") {
+          expected.emplace(header.request_seq, header);
+          pending.push_back(header.request_seq);
+        } else if (header.type == "request") {
+          auto index = numAdapterRequests[header.command]++;
+          adapterRequests.emplace(header.seq,
+                                  std::make_pair(header.command, index));
+        }
+        continue;
+      }
+
+      for (auto seq : pending) {
+        wait(seq);
+      }
+      pending.clear();
+
+      if (options.speed > 0) {
+        auto at = start + std::chrono::duration_cast<Clock::duration>(
+                              message.time / options.speed);
+        std::this_thread::sleep_until(at);
+      }
+
+      // Renumber the message, so that the adapter sees the sequence numbers
+      // of this session. A response to a request from the adapter refers to
+      // the replayed request.
+      auto seq = nextSeq++;
+      setInteger(&message.content, "seq", seq);
+      if (header.type == "response") {
+        auto request = adapterRequests.find(header.request_seq);
+        if (request != adapterRequests.end()) {
+          auto replayed = waitForAdapterRequest(request->second.first,
+                                                request->second.second);
+          if (replayed != 0) {
+            setInteger(&message.content, "request_seq", replayed);
+          }
+        }
+      }
+
+      if (header.type == "request") {
+        std::unique_lock<std::mutex> lock(mutex);
+        replayedSeqs[header.seq] = seq;
+        sentAt[seq] = Clock::now();
+        result.requests++;
+      }
+      writer.write(message.content);
+    }
+
+    for (auto& it : expected) {
+      wait(it.first);
+    }
+
+    rw->close();
+    thread.join();
+
+    for (auto& it : expected) {
+      auto& want = it.second;
+      auto replayed = replayedSeqs.find(it.first);
+      if (replayed == replayedSeqs.end()) {
+        continue;  // The recording does not hold the request.
+      }
+      auto got = received.find(replayed->second);
+      if (got == received.end()) {
+        result.missing++;
+        result.errors.push_back("missing response to '" + want.command +
+                                "' request " + std::to_string(it.first));
+      } else if (got->second.command != want.command ||
+                 got->second.success != want.success) {
+        result.mismatched++;
+        result.errors.push_back(
+            "response to '" + want.command + "' request " +
+            std::to_string(it.first) + " was '" + got->second.command +
+            "' with success " + (got->second.success ? "true" : "false") +
+            ", expected success " + (want.success ? "true" : "false"));
+      }
+    }
+
+    result.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start);
+    result.latency = latency.get();
+    return result;
+  }
+
+ private:
+  // receive() reads the adapter's messages until rw is closed.
+  void receive() {
+    dap::ContentReader reader(rw);
+    while (true) {
+      auto content = reader.read();
+      if (content.empty()) {
+        return;
+      }
+      auto header = parse(content);
+      if (header.type == "request") {
+        std::unique_lock<std::mutex> lock(mutex);
+        replayedAdapterRequests[header.command].push_back(header.seq);
+        cv.notify_all();
+        continue;
+      }
+      if (header.type != "response") {
+        continue;
+      }
+      auto now = Clock::now();
+      std::unique_lock<std::mutex> lock(mutex);
+      auto sent = sentAt.find(header.request_seq);
+      if (sent != sentAt.end()) {
+        latency.record(now - sent->second);
+      }
+      result.responses++;
+      received.emplace(header.request_seq, header);
+      cv.notify_all();
+    }
+  }
+
+  // wait() blocks until the response to the recorded request with the given
+  // sequence number has been received, or the timeout has elapsed. Returns
+  // immediately if the request was not sent.
+  void wait(dap::integer recordedSeq) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto replayed = replayedSeqs.find(recordedSeq);
+    if (replayed == replayedSeqs.end()) {
+      return;
+    }
+    auto seq = replayed->second;
+    cv.wait_for(lock, options.timeout,
+                [&] { return received.count(seq) > 0; });
+  }
+
+  // waitForAdapterRequest() blocks until the adapter has sent index + 1
+  // requests with the given command, or the timeout has elapsed. Returns the
+  // sequence number of the last of these requests, or 0 on timeout.
+  dap::integer waitForAdapterRequest(const std::string& command,
+                                     size_t index) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto& seqs = replayedAdapterRequests[command];
+    if (!cv.wait_for(lock, options.timeout,
+                     [&] { return seqs.size() > index; })) {
+      return 0;
+    }
+    return seqs[index];
+  }
+
+  const dap::Recording& recording;
+  const std::shared_ptr<dap::ReaderWriter> rw;
+  const dap::ReplayOptions options;
+  dap::ContentWriter writer;
+  dap::AtomicHistogram latency;
+  std::map<dap::integer, Header> expected;  // recorded responses
+  // The command, and index among the requests with the same command, of the
+  // recorded requests from the adapter, by recorded sequence number.
+  std::map<dap::integer, std::pair<std::string, size_t>> adapterRequests;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  dap::ReplayResult result;                          // guarded by mutex
+  // The replayed sequence numbers of the sent requests, by recorded sequence
+  // number.
+  std::map<dap::integer, dap::integer> replayedSeqs;  // guarded by mutex
+  // The send times and responses of the sent requests, by replayed sequence
+  // number.
+  std::map<dap::integer, Clock::time_point> sentAt;  // guarded by mutex
+  std::map<dap::integer, Header> received;           // guarded by mutex
+  // The sequence numbers of the requests from the adapter, by command.
+  std::map<std::string, std::vector<dap::integer>>
+      replayedAdapterRequests;  // guarded by mutex
+};
+
+}  // anonymous namespace
+
+namespace dap {
+
+std::shared_ptr<ReaderWriter> record(const std::shared_ptr<ReaderWriter>& rw,
+                                     const std::shared_ptr<Writer>& capture) {
+  return std::make_shared<RecordingReaderWriter>(rw, capture);
+}
+
+Recording::~Recording() = default;
+
+std::unique_ptr<Recording> Recording::load(const std::shared_ptr<Reader>& r) {
+  std::string data;
+  char buffer[4096];
+  while (auto n = r->read(buffer, sizeof(buffer))) {
+    data.append(buffer, n);
+  }
+  if (data.size() < kMagicLen || data.compare(0, kMagicLen, kMagic) != 0) {
+    return nullptr;
+  }
+  return std::unique_ptr<Recording>(new IndexedRecording(std::move(data)));
+}
+
+ReplayResult replay(const Recording& recording,
+                    const std::shared_ptr<ReaderWriter>& rw,
+                    const ReplayOptions& options /* = {} */) {
+  return Replayer(recording, rw, options).run();
+}
+
+}  // namespace dap
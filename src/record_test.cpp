@@ -0,0 +1,213 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/record.h"
+#include "dap/io.h"
+#include "dap/protocol.h"
+#include "dap/session.h"
+
+#include "string_buffer.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+namespace {
+
+// recordSession() returns a capture of a client that sends count evaluate
+// requests to a server.
+std::shared_ptr<dap::StringBuffer> recordSession(int count) {
+  std::shared_ptr<dap::StringBuffer> capture = dap::StringBuffer::create();
+  auto client = dap::Session::create();
+  auto server = dap::Session::create();
+  server->registerHandler([](const dap::EvaluateRequest& request) {
+    dap::EvaluateResponse response;
+    response.result = request.expression;
+    return response;
+  });
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->bind(dap::record(
+      dap::ReaderWriter::create(server2client, client2server), capture));
+  server->bind(client2server, server2client);
+
+  for (int i = 0; i < count; i++) {
+    dap::EvaluateRequest request;
+    request.expression = "expr" + std::to_string(i);
+    EXPECT_FALSE(client->send(request).get().error);
+  }
+  client.reset();
+  server.reset();
+  return capture;
+}
+
+// replaySession() replays the recording to a server that responds to
+// evaluate requests, or responds with an error if fail is true.
+dap::ReplayResult replaySession(const dap::Recording& recording, bool fail) {
+  auto server = dap::Session::create();
+  server->registerHandler(
+      [&](const dap::EvaluateRequest&)
+          -> dap::ResponseOrError<dap::EvaluateResponse> {
+        if (fail) {
+          return dap::Error("failed");
+        }
+        return dap::EvaluateResponse{};
+      });
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  server->bind(client2server, server2client);
+
+  dap::ReplayOptions options;
+  options.speed = 0;
+  return dap::replay(recording,
+                     dap::ReaderWriter::create(server2client, client2server),
+                     options);
+}
+
+// ReverseRequestAdapter responds to evaluate requests once the client has
+// responded to a runInTerminal request. If sendEvent is true, an output event
+// is sent first, so the runInTerminal request has a different sequence number.
+class ReverseRequestAdapter {
+ public:
+  ReverseRequestAdapter(const std::shared_ptr<dap::ReaderWriter>& rw,
+                        bool sendEvent)
+      : session(dap::Session::create()) {
+    session->registerHandler(
+        [this, sendEvent](
+            const dap::EvaluateRequest&,
+            std::function<void(dap::ResponseOrError<dap::EvaluateResponse>)>
+                respond) {
+          thread = std::thread([this, sendEvent, respond] {
+            if (sendEvent) {
+              session->send(dap::OutputEvent{});
+            }
+            auto got = session->send(dap::RunInTerminalRequest{}).get();
+            if (got.error) {
+              respond(dap::Error("runInTerminal failed"));
+            } else {
+              respond(dap::EvaluateResponse{});
+            }
+          });
+        });
+    session->bind(rw);
+  }
+
+  ~ReverseRequestAdapter() {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+ private:
+  std::unique_ptr<dap::Session> session;
+  std::thread thread;
+};
+
+}  // anonymous namespace
+
+TEST(Record, Capture) {
+  auto recording = dap::Recording::load(recordSession(3));
+  ASSERT_NE(recording, nullptr);
+  ASSERT_EQ(recording->count(), 6U);
+
+  std::chrono::nanoseconds last(0);
+  for (size_t i = 0; i < recording->count(); i++) {
+    auto message = recording->get(i);
+    auto expr = "expr" + std::to_string(i / 2);
+    if (i % 2 == 0) {
+      ASSERT_EQ(message.direction, dap::Recording::kSent);
+      ASSERT_THAT(message.content, testing::HasSubstr("\"request\""));
+    } else {
+      ASSERT_EQ(message.direction, dap::Recording::kReceived);
+      ASSERT_THAT(message.content, testing::HasSubstr("\"response\""));
+    }
+    ASSERT_THAT(message.content, testing::HasSubstr(expr));
+    ASSERT_GE(message.time, last);
+    last = message.time;
+  }
+}
+
+TEST(Record, LoadInvalid) {
+  std::shared_ptr<dap::StringBuffer> buffer = dap::StringBuffer::create();
+  buffer->write("Content-Length: 2\r\n\r\n{}");
+  ASSERT_EQ(dap::Recording::load(buffer), nullptr);
+}
+
+TEST(Record, LoadTruncated) {
+  auto capture = recordSession(1)->string();
+  std::shared_ptr<dap::StringBuffer> buffer = dap::StringBuffer::create();
+  buffer->write(capture.substr(0, capture.size() - 1));
+  auto recording = dap::Recording::load(buffer);
+  ASSERT_NE(recording, nullptr);
+  ASSERT_EQ(recording->count(), 1U);
+  ASSERT_EQ(recording->get(0).direction, dap::Recording::kSent);
+}
+
+TEST(Record, Replay) {
+  auto recording = dap::Recording::load(recordSession(3));
+  auto result = replaySession(*recording, false);
+  ASSERT_EQ(result.requests, 3U);
+  ASSERT_EQ(result.responses, 3U);
+  ASSERT_EQ(result.mismatched, 0U);
+  ASSERT_EQ(result.missing, 0U);
+  ASSERT_TRUE(result.errors.empty());
+  ASSERT_EQ(result.latency.count, 3U);
+}
+
+TEST(Record, ReplayMismatch) {
+  auto recording = dap::Recording::load(recordSession(2));
+  auto result = replaySession(*recording, true);
+  ASSERT_EQ(result.requests, 2U);
+  ASSERT_EQ(result.responses, 2U);
+  ASSERT_EQ(result.mismatched, 2U);
+  ASSERT_EQ(result.missing, 0U);
+  ASSERT_EQ(result.errors.size(), 2U);
+  ASSERT_THAT(result.errors[0], testing::HasSubstr("evaluate"));
+}
+
+TEST(Record, ReplayReverseRequest) {
+  std::shared_ptr<dap::StringBuffer> capture = dap::StringBuffer::create();
+  {
+    auto client = dap::Session::create();
+    client->registerHandler([](const dap::RunInTerminalRequest&) {
+      return dap::RunInTerminalResponse{};
+    });
+    auto client2server = dap::pipe();
+    auto server2client = dap::pipe();
+    ReverseRequestAdapter adapter(
+        dap::ReaderWriter::create(client2server, server2client), false);
+    client->bind(dap::record(
+        dap::ReaderWriter::create(server2client, client2server), capture));
+    ASSERT_FALSE(client->send(dap::EvaluateRequest{}).get().error);
+  }
+
+  auto recording = dap::Recording::load(capture);
+  ASSERT_NE(recording, nullptr);
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  ReverseRequestAdapter adapter(
+      dap::ReaderWriter::create(client2server, server2client), true);
+  dap::ReplayOptions options;
+  options.speed = 0;
+  auto result = dap::replay(
+      *recording, dap::ReaderWriter::create(server2client, client2server),
+      options);
+  ASSERT_EQ(result.requests, 1U);
+  ASSERT_EQ(result.responses, 1U);
+  ASSERT_EQ(result.mismatched, 0U);
+  ASSERT_TRUE(result.errors.empty());
+}
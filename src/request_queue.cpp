@@ -0,0 +1,50 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "request_queue.h"
+
+namespace dap {
+
+RequestQueue::RequestQueue(RequestPolicy policy) : policy(policy) {}
+
+bool RequestQueue::coalesce(const std::string& key, integer seq) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto& waiting = inflight[key];
+  waiting.push_back(seq);
+  return waiting.size() == 1;
+}
+
+std::vector<integer> RequestQueue::complete(const std::string& key) {
+  std::unique_lock<std::mutex> lock(mutex);
+  std::vector<integer> waiting;
+  auto it = inflight.find(key);
+  if (it != inflight.end()) {
+    waiting = std::move(it->second);
+    inflight.erase(it);
+  }
+  return waiting;
+}
+
+void RequestQueue::setLatest(integer seq) {
+  std::unique_lock<std::mutex> lock(mutex);
+  latest = seq;
+}
+
+bool RequestQueue::superseded(integer seq) {
+  std::unique_lock<std::mutex> lock(mutex);
+  return latest != seq;
+}
+
+}  // namespace dap
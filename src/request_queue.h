@@ -0,0 +1,68 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef dap_request_queue_h
+#define dap_request_queue_h
+
+#include "dap/session.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dap {
+
+// RequestQueue holds the dispatch state for a single request command that has
+// a RequestPolicy other than kDispatchAll, as set by
+// Session::setRequestPolicy().
+class RequestQueue {
+ public:
+  explicit RequestQueue(RequestPolicy policy);
+
+  // coalesce() adds the request with the sequence number seq to the requests
+  // waiting on the response for the arguments with the given key, for
+  // kCoalesce. Returns true if no request with the key is in flight, in which
+  // case the caller dispatches the request, or false if the request was
+  // coalesced with the one in flight.
+  bool coalesce(const std::string& key, integer seq);
+
+  // complete() removes and returns the sequence numbers of the requests
+  // waiting on the response for the arguments with the given key, once the
+  // handler has produced the response.
+  std::vector<integer> complete(const std::string& key);
+
+  // setLatest() records seq as the most recently received request, for
+  // kLatestWins.
+  void setLatest(integer seq);
+
+  // superseded() returns true if a request was received after the request
+  // with the sequence number seq.
+  bool superseded(integer seq);
+
+  const RequestPolicy policy;
+
+ private:
+  std::mutex mutex;
+  // The sequence numbers of the requests waiting on the response of the
+  // in-flight request, keyed by the serialized request arguments.
+  std::unordered_map<std::string, std::vector<integer>> inflight;
+  // The sequence number of the most recently received request.
+  integer latest = 0;
+};
+
+}  // namespace dap
+
+#endif  // dap_request_queue_h
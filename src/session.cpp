@@ -15,26 +15,62 @@
 #include "content_stream.h"
 
 #include "dap/any.h"
+#include "dap/interned_string.h"
 #include "dap/session.h"
+#include "dap/tracer.h"
 
 #include "chan.h"
+#include "frozen_map.h"
 #include "json_serializer.h"
+#include "json_string.h"
+#include "outbox.h"
+#include "output_aggregator.h"
+#include "output_event.h"
+#include "pending_requests.h"
+#include "published.h"
+#include "request_queue.h"
+#include "session_stats.h"
 #include "socket.h"
+#include "stats_reporter.h"
+#include "strand.h"
+#include "timer_wheel.h"
 
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include <atomic>
-#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace {
 
+// kOutputMessageOverhead is the number of bytes reserved for the fields of an
+// OutputEvent message sent with sendOutput(), in addition to the output.
+const size_t kOutputMessageOverhead = 128;
+
+// kMaxOutputBuffer is the largest message buffer retained by a thread between
+// calls to sendOutput().
+const size_t kMaxOutputBuffer = 1 << 20;
+
+// appendInteger() appends the decimal text of v to out, without allocating.
+void appendInteger(int64_t v, std::string* out) {
+  char buf[24];
+  out->append(buf, snprintf(buf, sizeof(buf), "%" PRId64, v));
+}
+
 class Impl : public dap::Session {
  public:
+  Impl(const Options& options) {
+    if (options.executor) {
+      strand.reset(new dap::Strand(options.executor));
+    }
+  }
+
   void setOnInvalidData(dap::OnInvalidData onInvalidData_) override {
     this->onInvalidData = onInvalidData_;
   }
@@ -46,6 +82,11 @@ class Impl : public dap::Session {
     handlers.put(typeinfo, handler);
   }
 
+  void registerLazyHandler(const dap::TypeInfo* typeinfo,
+                           const GenericRequestHandler& handler) override {
+    handlers.put(typeinfo, handler, /* lazy */ true);
+  }
+
   void registerHandler(const dap::TypeInfo* typeinfo,
                        const GenericEventHandler& handler) override {
     handlers.put(typeinfo, handler);
@@ -56,10 +97,53 @@ class Impl : public dap::Session {
     handlers.put(typeinfo, handler);
   }
 
+  void setRequestPolicy(const dap::TypeInfo* typeinfo,
+                        dap::RequestPolicy policy) override {
+    handlers.put(typeinfo, policy);
+  }
+
+  void setDispatchMode(const dap::TypeInfo* typeinfo,
+                       dap::DispatchMode mode) override {
+    handlers.put(typeinfo, mode);
+  }
+
+  void freezeHandlers() override { handlers.freeze(); }
+
+  void setRequestTimeout(std::chrono::milliseconds timeout) override {
+    requestTimeout = timeout;
+  }
+
+  void setMaxPendingRequests(size_t max,
+                             std::chrono::milliseconds maxWait) override {
+    pending.setLimit(max, maxWait);
+  }
+
+  dap::PendingRequestStats pendingRequestStats() override {
+    return pending.stats();
+  }
+
+  dap::SessionStats stats() override {
+    dap::SessionStats out;
+    collector.get(out);
+    out.inboxDepth = numQueued.load(std::memory_order_relaxed);
+    auto outboxStats = outbox.stats();
+    out.outboxDepth = outboxStats.depth;
+    out.outboxRejected = outboxStats.rejected;
+    out.outboxWriteFailures = outboxStats.writeFailures;
+    out.pendingRequests = pending.stats();
+    return out;
+  }
+
+  void onStats(std::chrono::milliseconds interval,
+               const StatsHandler& callback) override {
+    statsReporter.set(interval, callback);
+  }
+
   std::function<void()> getPayload() override {
-    auto request = reader.read();
-    if (request.size() > 0) {
-      if (auto payload = processMessage(request)) {
+    ProcessingScope scope(this);
+    Incoming message;
+    if (read(message)) {
+      if (auto payload = receive(message)) {
         return payload;
       }
     }
@@ -75,6 +159,35 @@ class Impl : public dap::Session {
 
     reader = dap::ContentReader(r, this->onInvalidData);
     writer = dap::ContentWriter(w);
+    decoder = dap::ContentDecoder(this->onInvalidData);
+  }
+
+  std::vector<std::function<void()>> feed(const void* data,
+                                          size_t size) override {
+    ProcessingScope scope(this);
+    std::vector<std::function<void()>> payloads;
+    decoder.feed(data, size);
+    std::string content;
+    while (decoder.next(content)) {
+      auto now = Clock::now();
+      if (strand) {
+        // With an executor, the message is parsed and dispatched on the
+        // strand, so that no thread is needed for the session.
+        Incoming message;
+        message.content = std::move(content);
+        message.readStart = now;
+        message.readEnd = now;
+        message.readThread = dap::Tracer::currentThread();
+        post(message);
+      } else if (auto payload = receive(content, now, now,
+                                        dap::Tracer::currentThread())) {
+        payloads.emplace_back(std::move(payload));
+      }
+    }
+    if (!decoder.isValid()) {
+      writer.close();
+    }
+    return payloads;
   }
 
   void startProcessingMessages(
@@ -83,10 +196,41 @@ class Impl : public dap::Session {
       handlers.error("Session::startProcessingMessages() called twice");
       return;
     }
+    if (strand) {
+      // Only read the message content on the receive thread. Parsing and
+      // dispatch happen on the strand.
+      recvThread = std::thread([this, onClose] {
+        while (isOpen()) {
+          Incoming message;
+          if (read(message)) {
+            post(message);
+          }
+        }
+        if (onClose) {
+          onClose();
+        }
+      });
+      return;
+    }
+
     recvThread = std::thread([this, onClose] {
-      while (reader.isOpen()) {
-        if (auto payload = getPayload()) {
-          inbox.put(std::move(payload));
+      ProcessingScope scope(this);
+      while (isOpen()) {
+        Incoming message;
+        if (!read(message)) {
+          continue;
+        }
+        bool runInline = false;
+        if (auto payload = receive(message, &runInline)) {
+          // Only this thread increments numQueued, so if it is zero then all
+          // earlier payloads have been dispatched, and running this payload
+          // now preserves the message order.
+          if (runInline && numQueued.load(std::memory_order_acquire) == 0) {
+            payload();
+          } else {
+            numQueued.fetch_add(1, std::memory_order_relaxed);
+            inbox.put(std::move(payload));
+          }
         }
       }
       if (onClose) {
@@ -97,6 +241,7 @@ class Impl : public dap::Session {
     dispatchThread = std::thread([this] {
       while (auto payload = inbox.take()) {
         payload.value()();
+        numQueued.fetch_sub(1, std::memory_order_release);
       }
     });
   }
@@ -105,10 +250,75 @@ class Impl : public dap::Session {
             const dap::TypeInfo* responseTypeInfo,
             const void* request,
             const GenericResponseHandler& responseHandler) override {
-    int seq = nextSeq++;
+    return send(requestTypeInfo, responseTypeInfo, request, responseHandler,
+                requestTimeout.load());
+  }
 
-    handlers.put(seq, responseTypeInfo, responseHandler);
+  bool send(const dap::TypeInfo* requestTypeInfo,
+            const dap::TypeInfo* responseTypeInfo,
+            const void* request,
+            const GenericResponseHandler& responseHandler,
+            std::chrono::milliseconds timeout) override {
+    aggregator.flush();
+    uint32_t seq = 0;
+    if (pending.add(nextSeq, requestTypeInfo, responseTypeInfo,
+                    responseHandler, processing != this,
+                    &seq) != dap::PendingRequests::kAdded) {
+      return false;
+    }
+    if (timeout.count() < 0) {
+      timeout = requestTimeout.load();
+    }
+
+    if (timeout.count() > 0) {
+      auto timer = timers.schedule(timeout, [this, seq] {
+        timedOut(pending.expire(seq));
+      });
+      pending.setTimer(seq, timer);
+    }
 
+    if (!sendRequest(requestTypeInfo, request, seq)) {
+      // The caller reports the failure, so the request must not hold a slot
+      // under the limit, or be completed by its timer.
+      auto request = pending.discard(seq);
+      if (!request.handler) {
+        // The response has already arrived, so the request was sent.
+        return true;
+      }
+      if (request.timer != 0) {
+        timers.cancel(request.timer);
+      }
+      return false;
+    }
+    // Complete the request if it timed out while it was being written.
+    timedOut(pending.sent(seq));
+    return true;
+  }
+
+  // timedOut() calls the handler of the request with the timeout error, if
+  // the request is not empty.
+  static void timedOut(const dap::PendingRequests::Request& request) {
+    if (request.handler) {
+      auto error = dap::Error("Request timed out");
+      request.handler(nullptr, &error);
+    }
+  }
+
+  // sendRequest() sends the request with the given sequence number.
+  bool sendRequest(const dap::TypeInfo* requestTypeInfo,
+                   const void* request,
+                   uint32_t seq) {
+    if (linkOut) {
+      TypedMessage message;
+      message.kind = dap::SessionStatsCollector::kRequest;
+      message.seq = seq;
+      message.typeinfo = requestTypeInfo;
+      message.data = newObject(requestTypeInfo, request);
+      collector.sent(dap::SessionStatsCollector::kRequest, requestTypeInfo, 0);
+      return post(std::move(message), trace("request", requestTypeInfo, seq));
+    }
+
+    auto start = Clock::now();
     dap::json::Serializer s;
     if (!s.object([&](dap::FieldSerializer* fs) {
           return fs->field("seq", dap::integer(seq)) &&
@@ -120,41 +330,396 @@ class Impl : public dap::Session {
         })) {
       return false;
     }
-    return send(s.dump());
+    auto message = s.dump();
+    auto end = Clock::now();
+    collector.serialized(end - start);
+    collector.sent(dap::SessionStatsCollector::kRequest, requestTypeInfo,
+                   message.size());
+    auto traced = trace("request", requestTypeInfo, seq);
+    if (traced) {
+      traced->span("serialize", start, end);
+    }
+    return send(message, traced);
   }
 
   bool send(const dap::TypeInfo* typeinfo, const void* event) override {
-    dap::json::Serializer s;
-    if (!s.object([&](dap::FieldSerializer* fs) {
-          return fs->field("seq", dap::integer(nextSeq++)) &&
-                 fs->field("type", "event") &&
-                 fs->field("event", typeinfo->name()) &&
-                 fs->field("body", [&](dap::Serializer* s) {
-                   return typeinfo->serialize(s, event);
-                 });
-        })) {
+    if (typeinfo == dap::outputEventType() && aggregator.enabled()) {
+      return aggregator.add(event);
+    }
+    aggregator.flush();
+    if (conflateEvent(typeinfo, event)) {
+      return true;
+    }
+    return sendEvent(typeinfo, event);
+  }
+
+  bool send(const dap::SerializedEvent& event) override {
+    if (!event) {
       return false;
     }
-    return send(s.dump());
+    aggregator.flush();
+    auto typeinfo = event.typeinfo();
+    dap::integer seq = nextSeq++;
+    TracedPtr traced;
+    if (linkOut) {
+      // The paired session shares the copy of the event held by the
+      // SerializedEvent.
+      auto object = event.event();
+      auto ptr = static_cast<uint8_t*>(const_cast<void*>(object.get()));
+      auto message = typedEvent(typeinfo, Object(object, ptr), seq, &traced);
+      return post(std::move(message), traced);
+    }
+    auto message = event.message(seq);
+    collector.sent(dap::SessionStatsCollector::kEvent, typeinfo,
+                   message.size());
+    traced = trace("event", typeinfo, seq);
+    return send(message, traced);
+  }
+
+  bool sendOutput(const void* data,
+                  size_t size,
+                  const char* category) override {
+    auto typeinfo = dap::outputEventType();
+    auto output = static_cast<const char*>(data);
+    bool ok = false;
+    if (aggregator.enabled() && aggregator.add(category, output, size, &ok)) {
+      return ok;
+    }
+    aggregator.flush();
+    if (linkOut || conflates(typeinfo)) {
+      // The paired session takes the event itself, and the conflation key is
+      // computed from the event.
+      auto event = dap::newOutputEvent(category, output, size);
+      if (conflateEvent(typeinfo, event.get())) {
+        return true;
+      }
+      return sendEvent(typeinfo, event.get());
+    }
+    auto start = Clock::now();
+    dap::integer seq = nextSeq++;
+    // While the outbox is in use, the message is built in the entry that is
+    // queued. Otherwise it is built in a buffer owned by the calling thread,
+    // so forwarding output does not allocate once the buffer has grown.
+    thread_local std::string buffer;
+    OutboxEntry entry;
+    bool queue = outbox.inUse() && writer.isOpen();
+    auto& message = queue ? entry.message : buffer;
+    message.clear();
+    if (message.capacity() < size + kOutputMessageOverhead) {
+      message.reserve(size + kOutputMessageOverhead);
+    }
+    message += "{\"seq\":";
+    appendInteger(seq, &message);
+    message += ",\"type\":\"event\",\"event\":\"output\",\"body\":{";
+    if (category != nullptr) {
+      message += "\"category\":\"";
+      dap::json::escapeString(category, strlen(category), &message);
+      message += "\",";
+    }
+    message += "\"output\":\"";
+    dap::json::escapeString(output, size, &message);
+    message += "\"}}";
+    auto end = Clock::now();
+    collector.serialized(end - start);
+    collector.sent(dap::SessionStatsCollector::kEvent, typeinfo,
+                   message.size());
+    auto traced = trace("event", typeinfo, seq);
+    if (traced) {
+      traced->span("serialize", start, end);
+    }
+    if (queue) {
+      entry.traced = traced;
+      if (enqueue(std::move(entry), &ok)) {
+        return ok;
+      }
+      return write(entry.message, traced);  // The outbox is no longer used.
+    }
+    ok = send(buffer, traced);
+    if (buffer.capacity() > kMaxOutputBuffer) {
+      std::string().swap(buffer);
+    }
+    return ok;
+  }
+
+  void setEventConflation(const dap::TypeInfo* typeinfo,
+                          const ConflationKey& key) override {
+    std::unique_lock<std::mutex> lock(conflationMutex);
+    if (key) {
+      conflationKeys[typeinfo] = key;
+    } else {
+      conflationKeys.erase(typeinfo);
+    }
+    outbox.setActive(!conflationKeys.empty());
+  }
+
+  void setOutboxLimit(size_t maxMessages,
+                      std::chrono::milliseconds maxWait) override {
+    outbox.setLimit(maxMessages, maxWait);
+  }
+
+  void setTracer(const std::shared_ptr<dap::Tracer>& t) override {
+    tracer.set(t);
+  }
+
+  void setStringPool(const std::shared_ptr<dap::StringPool>& p) override {
+    stringPool.set(p);
+  }
+
+  void setOutputAggregation(std::chrono::milliseconds window,
+                            size_t maxBytes) override {
+    aggregator.setWindow(window, maxBytes);
+  }
+
+  // pair() connects the two sessions with in-process links, and starts
+  // processing their incoming messages.
+  static void pair(Session* sessionA,
+                   Session* sessionB,
+                   const ClosedHandler& onCloseA,
+                   const ClosedHandler& onCloseB) {
+    auto a = dynamic_cast<Impl*>(sessionA);
+    auto b = dynamic_cast<Impl*>(sessionB);
+    if (a == nullptr || b == nullptr) {
+      for (auto impl : {a, b}) {
+        if (impl != nullptr) {
+          impl->handlers.error(
+              "Session::pairInProcess called with a session not created by "
+              "Session::create()");
+        }
+      }
+      return;
+    }
+    if (a->isBound.exchange(true)) {
+      a->handlers.error("Session::pairInProcess called on a bound session");
+      return;
+    }
+    if (b->isBound.exchange(true)) {
+      b->handlers.error("Session::pairInProcess called on a bound session");
+      a->isBound = false;
+      return;
+    }
+    auto aToB = std::make_shared<InProcessLink>();
+    auto bToA = std::make_shared<InProcessLink>();
+    a->linkIn = bToA;
+    a->linkOut = aToB;
+    b->linkIn = aToB;
+    b->linkOut = bToA;
+    a->startProcessingMessages(onCloseA);
+    b->startProcessingMessages(onCloseB);
   }
 
   ~Impl() override {
+    onStats(std::chrono::milliseconds(0), {});
+    aggregator.close();
+    aggregator.flush();
+    outbox.close();
+    pending.close();
     inbox.close();
     reader.close();
     writer.close();
+    if (linkIn) {
+      linkIn->close();
+      linkOut->close();
+    }
     if (recvThread.joinable()) {
       recvThread.join();
     }
     if (dispatchThread.joinable()) {
       dispatchThread.join();
     }
+    if (strand) {
+      strand->close();
+    }
   }
 
  private:
+  using Clock = dap::SessionStatsCollector::Clock;
   using Payload = std::function<void()>;
 
+  // Object is a type-erased object that is destructed with its TypeInfo.
+  using Object = std::shared_ptr<uint8_t>;
+
+  // newObject() returns a new object of the given type, copy constructed from
+  // src, or default constructed if src is null.
+  static Object newObject(const dap::TypeInfo* typeinfo,
+                          const void* src = nullptr) {
+    auto object = Object(new uint8_t[typeinfo->size()],
+                         [typeinfo](uint8_t* ptr) {
+                           typeinfo->destruct(ptr);
+                           delete[] ptr;
+                         });
+    if (src != nullptr) {
+      typeinfo->copyConstruct(object.get(), src);
+    } else {
+      typeinfo->construct(object.get());
+    }
+    return object;
+  }
+
+  // TypedMessage is a message passed between sessions paired by
+  // pairInProcess(). It holds a copy of the request, response or event object
+  // instead of the serialized message.
+  struct TypedMessage {
+    dap::SessionStatsCollector::Kind kind =
+        dap::SessionStatsCollector::kRequest;
+    // The sequence number of the message, or of the request for a response.
+    dap::integer seq = 0;
+    // The type of the request, the response body or the event.
+    const dap::TypeInfo* typeinfo = nullptr;
+    // The type of the request, for a response.
+    const dap::TypeInfo* requestTypeInfo = nullptr;
+    Object data;       // null for an error response
+    dap::Error error;  // the error of an error response
+  };
+
+  // InProcessLink carries the messages sent by one session to the other
+  // session paired by pairInProcess().
+  struct InProcessLink {
+    // put() queues the message for the receiving session, returning false if
+    // the link has been closed.
+    bool put(TypedMessage&& message) {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!open) {
+        return false;
+      }
+      chan.put(std::move(message));
+      return true;
+    }
+
+    void close() {
+      std::unique_lock<std::mutex> lock(mutex);
+      open = false;
+      chan.close();
+    }
+
+    dap::Chan<TypedMessage> chan;
+    std::mutex mutex;                     // serializes put() and close()
+    std::atomic<bool> open = {true};      // false once closed
+    std::atomic<bool> drained = {false};  // true once closed and emptied
+  };
+
+  // Incoming is a message received from the connected endpoint.
+  struct Incoming {
+    std::string content;  // the message content, if not paired in-process
+    TypedMessage typed;   // the message, if paired in-process
+    Clock::time_point readStart;
+    Clock::time_point readEnd;
+    uint32_t readThread = 0;  // the dap::Tracer::currentThread() of the read
+  };
+
+  // LazyArguments are the RequestArguments passed to a lazy request handler.
+  class LazyArguments : public dap::RequestArguments {
+   public:
+    explicit LazyArguments(Impl* session) : session(session) {}
+
+    bool deserialize(const dap::TypeInfo* typeinfo, void* out) const override {
+      if (!decode(typeinfo, out)) {
+        session->handlers.error("Failed to deserialize request");
+        return false;
+      }
+      return true;
+    }
+
+    // decode() deserializes the arguments as the given type, into out, which
+    // holds a constructed object of the type. Unlike deserialize(), decode()
+    // does not report an error if the arguments fail to deserialize.
+    virtual bool decode(const dap::TypeInfo* typeinfo, void* out) const = 0;
+
+   private:
+    Impl* const session;
+  };
+
+  // JsonArguments are the arguments of a request received as JSON, which are
+  // deserialized from the retained parse tree of the message.
+  class JsonArguments : public LazyArguments {
+   public:
+    JsonArguments(Impl* session,
+                  const std::shared_ptr<const dap::json::Deserializer>& d)
+        : LazyArguments(session), message(d) {}
+
+    bool field(const std::string& name,
+               const std::function<bool(dap::Deserializer*)>& cb)
+        const override {
+      return message->field("arguments", [&](dap::Deserializer* d) {
+        return d->field(name, cb);
+      });
+    }
+
+    bool decode(const dap::TypeInfo* typeinfo, void* out) const override {
+      return message->field("arguments", [&](dap::Deserializer* d) {
+        return typeinfo->deserialize(d, out);
+      });
+    }
+
+   private:
+    const std::shared_ptr<const dap::json::Deserializer> message;
+  };
+
+  // TypedArguments are the arguments of a request received from the session
+  // paired in-process. Individual arguments are found by serializing the
+  // request, once, on the first call to field(). The handler may call field()
+  // from several threads, so the serialization is guarded by a once_flag.
+  class TypedArguments : public LazyArguments {
+   public:
+    TypedArguments(Impl* session,
+                   const dap::TypeInfo* typeinfo,
+                   const Object& request)
+        : LazyArguments(session), typeinfo(typeinfo), request(request) {}
+
+    bool field(const std::string& name,
+               const std::function<bool(dap::Deserializer*)>& cb)
+        const override {
+      std::call_once(serialized, [this] {
+        dap::json::Serializer s;
+        if (typeinfo->serialize(&s, request.get())) {
+          parsed.reset(new dap::json::Deserializer(s.dump()));
+        }
+      });
+      return parsed && parsed->field(name, cb);
+    }
+
+    bool decode(const dap::TypeInfo* to, void* out) const override {
+      auto converted = convert(typeinfo, request, to);
+      if (!converted) {
+        return false;
+      }
+      to->destruct(out);
+      to->copyConstruct(out, converted.get());
+      return true;
+    }
+
+   private:
+    const dap::TypeInfo* const typeinfo;
+    const Object request;
+    // The serialized request, parsed by the first call to field(), or null if
+    // the request could not be serialized.
+    mutable std::once_flag serialized;
+    mutable std::unique_ptr<const dap::json::Deserializer> parsed;
+  };
+
+  // argumentsObject() returns the arguments as the Object passed to a lazy
+  // request handler.
+  static Object argumentsObject(
+      const std::shared_ptr<const LazyArguments>& arguments) {
+    auto ptr = reinterpret_cast<uint8_t*>(
+        const_cast<LazyArguments*>(arguments.get()));
+    return Object(arguments, ptr);
+  }
+
+  // RequestHandler is the registered handler for a request command.
+  struct RequestHandler {
+    const dap::TypeInfo* typeinfo = nullptr;
+    GenericRequestHandler handler;
+    std::shared_ptr<dap::RequestQueue> queue;  // nullptr for kDispatchAll
+    dap::DispatchMode mode = dap::kQueued;
+    bool lazy = false;  // true if the handler takes the RequestArguments
+  };
+
   class EventHandlers {
    public:
+    // collector records the errors reported by error().
+    explicit EventHandlers(dap::SessionStatsCollector* collector)
+        : collector(collector) {}
+
     void put(const ErrorHandler& handler) {
       std::unique_lock<std::mutex> lock(errorMutex);
       errorHandler = handler;
@@ -168,88 +733,212 @@ class Impl : public dap::Session {
       va_end(vararg);
     }
 
-    std::pair<const dap::TypeInfo*, GenericRequestHandler> request(
-        const std::string& name) {
-      std::unique_lock<std::mutex> lock(requestMutex);
-      auto it = requestMap.find(name);
-      return (it != requestMap.end()) ? it->second : decltype(it->second){};
-    }
-
     void put(const dap::TypeInfo* typeinfo,
-             const GenericRequestHandler& handler) {
-      std::unique_lock<std::mutex> lock(requestMutex);
-      auto added =
-          requestMap
-              .emplace(typeinfo->name(), std::make_pair(typeinfo, handler))
-              .second;
-      if (!added) {
-        errorfLocked("Request handler for '%s' already registered",
-                     typeinfo->name().c_str());
-      }
-    }
-
-    std::pair<const dap::TypeInfo*, GenericResponseHandler> response(
-        int64_t seq) {
-      std::unique_lock<std::mutex> lock(responseMutex);
-      auto responseIt = responseMap.find(seq);
-      if (responseIt == responseMap.end()) {
-        errorfLocked("Unknown response with sequence %d", seq);
-        return {};
+             const GenericRequestHandler& handler,
+             bool lazy = false) {
+      {
+        std::unique_lock<std::mutex> lock(requestMutex);
+        auto added =
+            requestMap
+                .emplace(typeinfo->name(), std::make_pair(typeinfo, handler))
+                .second;
+        if (!added) {
+          errorfLocked("Request handler for '%s' already registered",
+                       typeinfo->name().c_str());
+        } else if (lazy) {
+          lazyRequests.emplace(typeinfo->name());
+        }
       }
-      auto out = std::move(responseIt->second);
-      responseMap.erase(seq);
-      return out;
+      refreeze();
     }
 
-    void put(int seq,
-             const dap::TypeInfo* typeinfo,
-             const GenericResponseHandler& handler) {
-      std::unique_lock<std::mutex> lock(responseMutex);
-      auto added =
-          responseMap.emplace(seq, std::make_pair(typeinfo, handler)).second;
-      if (!added) {
-        errorfLocked("Response handler for sequence %d already registered",
-                     seq);
+    void put(const dap::TypeInfo* typeinfo, dap::RequestPolicy policy) {
+      {
+        std::unique_lock<std::mutex> lock(requestMutex);
+        if (policy == dap::kDispatchAll) {
+          requestQueues.erase(typeinfo->name());
+        } else {
+          requestQueues[typeinfo->name()] =
+              std::make_shared<dap::RequestQueue>(policy);
+        }
       }
+      refreeze();
     }
 
-    std::pair<const dap::TypeInfo*, GenericEventHandler> event(
-        const std::string& name) {
-      std::unique_lock<std::mutex> lock(eventMutex);
-      auto it = eventMap.find(name);
-      return (it != eventMap.end()) ? it->second : decltype(it->second){};
+    void put(const dap::TypeInfo* typeinfo, dap::DispatchMode mode) {
+      {
+        std::unique_lock<std::mutex> lock(requestMutex);
+        dispatchModes[typeinfo->name()] = mode;
+      }
+      refreeze();
     }
 
     void put(const dap::TypeInfo* typeinfo,
              const GenericEventHandler& handler) {
-      std::unique_lock<std::mutex> lock(eventMutex);
-      auto added =
-          eventMap.emplace(typeinfo->name(), std::make_pair(typeinfo, handler))
-              .second;
-      if (!added) {
-        errorfLocked("Event handler for '%s' already registered",
-                     typeinfo->name().c_str());
+      {
+        std::unique_lock<std::mutex> lock(eventMutex);
+        auto added = eventMap
+                         .emplace(typeinfo->name(),
+                                  std::make_pair(typeinfo, handler))
+                         .second;
+        if (!added) {
+          errorfLocked("Event handler for '%s' already registered",
+                       typeinfo->name().c_str());
+        }
       }
-    }
-
-    GenericResponseSentHandler responseSent(const dap::TypeInfo* typeinfo) {
-      std::unique_lock<std::mutex> lock(responseSentMutex);
-      auto it = responseSentMap.find(typeinfo);
-      return (it != responseSentMap.end()) ? it->second
-                                           : decltype(it->second){};
+      refreeze();
     }
 
     void put(const dap::TypeInfo* typeinfo,
              const GenericResponseSentHandler& handler) {
-      std::unique_lock<std::mutex> lock(responseSentMutex);
-      auto added = responseSentMap.emplace(typeinfo, handler).second;
-      if (!added) {
-        errorfLocked("Response sent handler for '%s' already registered",
-                     typeinfo->name().c_str());
+      {
+        std::unique_lock<std::mutex> lock(responseSentMutex);
+        auto added = responseSentMap.emplace(typeinfo, handler).second;
+        if (!added) {
+          errorfLocked("Response sent handler for '%s' already registered",
+                       typeinfo->name().c_str());
+        }
       }
+      refreeze();
+    }
+
+    using EventHandler = std::pair<const dap::TypeInfo*, GenericEventHandler>;
+
+    // Frozen is an immutable snapshot of the registered handlers.
+    struct Frozen {
+      dap::FrozenMap<std::string, RequestHandler> requests;
+      dap::FrozenMap<std::string, EventHandler> events;
+      dap::FrozenMap<const dap::TypeInfo*, GenericResponseSentHandler>
+          responseSent;
+    };
+
+    // Lookup looks up the registered handlers, using the snapshot published by
+    // freeze() without taking a lock, or the handler maps if freeze() has not
+    // been called. The handlers returned by a Lookup remain valid for the
+    // lifetime of the Lookup, which should be brief: a replaced snapshot is
+    // only freed once no Lookup is reading it.
+    class Lookup {
+     public:
+      explicit Lookup(EventHandlers* handlers)
+          : handlers(handlers),
+            reader(&handlers->frozen),
+            snapshot(reader.get()) {}
+
+      // request() returns the handler for the request with the given command,
+      // or null if there is none.
+      const RequestHandler* request(const std::string& name) {
+        if (snapshot) {
+          return snapshot->requests.find(name);
+        }
+        std::unique_lock<std::mutex> lock(handlers->requestMutex);
+        auto it = handlers->requestMap.find(name);
+        if (it == handlers->requestMap.end()) {
+          return nullptr;
+        }
+        std::tie(requestHandler.typeinfo, requestHandler.handler) = it->second;
+        auto queueIt = handlers->requestQueues.find(name);
+        if (queueIt != handlers->requestQueues.end()) {
+          requestHandler.queue = queueIt->second;
+        }
+        auto modeIt = handlers->dispatchModes.find(name);
+        if (modeIt != handlers->dispatchModes.end()) {
+          requestHandler.mode = modeIt->second;
+        }
+        requestHandler.lazy = handlers->lazyRequests.count(name) > 0;
+        return &requestHandler;
+      }
+
+      // event() returns the handler for the event with the given name, or null
+      // if there is none.
+      const EventHandler* event(const std::string& name) {
+        if (snapshot) {
+          return snapshot->events.find(name);
+        }
+        std::unique_lock<std::mutex> lock(handlers->eventMutex);
+        auto it = handlers->eventMap.find(name);
+        if (it == handlers->eventMap.end()) {
+          return nullptr;
+        }
+        eventHandler = it->second;
+        return &eventHandler;
+      }
+
+      // responseSent() returns the handler for sent responses of the given
+      // type, or null if there is none.
+      const GenericResponseSentHandler* responseSent(
+          const dap::TypeInfo* typeinfo) {
+        if (snapshot) {
+          return snapshot->responseSent.find(typeinfo);
+        }
+        std::unique_lock<std::mutex> lock(handlers->responseSentMutex);
+        auto it = handlers->responseSentMap.find(typeinfo);
+        if (it == handlers->responseSentMap.end()) {
+          return nullptr;
+        }
+        responseSentHandler = it->second;
+        return &responseSentHandler;
+      }
+
+     private:
+      Lookup(const Lookup&) = delete;
+      Lookup& operator=(const Lookup&) = delete;
+
+      EventHandlers* const handlers;
+      const dap::Published<const Frozen>::Reader reader;
+      const Frozen* const snapshot;
+      // The handlers copied from the handler maps, used before freeze().
+      RequestHandler requestHandler;
+      EventHandler eventHandler;
+      GenericResponseSentHandler responseSentHandler;
+    };
+
+    // freeze() publishes an immutable snapshot of the registered request,
+    // event and response sent handlers, which is then used for all handler
+    // lookups without taking a lock. Calling freeze() again replaces the
+    // snapshot, which is freed once no Lookup is reading it.
+    void freeze() {
+      auto snapshot = std::make_shared<Frozen>();
+      std::unique_lock<std::mutex> lock(freezeMutex);
+      {
+        std::unique_lock<std::mutex> requestLock(requestMutex);
+        std::unordered_map<std::string, RequestHandler> requests;
+        for (auto& it : requestMap) {
+          auto& request = requests[it.first];
+          std::tie(request.typeinfo, request.handler) = it.second;
+        }
+        for (auto& it : requestQueues) {
+          requests[it.first].queue = it.second;
+        }
+        for (auto& it : dispatchModes) {
+          requests[it.first].mode = it.second;
+        }
+        for (auto& name : lazyRequests) {
+          requests[name].lazy = true;
+        }
+        snapshot->requests = decltype(snapshot->requests)(requests);
+      }
+      {
+        std::unique_lock<std::mutex> eventLock(eventMutex);
+        snapshot->events = decltype(snapshot->events)(eventMap);
+      }
+      {
+        std::unique_lock<std::mutex> responseSentLock(responseSentMutex);
+        snapshot->responseSent =
+            decltype(snapshot->responseSent)(responseSentMap);
+      }
+      frozen.set(snapshot);
     }
 
    private:
+    // refreeze() replaces the snapshot published by freeze() so that it
+    // includes a newly registered handler. refreeze() does nothing if freeze()
+    // has not been called.
+    void refreeze() {
+      if (!frozen.empty()) {
+        freeze();
+      }
+    }
+
     void errorfLocked(const char* format, ...) {
       va_list vararg;
       va_start(vararg, format);
@@ -258,6 +947,7 @@ class Impl : public dap::Session {
     }
 
     void errorLocked(const char* format, va_list args) {
+      collector->error(format);
       char buf[2048];
       vsnprintf(buf, sizeof(buf), format, args);
       if (errorHandler) {
@@ -265,6 +955,7 @@ class Impl : public dap::Session {
       }
     }
 
+    dap::SessionStatsCollector* const collector;
     std::mutex errorMutex;
     ErrorHandler errorHandler;
 
@@ -272,11 +963,10 @@ class Impl : public dap::Session {
     std::unordered_map<std::string,
                        std::pair<const dap::TypeInfo*, GenericRequestHandler>>
         requestMap;
-
-    std::mutex responseMutex;
-    std::unordered_map<int64_t,
-                       std::pair<const dap::TypeInfo*, GenericResponseHandler>>
-        responseMap;
+    std::unordered_map<std::string, std::shared_ptr<dap::RequestQueue>>
+        requestQueues;
+    std::unordered_map<std::string, dap::DispatchMode> dispatchModes;
+    std::unordered_set<std::string> lazyRequests;
 
     std::mutex eventMutex;
     std::unordered_map<std::string,
@@ -286,28 +976,242 @@ class Impl : public dap::Session {
     std::mutex responseSentMutex;
     std::unordered_map<const dap::TypeInfo*, GenericResponseSentHandler>
         responseSentMap;
+
+    std::mutex freezeMutex;  // held while building a snapshot
+    dap::Published<const Frozen> frozen;
   };  // EventHandlers
 
-  Payload processMessage(const std::string& str) {
-    auto d = dap::json::Deserializer(str);
+  // Received describes a received message, for recording in the stats.
+  struct Received {
+    size_t bytes;
+    Clock::time_point start;  // the time parsing started
+
+    // record() records the message once it has been parsed.
+    void record(dap::SessionStatsCollector* collector,
+                dap::SessionStatsCollector::Kind kind,
+                const dap::TypeInfo* typeinfo) const {
+      collector->parsed(Clock::now() - start);
+      collector->received(kind, typeinfo, bytes);
+    }
+  };
+
+  // Traced is a message sampled for tracing. It holds a reference to the
+  // Tracer, which may be replaced while the message is in flight.
+  struct Traced {
+    std::shared_ptr<dap::Tracer> tracer;
+    dap::Tracer::Message message;
+
+    // span() records the stage, which ran on the calling thread.
+    void span(const char* stage,
+              Clock::time_point start,
+              Clock::time_point end) const {
+      span(stage, start, end, dap::Tracer::currentThread());
+    }
+
+    // span() records the stage, which ran on the given thread.
+    void span(const char* stage,
+              Clock::time_point start,
+              Clock::time_point end,
+              uint32_t thread) const {
+      tracer->span(stage, message, start, end, thread);
+    }
+  };
+  using TracedPtr = std::shared_ptr<const Traced>;
+
+  // OutboxEntry is a message waiting in the outbox. Conflated events are held
+  // unserialized, so that they can be replaced by a later event.
+  struct OutboxEntry {
+    std::string message;  // the serialized message, if not a conflated event
+    dap::integer seq = 0;
+    const dap::TypeInfo* typeinfo = nullptr;
+    std::shared_ptr<uint8_t> event;  // the conflated event, or null
+    TypedMessage typed;  // the message, if paired in-process
+    TracedPtr traced;    // null if the message is not traced
+  };
+
+  // trace() returns the sent message to trace, or null if tracing is disabled
+  // or the message was not sampled.
+  TracedPtr trace(const char* type,
+                  const dap::TypeInfo* typeinfo,
+                  dap::integer seq) {
+    auto traced = sample();
+    if (!traced) {
+      return nullptr;
+    }
+    traced->message.type = type;
+    traced->message.name = typeinfo->name();
+    traced->message.seq = seq;
+    return traced;
+  }
+
+  // sample() returns a new Traced if a Tracer is set and the next message is
+  // sampled for tracing, otherwise null.
+  std::shared_ptr<Traced> sample() {
+    if (tracer.empty()) {
+      return nullptr;
+    }
+    dap::Published<dap::Tracer>::Reader reader(&tracer);
+    auto t = reader.get();
+    if (t == nullptr || !t->sample()) {
+      return nullptr;
+    }
+    auto traced = std::make_shared<Traced>();
+    traced->tracer = reader.share();
+    return traced;
+  }
+
+  // receive() parses a message that was read between readStart and readEnd
+  // on the thread readThread, returning the payload that dispatches it. If the
+  // message is sampled for tracing, the read and parse stages are recorded,
+  // and the payload records the queued and handle stages.
+  Payload receive(const std::string& str,
+                  Clock::time_point readStart,
+                  Clock::time_point readEnd,
+                  uint32_t readThread,
+                  bool* runInline = nullptr) {
+    auto traced = sample();
+    if (!traced) {
+      return processMessage(str, runInline);
+    }
+    auto parseStart = Clock::now();
+    auto payload = processMessage(str, runInline, &traced->message);
+    auto parsed = Clock::now();
+    traced->span("read", readStart, readEnd, readThread);
+    traced->span("parse", parseStart, parsed);
+    return tracePayload(traced, parsed, payload);
+  }
+
+  // post() parses and dispatches the message on the strand, after the
+  // messages posted before it.
+  void post(const Incoming& message) {
+    numQueued.fetch_add(1, std::memory_order_relaxed);
+    strand->post([this, message] {
+      ProcessingScope scope(this);
+      if (auto payload = receive(message)) {
+        payload();
+      }
+      numQueued.fetch_sub(1, std::memory_order_relaxed);
+    });
+  }
+
+  // receive() returns the payload that dispatches the message, which is
+  // parsed if the session is not paired in-process.
+  Payload receive(const Incoming& message, bool* runInline = nullptr) {
+    if (message.typed.typeinfo == nullptr) {
+      return receive(message.content, message.readStart, message.readEnd,
+                     message.readThread, runInline);
+    }
+    auto traced = sample();
+    if (!traced) {
+      return processMessage(message.typed, runInline);
+    }
+    auto payload = processMessage(message.typed, runInline, &traced->message);
+    return tracePayload(traced, Clock::now(), payload);
+  }
+
+  // tracePayload() returns the payload wrapped to record the queued and handle
+  // stages of the traced message, which was queued at the given time.
+  static Payload tracePayload(const std::shared_ptr<Traced>& traced,
+                              Clock::time_point queued,
+                              const Payload& payload) {
+    if (!payload) {
+      return {};
+    }
+    return [=] {
+      auto dispatched = Clock::now();
+      traced->span("queued", queued, dispatched);
+      payload();
+      traced->span("handle", dispatched, Clock::now());
+    };
+  }
+
+  // isOpen() returns true if messages may still be received from the
+  // connected endpoint.
+  bool isOpen() { return linkIn ? !linkIn->drained : reader.isOpen(); }
+
+  // read() blocks until the next message is received, returning false if the
+  // connection was closed or the message was invalid.
+  bool read(Incoming& out) {
+    if (linkIn) {
+      auto message = linkIn->chan.take();
+      if (!message.has_value()) {
+        linkIn->drained = true;
+        return false;
+      }
+      out.typed = std::move(message.value());
+      return true;
+    }
+    out.content = reader.read();
+    if (out.content.size() == 0) {
+      return false;
+    }
+    out.readStart = reader.startTime();
+    out.readEnd = Clock::now();
+    out.readThread = dap::Tracer::currentThread();
+    return true;
+  }
+
+  // Parsed is a parsed message, which holds a reference to the StringPool
+  // used to deserialize it, as the pool may be replaced while the message is
+  // still being deserialized.
+  struct Parsed {
+    Parsed(const std::string& str, std::shared_ptr<dap::StringPool>&& pool)
+        : pool(std::move(pool)), deserializer(str, this->pool.get()) {}
+
+    const std::shared_ptr<dap::StringPool> pool;
+    dap::json::Deserializer deserializer;
+  };
+
+  // parse() parses the message, interning its strings with the current
+  // StringPool.
+  std::shared_ptr<dap::json::Deserializer> parse(const std::string& str) {
+    if (stringPool.empty()) {
+      return std::make_shared<dap::json::Deserializer>(str);
+    }
+    std::shared_ptr<dap::StringPool> pool;
+    {
+      dap::Published<dap::StringPool>::Reader reader(&stringPool);
+      pool = reader.share();
+    }
+    auto parsed = std::make_shared<Parsed>(str, std::move(pool));
+    return std::shared_ptr<dap::json::Deserializer>(parsed,
+                                                    &parsed->deserializer);
+  }
+
+  // processMessage() parses the message, returning the payload that
+  // dispatches it. If runInline is not null, it is assigned true if the
+  // message is a request with the kInline dispatch mode. If traced is not
+  // null, it is assigned the message's identity.
+  Payload processMessage(const std::string& str,
+                         bool* runInline = nullptr,
+                         dap::Tracer::Message* traced = nullptr) {
+    Received received{str.size(), Clock::now()};
+    // The parse tree is shared with the RequestArguments of lazy requests.
+    auto d = parse(str);
     dap::string type;
-    if (!d.field("type", &type)) {
+    if (!d->field("type", &type)) {
       handlers.error("Message missing string 'type' field");
       return {};
     }
 
     dap::integer sequence = 0;
-    if (!d.field("seq", &sequence)) {
+    if (!d->field("seq", &sequence)) {
       handlers.error("Message missing number 'seq' field");
       return {};
     }
 
+    if (traced) {
+      traced->type = type;
+      traced->seq = sequence;
+      d->field(type == "event" ? "event" : "command", &traced->name);
+    }
+
     if (type == "request") {
-      return processRequest(&d, sequence);
+      return processRequest(d, received, sequence, runInline);
     } else if (type == "event") {
-      return processEvent(&d);
+      return processEvent(d.get(), received);
     } else if (type == "response") {
-      processResponse(&d);
+      processResponse(d.get(), received);
       return {};
     } else {
       handlers.error("Unknown message type '%s'", type.c_str());
@@ -316,101 +1220,444 @@ class Impl : public dap::Session {
     return {};
   }
 
-  Payload processRequest(dap::json::Deserializer* d, dap::integer sequence) {
+  // processMessage() returns the payload that dispatches the message received
+  // from the session paired in-process. If runInline is not null, it is
+  // assigned true if the message is a request with the kInline dispatch mode.
+  // If traced is not null, it is assigned the message's identity.
+  Payload processMessage(const TypedMessage& message,
+                         bool* runInline = nullptr,
+                         dap::Tracer::Message* traced = nullptr) {
+    if (traced) {
+      static const char* kTypes[] = {"request", "response", "event"};
+      traced->type = kTypes[message.kind];
+      traced->name = message.requestTypeInfo ? message.requestTypeInfo->name()
+                                             : message.typeinfo->name();
+      traced->seq = message.seq;
+    }
+
+    switch (message.kind) {
+      case dap::SessionStatsCollector::kRequest: {
+        auto command = message.typeinfo->name();
+        EventHandlers::Lookup lookup(&handlers);
+        auto request = lookup.request(command);
+        if (!request || !request->typeinfo) {
+          handlers.error("No request handler registered for command '%s'",
+                         command.c_str());
+          return {};
+        }
+        if (request->lazy) {
+          // The request is only converted to the handler's type if the
+          // handler deserializes it.
+          collector.received(dap::SessionStatsCollector::kRequest,
+                             request->typeinfo, 0);
+          auto arguments = std::make_shared<TypedArguments>(
+              this, message.typeinfo, message.data);
+          return requestPayload(*request, argumentsObject(arguments),
+                                message.seq, runInline);
+        }
+        auto data = convert(message.typeinfo, message.data, request->typeinfo);
+        if (!data) {
+          handlers.error("Failed to deserialize request");
+          return {};
+        }
+        collector.received(dap::SessionStatsCollector::kRequest,
+                           request->typeinfo, 0);
+        return requestPayload(*request, data, message.seq, runInline);
+      }
+      case dap::SessionStatsCollector::kEvent: {
+        auto event = message.typeinfo->name();
+        EventHandlers::Lookup lookup(&handlers);
+        auto eventHandler = lookup.event(event);
+        if (!eventHandler || !eventHandler->first) {
+          handlers.error("No event handler registered for event '%s'",
+                         event.c_str());
+          return {};
+        }
+        auto typeinfo = eventHandler->first;
+        const auto& handler = eventHandler->second;
+        auto data = convert(message.typeinfo, message.data, typeinfo);
+        if (!data) {
+          handlers.error("Failed to deserialize event '%s' body",
+                         event.c_str());
+          return {};
+        }
+        collector.received(dap::SessionStatsCollector::kEvent, typeinfo, 0);
+        return [=] { handler(data.get()); };
+      }
+      case dap::SessionStatsCollector::kResponse:
+        processResponse(message);
+        return {};
+      case dap::SessionStatsCollector::kNumKinds:
+        break;
+    }
+    return {};
+  }
+
+  // convert() returns the object of the type 'from' as an object of the type
+  // 'to'. If the types differ, the object is converted through JSON. Returns
+  // null if the conversion failed.
+  static Object convert(const dap::TypeInfo* from,
+                        const Object& object,
+                        const dap::TypeInfo* to) {
+    if (from == to) {
+      return object;
+    }
+    dap::json::Serializer s;
+    if (!from->serialize(&s, object.get())) {
+      return nullptr;
+    }
+    auto out = newObject(to);
+    auto d = dap::json::Deserializer(s.dump());
+    if (!to->deserialize(&d, out.get())) {
+      return nullptr;
+    }
+    return out;
+  }
+
+  Payload processRequest(const std::shared_ptr<dap::json::Deserializer>& d,
+                         const Received& received,
+                         dap::integer sequence,
+                         bool* runInline) {
     dap::string command;
     if (!d->field("command", &command)) {
       handlers.error("Request missing string 'command' field");
       return {};
     }
 
-    const dap::TypeInfo* typeinfo;
-    GenericRequestHandler handler;
-    std::tie(typeinfo, handler) = handlers.request(command);
+    EventHandlers::Lookup lookup(&handlers);
+    auto request = lookup.request(command);
+    auto typeinfo = request ? request->typeinfo : nullptr;
     if (!typeinfo) {
       handlers.error("No request handler registered for command '%s'",
                      command.c_str());
       return {};
     }
 
-    auto data = new uint8_t[typeinfo->size()];
-    typeinfo->construct(data);
+    if (request->lazy) {
+      received.record(&collector, dap::SessionStatsCollector::kRequest,
+                      typeinfo);
+      auto arguments = std::make_shared<JsonArguments>(this, d);
+      return requestPayload(*request, argumentsObject(arguments), sequence,
+                            runInline);
+    }
 
+    auto data = newObject(typeinfo);
     if (!d->field("arguments", [&](dap::Deserializer* d) {
-          return typeinfo->deserialize(d, data);
+          return typeinfo->deserialize(d, data.get());
         })) {
       handlers.error("Failed to deserialize request");
-      typeinfo->destruct(data);
-      delete[] data;
       return {};
     }
+    received.record(&collector, dap::SessionStatsCollector::kRequest,
+                    typeinfo);
 
-    return [=] {
-      handler(
-          data,
-          [=](const dap::TypeInfo* typeinfo, const void* data) {
-            // onSuccess
-            dap::json::Serializer s;
-            s.object([&](dap::FieldSerializer* fs) {
-              return fs->field("seq", dap::integer(nextSeq++)) &&
-                     fs->field("type", "response") &&
-                     fs->field("request_seq", sequence) &&
-                     fs->field("success", dap::boolean(true)) &&
-                     fs->field("command", command) &&
-                     fs->field("body", [&](dap::Serializer* s) {
-                       return typeinfo->serialize(s, data);
-                     });
-            });
-            send(s.dump());
-
-            if (auto handler = handlers.responseSent(typeinfo)) {
-              handler(data, nullptr);
-            }
-          },
-          [=](const dap::TypeInfo* typeinfo, const dap::Error& error) {
-            // onError
-            dap::json::Serializer s;
-            s.object([&](dap::FieldSerializer* fs) {
-              return fs->field("seq", dap::integer(nextSeq++)) &&
-                     fs->field("type", "response") &&
-                     fs->field("request_seq", sequence) &&
-                     fs->field("success", dap::boolean(false)) &&
-                     fs->field("command", command) &&
-                     fs->field("message", error.message);
-            });
-            send(s.dump());
-
-            if (auto handler = handlers.responseSent(typeinfo)) {
-              handler(nullptr, &error);
-            }
+    return requestPayload(*request, data, sequence, runInline);
+  }
+
+  // requestPayload() returns the payload that dispatches the request with the
+  // given sequence number to its handler, applying the request's policy. If
+  // runInline is not null, it is assigned true if the request has the kInline
+  // dispatch mode.
+  Payload requestPayload(const RequestHandler& request,
+                         const Object& data,
+                         dap::integer sequence,
+                         bool* runInline) {
+    if (runInline) {
+      *runInline = request.mode == dap::kInline;
+    }
+
+    auto typeinfo = request.typeinfo;
+    auto queue = request.queue;
+    auto handler = request.handler;
+    if (!queue) {
+      return [=] {
+        dispatchRequest(handler, typeinfo, data.get(),
+                        [=](const Responder& respond) { respond(sequence); });
+      };
+    }
+
+    switch (queue->policy) {
+      case dap::kCoalesce: {
+        std::string key;
+        if (!coalesceKey(request, data, &key)) {
+          // Arguments that fail to deserialize are not coalesced, and the
+          // handler reports the error.
+          return [=] {
+            dispatchRequest(
+                handler, typeinfo, data.get(),
+                [=](const Responder& respond) { respond(sequence); });
+          };
+        }
+        if (!queue->coalesce(key, sequence)) {
+          return {};  // Coalesced with the in-flight request.
+        }
+        return [=] {
+          dispatchRequest(handler, typeinfo, data.get(),
+                          [=](const Responder& respond) {
+                            for (auto seq : queue->complete(key)) {
+                              respond(seq);
+                            }
+                          });
+        };
+      }
+      case dap::kLatestWins: {
+        queue->setLatest(sequence);
+        return [=] {
+          if (queue->superseded(sequence)) {
+            sendErrorResponse(sequence, typeinfo, dap::Error("cancelled"));
+          } else {
+            dispatchRequest(handler, typeinfo, data.get(),
+                            [=](const Responder& respond) {
+                              respond(sequence);
+                            });
+          }
+        };
+      }
+      case dap::kDispatchAll:
+        break;
+    }
+
+    handlers.error("Unhandled request policy for command '%s'",
+                   typeinfo->name().c_str());
+    return {};
+  }
+
+  // coalesceKey() assigns key the arguments of the request serialized as the
+  // handler's request type, which are the same for requests that can be
+  // coalesced. The arguments of a lazy handler are deserialized first, so that
+  // arguments that differ only in field order or in unknown fields have the
+  // same key for both kinds of handler. Returns false if the arguments could
+  // not be deserialized or serialized.
+  static bool coalesceKey(const RequestHandler& request,
+                          const Object& data,
+                          std::string* key) {
+    auto arguments = data;
+    if (request.lazy) {
+      arguments = newObject(request.typeinfo);
+      auto lazy = reinterpret_cast<const LazyArguments*>(data.get());
+      if (!lazy->decode(request.typeinfo, arguments.get())) {
+        return false;
+      }
+    }
+    dap::json::Serializer s;
+    if (!request.typeinfo->serialize(&s, arguments.get())) {
+      return false;
+    }
+    *key = s.dump();
+    return true;
+  }
+
+  // Responder is a function that sends a response to the request with the
+  // given sequence number.
+  using Responder = std::function<void(dap::integer requestSeq)>;
+
+  // OnResponse is called once the request handler has produced a response.
+  // The function is passed a Responder that should be called for each request
+  // that is to receive the response.
+  using OnResponse = std::function<void(const Responder&)>;
+
+  // dispatchRequest() calls the request handler with the given request data,
+  // calling onResponse when the handler has produced the response.
+  void dispatchRequest(const GenericRequestHandler& handler,
+                       const dap::TypeInfo* requestTypeInfo,
+                       const void* data,
+                       const OnResponse& onResponse) {
+    auto start = Clock::now();
+    handler(
+        data,
+        [=](const dap::TypeInfo* typeinfo, const void* data) {
+          // onSuccess
+          onResponse([&](dap::integer requestSeq) {
+            sendResponse(requestSeq, requestTypeInfo, typeinfo, data);
           });
-      typeinfo->destruct(data);
-      delete[] data;
-    };
+
+          EventHandlers::Lookup lookup(&handlers);
+          if (auto handler = lookup.responseSent(typeinfo)) {
+            (*handler)(data, nullptr);
+          }
+        },
+        [=](const dap::TypeInfo* typeinfo, const dap::Error& error) {
+          // onError
+          onResponse([&](dap::integer requestSeq) {
+            sendErrorResponse(requestSeq, requestTypeInfo, error);
+          });
+
+          EventHandlers::Lookup lookup(&handlers);
+          if (auto handler = lookup.responseSent(typeinfo)) {
+            (*handler)(nullptr, &error);
+          }
+        });
+    collector.handled(requestTypeInfo, Clock::now() - start);
+  }
+
+  // sendEvent() sends the event to the connected endpoint.
+  bool sendEvent(const dap::TypeInfo* typeinfo, const void* event) {
+    TracedPtr traced;
+    if (linkOut) {
+      auto message =
+          typedEvent(typeinfo, newObject(typeinfo, event), nextSeq++, &traced);
+      return post(std::move(message), traced);
+    }
+    auto message = serializeEvent(typeinfo, event, nextSeq++, &traced);
+    return message.size() > 0 && send(message, traced);
+  }
+
+  // serializeEvent() returns the serialized event message, or an empty string
+  // if the event could not be serialized. traced is assigned the message to
+  // trace, if the message is sampled for tracing.
+  std::string serializeEvent(const dap::TypeInfo* typeinfo,
+                             const void* event,
+                             dap::integer seq,
+                             TracedPtr* traced) {
+    auto start = Clock::now();
+    dap::json::Serializer s;
+    if (!s.object([&](dap::FieldSerializer* fs) {
+          return fs->field("seq", seq) &&
+                 fs->field("type", "event") &&
+                 fs->field("event", typeinfo->name()) &&
+                 fs->field("body", [&](dap::Serializer* s) {
+                   return typeinfo->serialize(s, event);
+                 });
+        })) {
+      return "";
+    }
+    auto message = s.dump();
+    auto end = Clock::now();
+    collector.serialized(end - start);
+    collector.sent(dap::SessionStatsCollector::kEvent, typeinfo,
+                   message.size());
+    *traced = trace("event", typeinfo, seq);
+    if (*traced) {
+      (*traced)->span("serialize", start, end);
+    }
+    return message;
   }
 
-  Payload processEvent(dap::json::Deserializer* d) {
+  // typedEvent() returns the event message to post to the session paired
+  // in-process. traced is assigned the message to trace, if the message is
+  // sampled for tracing.
+  TypedMessage typedEvent(const dap::TypeInfo* typeinfo,
+                          const Object& event,
+                          dap::integer seq,
+                          TracedPtr* traced) {
+    collector.sent(dap::SessionStatsCollector::kEvent, typeinfo, 0);
+    *traced = trace("event", typeinfo, seq);
+    TypedMessage message;
+    message.kind = dap::SessionStatsCollector::kEvent;
+    message.seq = seq;
+    message.typeinfo = typeinfo;
+    message.data = event;
+    return message;
+  }
+
+  // sendResponse() sends a successful response to the request with the given
+  // sequence number.
+  void sendResponse(dap::integer requestSeq,
+                    const dap::TypeInfo* requestTypeInfo,
+                    const dap::TypeInfo* typeinfo,
+                    const void* data) {
+    aggregator.flush();
+    if (linkOut) {
+      TypedMessage message;
+      message.typeinfo = typeinfo;
+      message.data = newObject(typeinfo, data);
+      postResponse(requestSeq, requestTypeInfo, std::move(message));
+      return;
+    }
+    auto start = Clock::now();
+    auto seq = dap::integer(nextSeq++);
+    dap::json::Serializer s;
+    s.object([&](dap::FieldSerializer* fs) {
+      return fs->field("seq", seq) && fs->field("type", "response") &&
+             fs->field("request_seq", requestSeq) &&
+             fs->field("success", dap::boolean(true)) &&
+             fs->field("command", requestTypeInfo->name()) &&
+             fs->field("body", [&](dap::Serializer* s) {
+               return typeinfo->serialize(s, data);
+             });
+    });
+    sendResponse(requestTypeInfo, seq, s.dump(), start);
+  }
+
+  // sendErrorResponse() sends an error response to the request with the given
+  // sequence number.
+  void sendErrorResponse(dap::integer requestSeq,
+                         const dap::TypeInfo* requestTypeInfo,
+                         const dap::Error& error) {
+    aggregator.flush();
+    if (linkOut) {
+      TypedMessage message;
+      message.typeinfo = requestTypeInfo;
+      message.error = error;
+      postResponse(requestSeq, requestTypeInfo, std::move(message));
+      return;
+    }
+    auto start = Clock::now();
+    auto seq = dap::integer(nextSeq++);
+    dap::json::Serializer s;
+    s.object([&](dap::FieldSerializer* fs) {
+      return fs->field("seq", seq) && fs->field("type", "response") &&
+             fs->field("request_seq", requestSeq) &&
+             fs->field("success", dap::boolean(false)) &&
+             fs->field("command", requestTypeInfo->name()) &&
+             fs->field("message", error.message);
+    });
+    sendResponse(requestTypeInfo, seq, s.dump(), start);
+  }
+
+  // sendResponse() sends the serialized response message, recording it in
+  // the stats and trace. start is the time the serialization started.
+  void sendResponse(const dap::TypeInfo* requestTypeInfo,
+                    dap::integer seq,
+                    const std::string& message,
+                    Clock::time_point start) {
+    auto end = Clock::now();
+    collector.serialized(end - start);
+    collector.sent(dap::SessionStatsCollector::kResponse, requestTypeInfo,
+                   message.size());
+    auto traced = trace("response", requestTypeInfo, seq);
+    if (traced) {
+      traced->span("serialize", start, end);
+    }
+    send(message, traced);
+  }
+
+  // postResponse() posts the response message to the request with the given
+  // sequence number to the session paired in-process.
+  void postResponse(dap::integer requestSeq,
+                    const dap::TypeInfo* requestTypeInfo,
+                    TypedMessage&& message) {
+    message.kind = dap::SessionStatsCollector::kResponse;
+    message.seq = requestSeq;
+    message.requestTypeInfo = requestTypeInfo;
+    collector.sent(dap::SessionStatsCollector::kResponse, requestTypeInfo, 0);
+    auto traced = trace("response", requestTypeInfo, nextSeq++);
+    post(std::move(message), traced);
+  }
+
+  Payload processEvent(dap::json::Deserializer* d, const Received& received) {
     dap::string event;
     if (!d->field("event", &event)) {
       handlers.error("Event missing string 'event' field");
       return {};
     }
 
-    const dap::TypeInfo* typeinfo;
-    GenericEventHandler handler;
-    std::tie(typeinfo, handler) = handlers.event(event);
-    if (!typeinfo) {
+    EventHandlers::Lookup lookup(&handlers);
+    auto eventHandler = lookup.event(event);
+    if (!eventHandler || !eventHandler->first) {
       handlers.error("No event handler registered for event '%s'",
                      event.c_str());
       return {};
     }
+    auto typeinfo = eventHandler->first;
+    const auto& handler = eventHandler->second;
 
-    auto data = new uint8_t[typeinfo->size()];
-    typeinfo->construct(data);
+    auto data = newObject(typeinfo);
 
     // "body" is an optional field for some events, such as "Terminated Event".
     bool body_ok = true;
     d->field("body", [&](dap::Deserializer* d) {
-      if (!typeinfo->deserialize(d, data)) {
+      if (!typeinfo->deserialize(d, data.get())) {
         body_ok = false;
       }
       return true;
@@ -418,31 +1665,25 @@ class Impl : public dap::Session {
 
     if (!body_ok) {
       handlers.error("Failed to deserialize event '%s' body", event.c_str());
-      typeinfo->destruct(data);
-      delete[] data;
       return {};
     }
+    received.record(&collector, dap::SessionStatsCollector::kEvent, typeinfo);
 
-    return [=] {
-      handler(data);
-      typeinfo->destruct(data);
-      delete[] data;
-    };
+    return [=] { handler(data.get()); };
   }
 
-  void processResponse(const dap::Deserializer* d) {
+  void processResponse(const dap::Deserializer* d, const Received& received) {
     dap::integer requestSeq = 0;
     if (!d->field("request_seq", &requestSeq)) {
       handlers.error("Response missing int 'request_seq' field");
       return;
     }
 
-    const dap::TypeInfo* typeinfo;
-    GenericResponseHandler handler;
-    std::tie(typeinfo, handler) = handlers.response(requestSeq);
+    auto request = takeRequest(requestSeq);
+    auto typeinfo = request.typeinfo;
+    auto& handler = request.handler;
     if (!typeinfo) {
-      handlers.error("Unknown response with sequence %d", requestSeq);
-      return;
+      return;  // Reported by takeRequest()
     }
 
     dap::boolean success = false;
@@ -459,6 +1700,8 @@ class Impl : public dap::Session {
       d->field("body", [&](const dap::Deserializer* d) {
         return typeinfo->deserialize(d, data.get());
       });
+      received.record(&collector, dap::SessionStatsCollector::kResponse,
+                      request.requestTypeInfo);
 
       handler(data.get(), nullptr);
       typeinfo->destruct(data.get());
@@ -468,41 +1711,340 @@ class Impl : public dap::Session {
         handlers.error("Failed to deserialize message");
         return;
       }
+      received.record(&collector, dap::SessionStatsCollector::kResponse,
+                      request.requestTypeInfo);
       auto error = dap::Error("%s", message.c_str());
       handler(nullptr, &error);
     }
   }
 
-  bool send(const std::string& s) {
+  // processResponse() calls the handler of the request with the response
+  // received from the session paired in-process.
+  void processResponse(const TypedMessage& message) {
+    auto request = takeRequest(message.seq);
+    if (!request.typeinfo) {
+      return;  // Reported by takeRequest()
+    }
+    collector.received(dap::SessionStatsCollector::kResponse,
+                       request.requestTypeInfo, 0);
+    if (!message.data) {
+      request.handler(nullptr, &message.error);
+      return;
+    }
+    auto data = convert(message.typeinfo, message.data, request.typeinfo);
+    if (!data) {
+      auto error = dap::Error("Failed to deserialize response");
+      request.handler(nullptr, &error);
+      return;
+    }
+    request.handler(data.get(), nullptr);
+  }
+
+  // takeRequest() removes and returns the pending request with the given
+  // sequence number, for its response, cancelling its timeout. Returns an
+  // empty Request if there is none, reporting an error unless the request
+  // recently timed out.
+  dap::PendingRequests::Request takeRequest(dap::integer seq) {
+    bool timedOut = false;
+    auto request = pending.take(seq, &timedOut);
+    if (!request.typeinfo) {
+      if (!timedOut) {
+        handlers.error("Unknown response with sequence %lld",
+                       static_cast<long long>(seq));
+      }
+      return {};
+    }
+    if (request.timer != 0) {
+      timers.cancel(request.timer);
+    }
+    return request;
+  }
+
+  // conflates() returns true if events of the type are conflated.
+  bool conflates(const dap::TypeInfo* typeinfo) {
+    if (!outbox.inUse()) {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(conflationMutex);
+    return conflationKeys.count(typeinfo) > 0;
+  }
+
+  // conflateEvent() queues the event in the outbox if conflation is enabled
+  // for the event's type, replacing any queued event with the same key.
+  // Returns false if conflation is not enabled for the event's type.
+  bool conflateEvent(const dap::TypeInfo* typeinfo, const void* event) {
+    if (!outbox.inUse()) {
+      return false;
+    }
+    std::string key;
+    {
+      std::unique_lock<std::mutex> lock(conflationMutex);
+      auto it = conflationKeys.find(typeinfo);
+      if (it == conflationKeys.end()) {
+        return false;
+      }
+      key = typeinfo->name() + '\0' + it->second(event);
+    }
+    auto data = newObject(typeinfo, event);
+    return outbox.conflate(
+        key,
+        [&] {
+          OutboxEntry entry;
+          entry.seq = nextSeq++;
+          entry.typeinfo = typeinfo;
+          entry.event = std::move(data);
+          return entry;
+        },
+        [&](OutboxEntry& waiting) {
+          // Replace the waiting event, keeping its sequence number.
+          waiting.event = std::move(data);
+        });
+  }
+
+  // writeOutbox() writes a message taken from the outbox. Conflated events
+  // are only serialized once they are taken from the outbox. Failed writes
+  // are reported to the error handler, as the senders have already returned,
+  // and are counted in the stats by the outbox.
+  bool writeOutbox(OutboxEntry& entry) {
+    if (entry.event && linkOut) {
+      entry.typed =
+          typedEvent(entry.typeinfo, entry.event, entry.seq, &entry.traced);
+    } else if (entry.event) {
+      entry.message = serializeEvent(entry.typeinfo, entry.event.get(),
+                                     entry.seq, &entry.traced);
+    }
+    if (entry.typed.typeinfo) {
+      return deliver(std::move(entry.typed), entry.traced);
+    }
+    if (entry.message.size() == 0) {
+      return false;  // Reported by serializeEvent()
+    }
+    if (!write(entry.message, entry.traced)) {
+      if (writer.isOpen()) {
+        handlers.error("Failed to write a message from the outbox");
+      }
+      return false;
+    }
+    return true;
+  }
+
+  // enqueue() queues the message in the outbox, if the outbox is in use.
+  // Returns true if the message was queued, or false with ok assigned the
+  // result of send() if it was not.
+  bool enqueue(OutboxEntry&& entry, bool* ok) {
+    switch (outbox.put(std::move(entry))) {
+      case dap::Outbox<OutboxEntry>::kQueued:
+        *ok = true;
+        return true;
+      case dap::Outbox<OutboxEntry>::kInactive:
+        return false;
+      case dap::Outbox<OutboxEntry>::kFull:
+        handlers.error("Failed to send a message as the outbox is full");
+        break;
+      case dap::Outbox<OutboxEntry>::kClosed:
+        break;
+    }
+    *ok = false;
+    return true;
+  }
+
+  // send() writes the message, or queues it in the outbox if the outbox is in
+  // use. A queued message is written by writeOutbox(), so send() then only
+  // returns false if the message could not be queued.
+  bool send(const std::string& s, const TracedPtr& traced = nullptr) {
+    if (outbox.inUse() && writer.isOpen()) {
+      OutboxEntry entry;
+      entry.message = s;
+      entry.traced = traced;
+      bool ok = false;
+      if (enqueue(std::move(entry), &ok)) {
+        return ok;
+      }
+    }
+    return write(s, traced);
+  }
+
+  bool write(const std::string& s, const TracedPtr& traced = nullptr) {
+    auto start = Clock::now();
     std::unique_lock<std::mutex> lock(sendMutex);
     if (!writer.isOpen()) {
       handlers.error("Send failed as the writer is closed");
       return false;
     }
-    return writer.write(s);
+    auto ok = writer.write(s);
+    if (traced) {
+      traced->span("write", start, Clock::now());
+    }
+    return ok;
   }
 
+  // post() is the equivalent of send() for the session paired in-process.
+  bool post(TypedMessage&& message, const TracedPtr& traced) {
+    if (outbox.inUse() && linkOut->open) {
+      OutboxEntry entry;
+      entry.typed = std::move(message);
+      entry.traced = traced;
+      bool ok = false;
+      if (enqueue(std::move(entry), &ok)) {
+        return ok;
+      }
+      message = std::move(entry.typed);
+    }
+    return deliver(std::move(message), traced);
+  }
+
+  // deliver() is the equivalent of write() for the session paired in-process.
+  bool deliver(TypedMessage&& message, const TracedPtr& traced) {
+    auto start = Clock::now();
+    if (!linkOut->put(std::move(message))) {
+      handlers.error("Send failed as the writer is closed");
+      return false;
+    }
+    if (traced) {
+      traced->span("write", start, Clock::now());
+    }
+    return true;
+  }
+
+  // ProcessingScope marks the calling thread as processing the responses
+  // received by the session for its lifetime.
+  class ProcessingScope {
+   public:
+    explicit ProcessingScope(const Impl* session) : previous(processing) {
+      processing = session;
+    }
+    ~ProcessingScope() { processing = previous; }
+
+   private:
+    const Impl* const previous;
+  };
+
+  // processing is the session whose responses the calling thread processes,
+  // or null. send() fails instead of blocking at the pending request limit on
+  // this thread, as blocking would stop the responses that free a slot.
+  static thread_local const Impl* processing;
+
   std::atomic<bool> isBound = {false};
   std::atomic<bool> isProcessingMessages = {false};
   dap::ContentReader reader;
   dap::ContentWriter writer;
+  dap::ContentDecoder decoder;  // used by feed()
+  // The links to the session paired by pairInProcess(), or null.
+  std::shared_ptr<InProcessLink> linkIn;
+  std::shared_ptr<InProcessLink> linkOut;
 
   std::atomic<bool> shutdown = {false};
-  EventHandlers handlers;
+  dap::SessionStatsCollector collector;
+  EventHandlers handlers{&collector};
+  dap::PendingRequests pending;
   std::thread recvThread;
   std::thread dispatchThread;
   dap::Chan<Payload> inbox;
+  std::atomic<size_t> numQueued = {0};  // payloads in inbox or dispatching
+  std::unique_ptr<dap::Strand> strand;  // null if there is no executor
   std::atomic<uint32_t> nextSeq = {1};
   std::mutex sendMutex;
   dap::OnInvalidData onInvalidData = dap::kIgnore;
+  std::atomic<std::chrono::milliseconds> requestTimeout = {
+      std::chrono::milliseconds(0)};
+  dap::OutputAggregator aggregator{[this](const void* event) {
+    return sendEvent(dap::outputEventType(), event);
+  }};
+
+  // The outbox is only used while conflation is enabled for an event type,
+  // or while it still holds messages.
+  std::mutex conflationMutex;
+  std::unordered_map<const dap::TypeInfo*, ConflationKey> conflationKeys;
+  dap::Outbox<OutboxEntry> outbox{
+      [this](OutboxEntry& entry) { return writeOutbox(entry); }};
+
+  // tracer is the Tracer set by setTracer(). Each traced message holds a
+  // reference to the Tracer, so a replaced Tracer is released once the last
+  // message it traces has completed.
+  dap::Published<dap::Tracer> tracer;
+
+  // stringPool is the StringPool set by setStringPool(). Each parsed message
+  // holds a reference to the pool, so a replaced pool is released once the
+  // last message it interns has been deserialized.
+  dap::Published<dap::StringPool> stringPool;
+
+  dap::StatsReporter statsReporter{&timers, [this] { return stats(); }};
+  // timers must be the last member, so that the timer thread is stopped before
+  // any state used by timer callbacks is destructed.
+  dap::TimerWheel timers;
 };
 
+thread_local const Impl* Impl::processing = nullptr;
+
 }  // anonymous namespace
 
 namespace dap {
 
 Error::Error(const std::string& message) : message(message) {}
 
+RequestArguments::~RequestArguments() = default;
+
+struct SerializedEvent::Data {
+  const TypeInfo* typeinfo;
+  std::shared_ptr<const void> event;
+  // The serialized message, up to the value of the "seq" field.
+  std::string prefix;
+};
+
+SerializedEvent SerializedEvent::create(const TypeInfo* typeinfo,
+                                        const void* event) {
+  json::Serializer s;
+  if (!s.object([&](FieldSerializer* fs) {
+        return fs->field("type", "event") &&
+               fs->field("event", typeinfo->name()) &&
+               fs->field("body", [&](Serializer* s) {
+                 return typeinfo->serialize(s, event);
+               });
+      })) {
+    return {};
+  }
+  // Replace the closing brace of the object with the "seq" field.
+  auto message = s.dump();
+  auto end = message.rfind('}');
+  if (end == std::string::npos) {
+    return {};
+  }
+  auto copy = std::shared_ptr<uint8_t>(new uint8_t[typeinfo->size()],
+                                       [typeinfo](uint8_t* ptr) {
+                                         typeinfo->destruct(ptr);
+                                         delete[] ptr;
+                                       });
+  typeinfo->copyConstruct(copy.get(), event);
+
+  auto data = std::make_shared<Data>();
+  data->typeinfo = typeinfo;
+  data->event = std::move(copy);
+  data->prefix = message.substr(0, end) + ",\"seq\":";
+  SerializedEvent out;
+  out.data = std::move(data);
+  return out;
+}
+
+const TypeInfo* SerializedEvent::typeinfo() const {
+  return data ? data->typeinfo : nullptr;
+}
+
+std::shared_ptr<const void> SerializedEvent::event() const {
+  return data ? data->event : nullptr;
+}
+
+std::string SerializedEvent::message(integer seq) const {
+  if (!data) {
+    return "";
+  }
+  std::string out;
+  out.reserve(data->prefix.size() + 21);
+  out += data->prefix;
+  appendInteger(seq, &out);
+  out += '}';
+  return out;
+}
+
 Error::Error(const char* msg, ...) {
   char buf[2048];
   va_list vararg;
@@ -515,7 +2057,18 @@ Error::Error(const char* msg, ...) {
 Session::~Session() = default;
 
 std::unique_ptr<Session> Session::create() {
-  return std::unique_ptr<Session>(new Impl());
+  return create(Options());
+}
+
+std::unique_ptr<Session> Session::create(const Options& options) {
+  return std::unique_ptr<Session>(new Impl(options));
+}
+
+void Session::pairInProcess(Session* a,
+                            Session* b,
+                            const ClosedHandler& onCloseA /* = {} */,
+                            const ClosedHandler& onCloseB /* = {} */) {
+  Impl::pair(a, b, onCloseA, onCloseB);
 }
 
 }  // namespace dap
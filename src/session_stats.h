@@ -0,0 +1,380 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_session_stats_h
+#define dap_session_stats_h
+
+#include "dap/session.h"
+#include "dap/typeinfo.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace dap {
+
+// kNumStatsShards is the number of shards of each of the counters below. Each
+// thread records to the shard returned by statsShard(), so that threads
+// recording at the same time do not write to the same cache lines. Reading a
+// counter sums its shards.
+const int kNumStatsShards = 4;
+
+// kStatsPadding is the padding that follows each shard, so that no two shards
+// share a cache line.
+const size_t kStatsPadding = 64;
+
+// statsShard() returns the shard recorded to by the calling thread.
+inline int statsShard() {
+  static std::atomic<int> next = {0};
+  thread_local int shard = next.fetch_add(1) % kNumStatsShards;
+  return shard;
+}
+
+// AtomicHistogram is a DurationHistogram that can be recorded to from
+// multiple threads without locking.
+class AtomicHistogram {
+ public:
+  inline AtomicHistogram();
+
+  // record() adds the duration to the histogram.
+  inline void record(std::chrono::steady_clock::duration duration);
+
+  // get() returns a snapshot of the histogram.
+  inline DurationHistogram get() const;
+
+  // empty() returns true if no durations have been recorded.
+  inline bool empty() const;
+
+ private:
+  AtomicHistogram(const AtomicHistogram&) = delete;
+  AtomicHistogram& operator=(const AtomicHistogram&) = delete;
+
+  struct Shard {
+    std::atomic<uint64_t> buckets[DurationHistogram::kNumBuckets];
+    std::atomic<uint64_t> totalMicroseconds;
+    uint8_t padding[kStatsPadding];
+  };
+  Shard shards[kNumStatsShards];
+};
+
+AtomicHistogram::AtomicHistogram() {
+  for (auto& shard : shards) {
+    for (auto& bucket : shard.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    shard.totalMicroseconds.store(0, std::memory_order_relaxed);
+  }
+}
+
+void AtomicHistogram::record(std::chrono::steady_clock::duration duration) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration)
+                .count();
+  if (us < 0) {
+    us = 0;
+  }
+  int bucket = 0;
+  for (auto v = static_cast<uint64_t>(us);
+       v > 0 && bucket < DurationHistogram::kNumBuckets - 1; v >>= 1) {
+    bucket++;
+  }
+  auto& shard = shards[statsShard()];
+  shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.totalMicroseconds.fetch_add(static_cast<uint64_t>(us),
+                                    std::memory_order_relaxed);
+}
+
+DurationHistogram AtomicHistogram::get() const {
+  DurationHistogram out;
+  uint64_t us = 0;
+  for (auto& shard : shards) {
+    for (int i = 0; i < DurationHistogram::kNumBuckets; i++) {
+      auto n = shard.buckets[i].load(std::memory_order_relaxed);
+      out.buckets[i] += n;
+      out.count += n;
+    }
+    us += shard.totalMicroseconds.load(std::memory_order_relaxed);
+  }
+  out.total = std::chrono::microseconds(us);
+  return out;
+}
+
+bool AtomicHistogram::empty() const {
+  for (auto& shard : shards) {
+    for (auto& bucket : shard.buckets) {
+      if (bucket.load(std::memory_order_relaxed) > 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// SessionStatsCollector collects the metrics returned by Session::stats().
+// Recording a message or an error takes no locks, and each thread records to
+// its own shard of the counters, so the collector is always enabled.
+class SessionStatsCollector {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Kind is the kind of a recorded message.
+  enum Kind { kRequest, kResponse, kEvent, kNumKinds };
+
+  inline SessionStatsCollector();
+  inline ~SessionStatsCollector();
+
+  // received() records a received message. For responses, typeinfo is the
+  // type of the request.
+  inline void received(Kind kind, const TypeInfo* typeinfo, size_t bytes);
+
+  // sent() records a sent message. For responses, typeinfo is the type of the
+  // request.
+  inline void sent(Kind kind, const TypeInfo* typeinfo, size_t bytes);
+
+  // parsed() records the time taken to parse a received message.
+  inline void parsed(Clock::duration duration);
+
+  // serialized() records the time taken to serialize a sent message.
+  inline void serialized(Clock::duration duration);
+
+  // handled() records the time taken by a call to the handler of the request
+  // with the given type.
+  inline void handled(const TypeInfo* typeinfo, Clock::duration duration);
+
+  // error() records an error, where kind is the error's format string.
+  inline void error(const char* kind);
+
+  // get() assigns the collected message, timing and error metrics to out.
+  inline void get(SessionStats& out) const;
+
+ private:
+  // kMaxTypes is the maximum number of message types recorded. Messages of
+  // further types are not recorded.
+  static const size_t kMaxTypes = 512;
+
+  // kMaxErrorKinds is the maximum number of error kinds recorded. Errors of
+  // further kinds are not recorded.
+  static const size_t kMaxErrorKinds = 128;
+
+  // TypeStats holds the metrics for a single request or event type.
+  struct TypeStats {
+    inline TypeStats(const TypeInfo* typeinfo);
+    const TypeInfo* key() const { return typeinfo; }
+
+    struct Shard {
+      std::atomic<uint64_t> received[kNumKinds];
+      std::atomic<uint64_t> bytesReceived[kNumKinds];
+      std::atomic<uint64_t> sent[kNumKinds];
+      std::atomic<uint64_t> bytesSent[kNumKinds];
+      uint8_t padding[kStatsPadding];
+    };
+
+    const TypeInfo* const typeinfo;
+    Shard shards[kNumStatsShards];
+    AtomicHistogram handlerTime;
+  };
+
+  // ErrorStats holds the count of the errors with a single format string.
+  struct ErrorStats {
+    inline ErrorStats(const char* kind);
+    const char* key() const { return kind; }
+
+    const char* const kind;
+    std::atomic<uint64_t> count[kNumStatsShards];
+  };
+
+  SessionStatsCollector(const SessionStatsCollector&) = delete;
+  SessionStatsCollector& operator=(const SessionStatsCollector&) = delete;
+
+  // lookup() returns the TypeStats for the given type, adding it if this is
+  // the first time the type has been seen. Returns nullptr if the table is
+  // full.
+  inline TypeStats* lookup(const TypeInfo* typeinfo);
+
+  // lookup() returns the Stats for the key in the hash table, adding it if
+  // this is the first time the key has been seen. Returns nullptr if the
+  // table is full.
+  template <typename Stats, typename Key, size_t N>
+  inline static Stats* lookup(std::atomic<Stats*> (&table)[N], Key key);
+
+  // types is an open addressing hash table of TypeStats, keyed by TypeInfo.
+  // Entries are added with a compare-exchange, and are never removed.
+  std::atomic<TypeStats*> types[kMaxTypes];
+  AtomicHistogram parseTime;
+  AtomicHistogram serializeTime;
+
+  // errors is an open addressing hash table of ErrorStats, keyed by the
+  // address of the error's format string. get() merges the entries of equal
+  // format strings.
+  std::atomic<ErrorStats*> errors[kMaxErrorKinds];
+};
+
+SessionStatsCollector::TypeStats::TypeStats(const TypeInfo* typeinfo)
+    : typeinfo(typeinfo) {
+  for (auto& shard : shards) {
+    for (int i = 0; i < kNumKinds; i++) {
+      shard.received[i].store(0, std::memory_order_relaxed);
+      shard.bytesReceived[i].store(0, std::memory_order_relaxed);
+      shard.sent[i].store(0, std::memory_order_relaxed);
+      shard.bytesSent[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+SessionStatsCollector::ErrorStats::ErrorStats(const char* kind) : kind(kind) {
+  for (auto& n : count) {
+    n.store(0, std::memory_order_relaxed);
+  }
+}
+
+SessionStatsCollector::SessionStatsCollector() {
+  for (auto& entry : types) {
+    entry.store(nullptr, std::memory_order_relaxed);
+  }
+  for (auto& entry : errors) {
+    entry.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+SessionStatsCollector::~SessionStatsCollector() {
+  for (auto& entry : types) {
+    delete entry.load(std::memory_order_relaxed);
+  }
+  for (auto& entry : errors) {
+    delete entry.load(std::memory_order_relaxed);
+  }
+}
+
+void SessionStatsCollector::received(Kind kind,
+                                     const TypeInfo* typeinfo,
+                                     size_t bytes) {
+  if (auto stats = lookup(typeinfo)) {
+    auto& shard = stats->shards[statsShard()];
+    shard.received[kind].fetch_add(1, std::memory_order_relaxed);
+    shard.bytesReceived[kind].fetch_add(bytes, std::memory_order_relaxed);
+  }
+}
+
+void SessionStatsCollector::sent(Kind kind,
+                                 const TypeInfo* typeinfo,
+                                 size_t bytes) {
+  if (auto stats = lookup(typeinfo)) {
+    auto& shard = stats->shards[statsShard()];
+    shard.sent[kind].fetch_add(1, std::memory_order_relaxed);
+    shard.bytesSent[kind].fetch_add(bytes, std::memory_order_relaxed);
+  }
+}
+
+void SessionStatsCollector::parsed(Clock::duration duration) {
+  parseTime.record(duration);
+}
+
+void SessionStatsCollector::serialized(Clock::duration duration) {
+  serializeTime.record(duration);
+}
+
+void SessionStatsCollector::handled(const TypeInfo* typeinfo,
+                                    Clock::duration duration) {
+  if (auto stats = lookup(typeinfo)) {
+    stats->handlerTime.record(duration);
+  }
+}
+
+void SessionStatsCollector::error(const char* kind) {
+  if (auto stats = lookup(errors, kind)) {
+    stats->count[statsShard()].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void SessionStatsCollector::get(SessionStats& out) const {
+  std::map<std::string, MessageStats>* maps[kNumKinds] = {};
+  maps[kRequest] = &out.requests;
+  maps[kResponse] = &out.responses;
+  maps[kEvent] = &out.events;
+  for (auto& entry : types) {
+    auto stats = entry.load(std::memory_order_acquire);
+    if (stats == nullptr) {
+      continue;
+    }
+    auto name = stats->typeinfo->name();
+    for (int kind = 0; kind < kNumKinds; kind++) {
+      MessageStats message;
+      for (auto& shard : stats->shards) {
+        message.received +=
+            shard.received[kind].load(std::memory_order_relaxed);
+        message.bytesReceived +=
+            shard.bytesReceived[kind].load(std::memory_order_relaxed);
+        message.sent += shard.sent[kind].load(std::memory_order_relaxed);
+        message.bytesSent +=
+            shard.bytesSent[kind].load(std::memory_order_relaxed);
+      }
+      if (message.received > 0 || message.sent > 0) {
+        (*maps[kind])[name] = message;
+      }
+    }
+    if (!stats->handlerTime.empty()) {
+      out.handlerTime[name] = stats->handlerTime.get();
+    }
+  }
+  out.parseTime = parseTime.get();
+  out.serializeTime = serializeTime.get();
+  out.errors.clear();
+  for (auto& entry : errors) {
+    auto stats = entry.load(std::memory_order_acquire);
+    if (stats == nullptr) {
+      continue;
+    }
+    uint64_t count = 0;
+    for (auto& n : stats->count) {
+      count += n.load(std::memory_order_relaxed);
+    }
+    out.errors[stats->kind] += count;
+  }
+}
+
+SessionStatsCollector::TypeStats* SessionStatsCollector::lookup(
+    const TypeInfo* typeinfo) {
+  return lookup(types, typeinfo);
+}
+
+template <typename Stats, typename Key, size_t N>
+Stats* SessionStatsCollector::lookup(std::atomic<Stats*> (&table)[N],
+                                     Key key) {
+  // TypeInfos are pointer aligned, so their low bits are always zero.
+  auto address = reinterpret_cast<uintptr_t>(key);
+  auto hash = address ^ (address / sizeof(void*));
+  for (size_t i = 0; i < N; i++) {
+    auto& entry = table[(hash + i) % N];
+    auto stats = entry.load(std::memory_order_acquire);
+    if (stats == nullptr) {
+      auto added = new Stats(key);
+      if (entry.compare_exchange_strong(stats, added,
+                                        std::memory_order_acq_rel)) {
+        return added;
+      }
+      // Another thread added an entry to this slot first.
+      delete added;
+    }
+    if (stats->key() == key) {
+      return stats;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace dap
+
+#endif  // dap_session_stats_h
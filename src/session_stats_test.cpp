@@ -0,0 +1,123 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "session_stats.h"
+
+#include "dap/protocol.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+using us = std::chrono::microseconds;
+
+TEST(AtomicHistogram, Buckets) {
+  dap::AtomicHistogram histogram;
+  ASSERT_TRUE(histogram.empty());
+  histogram.record(std::chrono::nanoseconds(500));
+  histogram.record(us(1));
+  histogram.record(us(3));
+  histogram.record(us(3));
+  histogram.record(std::chrono::hours(24 * 365));
+  ASSERT_FALSE(histogram.empty());
+
+  auto got = histogram.get();
+  ASSERT_EQ(got.count, 5u);
+  ASSERT_EQ(got.buckets[0], 1u);
+  ASSERT_EQ(got.buckets[1], 1u);
+  ASSERT_EQ(got.buckets[2], 2u);
+  ASSERT_EQ(got.buckets[dap::DurationHistogram::kNumBuckets - 1], 1u);
+}
+
+TEST(AtomicHistogram, Percentile) {
+  dap::AtomicHistogram histogram;
+  ASSERT_EQ(histogram.get().percentile(0.5), us(0));
+  for (int i = 0; i < 90; i++) {
+    histogram.record(us(10));
+  }
+  for (int i = 0; i < 10; i++) {
+    histogram.record(us(1000));
+  }
+  auto got = histogram.get();
+  ASSERT_EQ(got.total, us(90 * 10 + 10 * 1000));
+  ASSERT_EQ(got.percentile(0.5), us(16));
+  ASSERT_EQ(got.percentile(0.95), us(1024));
+  ASSERT_EQ(got.percentile(1.0), us(1024));
+}
+
+TEST(SessionStatsCollector, Messages) {
+  dap::SessionStatsCollector collector;
+  auto launch = dap::TypeOf<dap::LaunchRequest>::type();
+  auto output = dap::TypeOf<dap::OutputEvent>::type();
+
+  constexpr int numThreads = 4;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; i++) {
+    threads.emplace_back([&] {
+      collector.received(dap::SessionStatsCollector::kRequest, launch, 10);
+      collector.sent(dap::SessionStatsCollector::kResponse, launch, 20);
+      collector.sent(dap::SessionStatsCollector::kEvent, output, 30);
+      collector.handled(launch, us(5));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  collector.error("Unknown message type '%s'");
+
+  dap::SessionStats stats;
+  collector.get(stats);
+  ASSERT_EQ(stats.requests.size(), 1u);
+  ASSERT_EQ(stats.requests["launch"].received, uint64_t(numThreads));
+  ASSERT_EQ(stats.requests["launch"].bytesReceived, uint64_t(numThreads * 10));
+  ASSERT_EQ(stats.requests["launch"].sent, 0u);
+  ASSERT_EQ(stats.responses["launch"].sent, uint64_t(numThreads));
+  ASSERT_EQ(stats.responses["launch"].bytesSent, uint64_t(numThreads * 20));
+  ASSERT_EQ(stats.events.size(), 1u);
+  ASSERT_EQ(stats.events["output"].bytesSent, uint64_t(numThreads * 30));
+  ASSERT_EQ(stats.handlerTime["launch"].count, uint64_t(numThreads));
+  ASSERT_EQ(stats.errors["Unknown message type '%s'"], 1u);
+}
+
+TEST(SessionStatsCollector, Errors) {
+  dap::SessionStatsCollector collector;
+  // Errors are counted by format string, even if the same format string is
+  // held at two addresses.
+  static const char a[] = "Failed to deserialize request";
+  static const char b[] = "Failed to deserialize request";
+
+  constexpr int numThreads = 4;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; i++) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 100; j++) {
+        collector.error(a);
+        collector.error(b);
+        collector.error("Unknown message type '%s'");
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  dap::SessionStats stats;
+  collector.get(stats);
+  ASSERT_EQ(stats.errors.size(), 2u);
+  ASSERT_EQ(stats.errors[a], uint64_t(numThreads * 200));
+  ASSERT_EQ(stats.errors["Unknown message type '%s'"],
+            uint64_t(numThreads * 100));
+}
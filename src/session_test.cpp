@@ -13,17 +13,21 @@
 // limitations under the License.
 
 #include "dap/session.h"
+#include "dap/interned_string.h"
 #include "dap/io.h"
 #include "dap/protocol.h"
+#include "dap/tracer.h"
 
 #include "chan.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <thread>
 
@@ -97,6 +101,44 @@ DAP_STRUCT_TYPEINFO(TestEvent,
                     DAP_FIELD(o1, "evt_o1"),
                     DAP_FIELD(o2, "evt_o2"));
 
+// TestRequestSubset has the same command as TestRequest, but only some of its
+// fields.
+struct TestRequestSubset : public Request {
+  using Response = TestResponse;
+
+  integer i;
+  string s;
+};
+
+DAP_STRUCT_TYPEINFO(TestRequestSubset,
+                    "test-request",
+                    DAP_FIELD(i, "req_i"),
+                    DAP_FIELD(s, "req_s"));
+
+// TestRequestMismatch has the same command as TestRequest, with a field of a
+// different type.
+struct TestRequestMismatch : public Request {
+  using Response = TestResponse;
+
+  integer s;
+};
+
+DAP_STRUCT_TYPEINFO(TestRequestMismatch,
+                    "test-request",
+                    DAP_FIELD(s, "req_s"));
+
+// TestInternedRequest has the same command as TestRequest, with its string
+// field interned.
+struct TestInternedRequest : public Request {
+  using Response = TestResponse;
+
+  interned_string s;
+};
+
+DAP_STRUCT_TYPEINFO(TestInternedRequest,
+                    "test-request",
+                    DAP_FIELD(s, "req_s"));
+
 };  // namespace dap
 
 namespace {
@@ -193,6 +235,57 @@ TEST_F(SessionTest, Request) {
   ASSERT_EQ(received.o2, request.o2);
 }
 
+TEST_F(SessionTest, RequestView) {
+  dap::integer i = 0;
+  dap::string s;
+  dap::array<dap::integer> a;
+  server->registerHandler([&](const dap::RequestView<dap::TestRequest>& req) {
+    EXPECT_TRUE(req.field("req_i", &i));
+    EXPECT_TRUE(req.field("req_s", &s));
+    EXPECT_FALSE(req.field("missing", &s));
+    a = req.get().a;
+    return createResponse();
+  });
+
+  bind();
+
+  auto request = createRequest();
+  auto got = client->send(request).get();
+  ASSERT_FALSE(got.error);
+  ASSERT_EQ(got.response.s, createResponse().s);
+  ASSERT_EQ(i, request.i);
+  ASSERT_EQ(s, request.s);
+  ASSERT_EQ(a, request.a);
+}
+
+TEST_F(SessionTest, RequestViewInvalid) {
+  for (bool inProcess : {false, true}) {
+    client = dap::Session::create();
+    server = dap::Session::create();
+    dap::Chan<std::string> errors;
+    server->onError([&](const std::string& err) { errors.put(err); });
+    bool valid = true;
+    server->registerHandler(
+        [&](const dap::RequestView<dap::TestRequestMismatch>& req) {
+          req.get();
+          valid = req.valid();
+          return createResponse();
+        });
+
+    if (inProcess) {
+      dap::Session::pairInProcess(client.get(), server.get());
+    } else {
+      bind();
+    }
+
+    auto got = client->send(createRequest()).get();
+    ASSERT_FALSE(valid);
+    ASSERT_TRUE(got.error);
+    ASSERT_EQ(got.error.message, "Failed to deserialize request");
+    ASSERT_EQ(errors.take().value(), "Failed to deserialize request");
+  }
+}
+
 TEST_F(SessionTest, RequestResponseSuccess) {
   server->registerHandler(
       [&](const dap::TestRequest&) { return createResponse(); });
@@ -473,6 +566,129 @@ TEST_F(SessionTest, Event) {
   ASSERT_EQ(got.o2, event.o2);
 }
 
+TEST_F(SessionTest, FrozenHandlers) {
+  dap::Chan<dap::TestEvent> events;
+  dap::Chan<dap::ResponseOrError<dap::TestResponse>> sent;
+  server->registerHandler([&](const dap::TestEvent& e) { events.put(e); });
+  server->registerSentHandler(
+      [&](const dap::ResponseOrError<dap::TestResponse> r) { sent.put(r); });
+  server->freezeHandlers();
+
+  // Handlers registered after freezeHandlers() are still used.
+  server->registerHandler(
+      [&](const dap::TestRequest&) { return createResponse(); });
+
+  bind();
+
+  auto got = client->send(createRequest()).get();
+  ASSERT_EQ(got.error, false);
+  ASSERT_EQ(got.response.s, "ROGER");
+  ASSERT_EQ(sent.take().value().response.s, "ROGER");
+
+  client->send(createEvent());
+  ASSERT_EQ(events.take().value().s, createEvent().s);
+}
+
+TEST_F(SessionTest, FrozenHandlersReclaimed) {
+  auto token = std::make_shared<int>(0);
+  server->registerHandler([token](const dap::TestEvent&) {});
+  server->freezeHandlers();
+
+  // Each registration replaces the snapshot. The replaced snapshots, which
+  // hold copies of the event handler, are freed as no lookup is reading them.
+  for (int i = 0; i < 16; i++) {
+    server->setDispatchMode<dap::TestRequest>(dap::kInline);
+  }
+  // The token, the registered handler and the current snapshot's handler.
+  ASSERT_EQ(token.use_count(), 3);
+}
+
+TEST_F(SessionTest, Feed) {
+  server->registerHandler([&](const dap::TestRequest& req) {
+    auto response = createResponse();
+    response.i = req.i;
+    return response;
+  });
+
+  // The server has no Reader, and is driven by feed() on this thread.
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->bind(server2client, client2server);
+  server->connect(nullptr, server2client);
+
+  std::vector<dap::future<dap::ResponseOrError<dap::TestResponse>>> responses;
+  for (int i = 0; i < 3; i++) {
+    auto request = createRequest();
+    request.i = i;
+    responses.emplace_back(client->send(request));
+  }
+
+  // Pass the requests to the server one byte at a time.
+  size_t numPayloads = 0;
+  while (numPayloads < 3) {
+    char c;
+    ASSERT_EQ(client2server->read(&c, 1), 1u);
+    for (auto& payload : server->feed(&c, 1)) {
+      payload();
+      numPayloads++;
+    }
+  }
+
+  for (int i = 0; i < 3; i++) {
+    auto got = responses[i].get();
+    ASSERT_FALSE(got.error);
+    ASSERT_EQ(got.response.i, dap::integer(i));
+  }
+}
+
+TEST_F(SessionTest, InlineDispatch) {
+  std::mutex mutex;
+  std::vector<std::string> order;
+  std::vector<std::thread::id> requestThreads;
+  std::thread::id eventThread;
+  dap::Chan<bool> eventStarted;
+  dap::Chan<bool> releaseEvent;
+
+  server->registerHandler([&](const dap::TestRequest&) {
+    std::unique_lock<std::mutex> lock(mutex);
+    order.emplace_back("request");
+    requestThreads.emplace_back(std::this_thread::get_id());
+    return createResponse();
+  });
+  server->registerHandler([&](const dap::TestEvent&) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      eventThread = std::this_thread::get_id();
+    }
+    eventStarted.put(true);
+    releaseEvent.take();
+    std::unique_lock<std::mutex> lock(mutex);
+    order.emplace_back("event");
+  });
+  server->setDispatchMode<dap::TestRequest>(dap::kInline);
+
+  bind();
+
+  // Nothing is queued, so the request is handled on the receive thread.
+  ASSERT_FALSE(client->send(createRequest()).get().error);
+
+  // The event blocks the dispatch thread, so the next request must be queued
+  // behind it.
+  client->send(createEvent());
+  eventStarted.take();
+  auto response = client->send(createRequest());
+  ASSERT_EQ(response.wait_for(std::chrono::milliseconds(50)),
+            dap::future_status::timeout);
+  releaseEvent.put(true);
+  ASSERT_FALSE(response.get().error);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  ASSERT_EQ(order,
+            std::vector<std::string>({"request", "event", "request"}));
+  ASSERT_NE(requestThreads[0], eventThread);
+  ASSERT_EQ(requestThreads[1], eventThread);
+}
+
 TEST_F(SessionTest, RegisterHandlerFunction) {
   struct S {
     static dap::TestResponse requestA(const dap::TestRequest&) { return {}; }
@@ -623,3 +839,1185 @@ TEST_F(SessionTest, OnServerClosed) {
   std::unique_lock<std::mutex> lock(mutex);
   cv.wait(lock, [&] { return static_cast<bool>(serverClosed); });
 }
+
+TEST_F(SessionTest, CoalesceRequests) {
+  int numCalls = 0;
+  server->registerHandler([&](const dap::TestRequest& req) {
+    numCalls++;
+    auto response = createResponse();
+    response.s = req.s;
+    return response;
+  });
+  server->setRequestPolicy<dap::TestRequest>(dap::kCoalesce);
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->connect(server2client, client2server);
+  server->connect(client2server, server2client);
+
+  auto requestA = createRequest();
+  auto requestB = createRequest();
+  requestB.s = "different";
+  auto responseA1 = client->send(requestA);
+  auto responseA2 = client->send(requestA);
+  auto responseB = client->send(requestB);
+
+  // The second request is coalesced with the first, and so does not produce a
+  // payload.
+  auto payloadA1 = server->getPayload();
+  auto payloadA2 = server->getPayload();
+  auto payloadB = server->getPayload();
+  ASSERT_TRUE(payloadA1);
+  ASSERT_FALSE(payloadA2);
+  ASSERT_TRUE(payloadB);
+  payloadA1();
+  payloadB();
+  ASSERT_EQ(numCalls, 2);
+
+  for (int i = 0; i < 3; i++) {
+    if (auto payload = client->getPayload()) {
+      payload();
+    }
+  }
+
+  auto gotA1 = responseA1.get();
+  auto gotA2 = responseA2.get();
+  auto gotB = responseB.get();
+  ASSERT_FALSE(gotA1.error);
+  ASSERT_FALSE(gotA2.error);
+  ASSERT_FALSE(gotB.error);
+  ASSERT_EQ(gotA1.response.s, "request");
+  ASSERT_EQ(gotA2.response.s, "request");
+  ASSERT_EQ(gotB.response.s, "different");
+}
+
+TEST_F(SessionTest, CoalesceRequestViews) {
+  int numCalls = 0;
+  server->registerHandler([&](const dap::RequestView<dap::TestRequest>& req) {
+    numCalls++;
+    auto response = createResponse();
+    req.field("req_s", &response.s);
+    return response;
+  });
+  server->setRequestPolicy<dap::TestRequest>(dap::kCoalesce);
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->connect(server2client, client2server);
+  server->connect(client2server, server2client);
+
+  auto requestA = createRequest();
+  auto requestB = createRequest();
+  requestB.s = "different";
+  auto responseA1 = client->send(requestA);
+  auto responseA2 = client->send(requestA);
+  auto responseB = client->send(requestB);
+
+  // Requests are coalesced by their arguments.
+  auto payloadA1 = server->getPayload();
+  auto payloadA2 = server->getPayload();
+  auto payloadB = server->getPayload();
+  ASSERT_TRUE(payloadA1);
+  ASSERT_FALSE(payloadA2);
+  ASSERT_TRUE(payloadB);
+  payloadA1();
+  payloadB();
+  ASSERT_EQ(numCalls, 2);
+
+  for (int i = 0; i < 3; i++) {
+    if (auto payload = client->getPayload()) {
+      payload();
+    }
+  }
+
+  ASSERT_EQ(responseA1.get().response.s, "request");
+  ASSERT_EQ(responseA2.get().response.s, "request");
+  ASSERT_EQ(responseB.get().response.s, "different");
+}
+
+TEST_F(SessionTest, CoalesceRequestViewsByType) {
+  int numCalls = 0;
+  server->registerHandler(
+      [&](const dap::RequestView<dap::TestRequestSubset>& req) {
+        numCalls++;
+        auto response = createResponse();
+        req.field("req_s", &response.s);
+        return response;
+      });
+  server->setRequestPolicy<dap::TestRequestSubset>(dap::kCoalesce);
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->connect(server2client, client2server);
+  server->connect(client2server, server2client);
+
+  // The requests differ only in fields that TestRequestSubset does not have,
+  // so they have the same arguments as the handler's request type.
+  auto requestA = createRequest();
+  auto requestB = createRequest();
+  requestB.b = true;
+  requestB.a = {1};
+  auto responseA = client->send(requestA);
+  auto responseB = client->send(requestB);
+
+  auto payloadA = server->getPayload();
+  auto payloadB = server->getPayload();
+  ASSERT_TRUE(payloadA);
+  ASSERT_FALSE(payloadB);
+  payloadA();
+  ASSERT_EQ(numCalls, 1);
+
+  for (int i = 0; i < 2; i++) {
+    if (auto payload = client->getPayload()) {
+      payload();
+    }
+  }
+
+  ASSERT_EQ(responseA.get().response.s, "request");
+  ASSERT_EQ(responseB.get().response.s, "request");
+}
+
+TEST_F(SessionTest, LatestWinsRequests) {
+  std::vector<dap::string> handled;
+  server->registerHandler([&](const dap::TestRequest& req) {
+    handled.push_back(req.s);
+    return createResponse();
+  });
+  server->setRequestPolicy<dap::TestRequest>(dap::kLatestWins);
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->connect(server2client, client2server);
+  server->connect(client2server, server2client);
+
+  std::vector<dap::future<dap::ResponseOrError<dap::TestResponse>>> responses;
+  for (auto s : {"one", "two", "three"}) {
+    auto request = createRequest();
+    request.s = s;
+    responses.emplace_back(client->send(request));
+  }
+
+  std::vector<std::function<void()>> payloads;
+  for (int i = 0; i < 3; i++) {
+    payloads.emplace_back(server->getPayload());
+  }
+  for (auto& payload : payloads) {
+    ASSERT_TRUE(payload);
+    payload();
+  }
+  ASSERT_EQ(handled, std::vector<dap::string>{"three"});
+
+  for (int i = 0; i < 3; i++) {
+    if (auto payload = client->getPayload()) {
+      payload();
+    }
+  }
+
+  auto got1 = responses[0].get();
+  auto got2 = responses[1].get();
+  auto got3 = responses[2].get();
+  ASSERT_TRUE(got1.error);
+  ASSERT_EQ(got1.error.message, "cancelled");
+  ASSERT_TRUE(got2.error);
+  ASSERT_EQ(got2.error.message, "cancelled");
+  ASSERT_FALSE(got3.error);
+}
+
+TEST_F(SessionTest, RequestTimeout) {
+  using ResponseCallback =
+      std::function<void(dap::ResponseOrError<dap::TestResponse>)>;
+
+  std::vector<ResponseCallback> callbacks;  // never called
+  server->registerHandler(
+      [&](const dap::TestRequest&, const ResponseCallback& callback) {
+        callbacks.push_back(callback);
+      });
+
+  bind();
+
+  client->setRequestTimeout(std::chrono::milliseconds(20));
+  auto got = client->send(createRequest()).get();
+  ASSERT_TRUE(got.error);
+  ASSERT_EQ(got.error.message, "Request timed out");
+
+  // Per-request timeout overrides the default.
+  client->setRequestTimeout(std::chrono::milliseconds(0));
+  got = client->send(createRequest(), std::chrono::milliseconds(20)).get();
+  ASSERT_TRUE(got.error);
+  ASSERT_EQ(got.error.message, "Request timed out");
+
+  auto stats = client->pendingRequestStats();
+  ASSERT_EQ(stats.pending, 0U);
+  ASSERT_EQ(stats.timedOut, 2U);
+
+  // Stop the server's dispatch thread before callbacks is destructed.
+  server.reset();
+}
+
+TEST_F(SessionTest, LateResponse) {
+  using ResponseCallback =
+      std::function<void(dap::ResponseOrError<dap::TestResponse>)>;
+
+  dap::Chan<ResponseCallback> callbacks;
+  server->registerHandler(
+      [&](const dap::TestRequest&, const ResponseCallback& callback) {
+        callbacks.put(callback);
+      });
+  dap::Chan<std::string> errors;
+  client->onError([&](const std::string& err) { errors.put(err); });
+  dap::Chan<bool> events;
+  client->registerHandler([&](const dap::TestEvent&) { events.put(true); });
+
+  bind();
+
+  auto got = client->send(createRequest(), std::chrono::milliseconds(20));
+  ASSERT_EQ(got.get().error.message, "Request timed out");
+
+  // The response to the timed out request is dropped without an error.
+  callbacks.take().value()(createResponse());
+  server->send(createEvent());
+  events.take();
+  errors.close();
+  ASSERT_FALSE(errors.take().has_value());
+}
+
+TEST_F(SessionTest, MaxPendingRequests) {
+  using ResponseCallback =
+      std::function<void(dap::ResponseOrError<dap::TestResponse>)>;
+
+  dap::Chan<ResponseCallback> callbacks;
+  server->registerHandler(
+      [&](const dap::TestRequest&, const ResponseCallback& callback) {
+        callbacks.put(callback);
+      });
+
+  bind();
+
+  client->setMaxPendingRequests(1, std::chrono::seconds(10));
+  auto first = client->send(createRequest());
+  auto firstCallback = callbacks.take().value();
+  ASSERT_EQ(client->pendingRequestStats().pending, 1U);
+
+  // The second request waits until the first has a response.
+  using Future = dap::future<dap::ResponseOrError<dap::TestResponse>>;
+  std::unique_ptr<Future> second;
+  std::thread thread(
+      [&] { second.reset(new Future(client->send(createRequest()))); });
+  while (client->pendingRequestStats().blocked == 0) {
+    std::this_thread::yield();
+  }
+  firstCallback(createResponse());
+  thread.join();
+
+  callbacks.take().value()(createResponse());
+  ASSERT_FALSE(first.get().error);
+  ASSERT_FALSE(second->get().error);
+
+  auto stats = client->pendingRequestStats();
+  ASSERT_EQ(stats.pending, 0U);
+  ASSERT_EQ(stats.peak, 1U);
+  ASSERT_EQ(stats.blocked, 1U);
+}
+
+TEST_F(SessionTest, MaxPendingRequestsFailFast) {
+  using ResponseCallback =
+      std::function<void(dap::ResponseOrError<dap::TestResponse>)>;
+
+  dap::Chan<ResponseCallback> callbacks;
+  server->registerHandler(
+      [&](const dap::TestRequest&, const ResponseCallback& callback) {
+        callbacks.put(callback);
+      });
+
+  bind();
+
+  client->setMaxPendingRequests(1);
+  auto first = client->send(createRequest());
+  auto firstCallback = callbacks.take().value();
+
+  // Without a wait, a request over the limit fails immediately.
+  auto second = client->send(createRequest()).get();
+  ASSERT_EQ(second.error.message, "Failed to send request");
+
+  // A bounded wait fails once it has elapsed.
+  client->setMaxPendingRequests(1, std::chrono::milliseconds(20));
+  auto third = client->send(createRequest()).get();
+  ASSERT_EQ(third.error.message, "Failed to send request");
+
+  firstCallback(createResponse());
+  ASSERT_FALSE(first.get().error);
+
+  auto stats = client->pendingRequestStats();
+  ASSERT_EQ(stats.pending, 0U);
+  ASSERT_EQ(stats.blocked, 1U);
+  ASSERT_EQ(stats.rejected, 2U);
+}
+
+TEST_F(SessionTest, RequestTimeoutDuringFailedWrite) {
+  // BlockingWriter fails each write once it is released.
+  class BlockingWriter : public dap::Writer {
+   public:
+    bool isOpen() override { return true; }
+    void close() override {}
+    bool write(const void*, size_t) override {
+      writing.put(true);
+      release.take();
+      return false;
+    }
+
+    dap::Chan<bool> writing;
+    dap::Chan<bool> release;
+  };
+
+  auto writer = std::make_shared<BlockingWriter>();
+  client->onError([&](const std::string&) {});
+  client->connect(dap::pipe(), writer);
+
+  // The timeout expires while the request is being written. send() still
+  // reports the failed write, and the response handler is not called.
+  auto request = createRequest();
+  std::atomic<int> handled = {0};
+  std::atomic<bool> sent = {true};
+  std::thread thread([&] {
+    sent = client->send(
+        dap::TypeOf<dap::TestRequest>::type(),
+        dap::TypeOf<dap::TestResponse>::type(), &request,
+        [&](const void*, const dap::Error*) { handled++; },
+        std::chrono::milliseconds(10));
+  });
+  writer->writing.take();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  writer->release.put(true);
+  thread.join();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  ASSERT_FALSE(sent);
+  ASSERT_EQ(handled, 0);
+  auto stats = client->pendingRequestStats();
+  ASSERT_EQ(stats.pending, 0U);
+  ASSERT_EQ(stats.timedOut, 0U);
+}
+
+TEST_F(SessionTest, MaxPendingRequestsFailedSend) {
+  client->onError([&](const std::string&) {});
+  client->setMaxPendingRequests(1);
+  client->setRequestTimeout(std::chrono::milliseconds(20));
+
+  // Requests that fail to send do not hold a slot, and are not completed
+  // again by their timeout.
+  for (int i = 0; i < 2; i++) {
+    auto got = client->send(createRequest()).get();
+    ASSERT_EQ(got.error.message, "Failed to send request");
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  auto stats = client->pendingRequestStats();
+  ASSERT_EQ(stats.pending, 0U);
+  ASSERT_EQ(stats.timedOut, 0U);
+}
+
+TEST_F(SessionTest, MaxPendingRequestsOnReceiveThread) {
+  dap::Chan<bool> release;
+  server->registerHandler([&](const dap::TestRequest&) {
+    release.take();
+    return createResponse();
+  });
+  dap::Chan<dap::ResponseOrError<dap::TestResponse>> nested;
+  client->registerHandler([&](const dap::TestRequest&) {
+    // This handler runs on the receive thread, which must not block waiting
+    // for a response that only it can process.
+    nested.put(client->send(createRequest()).get());
+    return createResponse();
+  });
+  client->setDispatchMode<dap::TestRequest>(dap::kInline);
+
+  bind();
+
+  client->setMaxPendingRequests(1);
+  auto first = client->send(createRequest());
+  ASSERT_FALSE(server->send(createRequest()).get().error);
+  auto got = nested.take();
+  ASSERT_TRUE(got.has_value());
+  ASSERT_EQ(got->error.message, "Failed to send request");
+
+  release.put(true);
+  ASSERT_FALSE(first.get().error);
+}
+
+TEST(SessionExecutorTest, SharedExecutor) {
+  constexpr int numSessions = 8;
+  constexpr int numRequests = 20;
+
+  auto executor = dap::Executor::create(2);
+  dap::Session::Options options;
+  options.executor = executor;
+
+  struct Pair {
+    std::unique_ptr<dap::Session> client;
+    std::unique_ptr<dap::Session> server;
+    std::vector<dap::integer> received;  // only accessed by the server strand
+  };
+  std::vector<Pair> pairs(numSessions);
+  for (auto& pair : pairs) {
+    pair.client = dap::Session::create(options);
+    pair.server = dap::Session::create(options);
+    auto received = &pair.received;
+    pair.server->registerHandler([received](const dap::TestRequest& req) {
+      received->push_back(req.i);
+      auto response = createResponse();
+      response.i = req.i;
+      return response;
+    });
+    auto client2server = dap::pipe();
+    auto server2client = dap::pipe();
+    pair.client->bind(server2client, client2server);
+    pair.server->bind(client2server, server2client);
+  }
+
+  std::vector<dap::future<dap::ResponseOrError<dap::TestResponse>>> responses;
+  for (int i = 0; i < numRequests; i++) {
+    for (auto& pair : pairs) {
+      auto request = createRequest();
+      request.i = i;
+      responses.emplace_back(pair.client->send(request));
+    }
+  }
+  for (size_t i = 0; i < responses.size(); i++) {
+    auto got = responses[i].get();
+    ASSERT_FALSE(got.error);
+    ASSERT_EQ(got.response.i, dap::integer(i / numSessions));
+  }
+
+  // Requests for each session were handled in the order they were sent.
+  for (auto& pair : pairs) {
+    pair.server.reset();
+    ASSERT_EQ(pair.received.size(), size_t(numRequests));
+    for (int i = 0; i < numRequests; i++) {
+      ASSERT_EQ(pair.received[i], dap::integer(i));
+    }
+  }
+}
+
+TEST(SessionExecutorTest, Feed) {
+  constexpr int numSessions = 4;
+  constexpr int numRequests = 10;
+
+  // BufferWriter holds the bytes written by a client, to be fed to a server.
+  struct BufferWriter : public dap::Writer {
+    bool isOpen() override { return true; }
+    void close() override {}
+    bool write(const void* buffer, size_t n) override {
+      std::unique_lock<std::mutex> lock(mutex);
+      data.append(reinterpret_cast<const char*>(buffer), n);
+      return true;
+    }
+
+    std::mutex mutex;
+    std::string data;
+  };
+
+  dap::Session::Options options;
+  options.executor = dap::Executor::create(2);
+
+  struct Pair {
+    std::unique_ptr<dap::Session> client;
+    std::unique_ptr<dap::Session> server;
+    std::shared_ptr<BufferWriter> client2server;
+    std::vector<dap::integer> received;  // only accessed by the server strand
+  };
+  auto feedThread = std::this_thread::get_id();
+  std::atomic<bool> handledOnFeedThread = {false};
+  std::vector<Pair> pairs(numSessions);
+  for (auto& pair : pairs) {
+    pair.client = dap::Session::create();
+    pair.server = dap::Session::create(options);
+    auto received = &pair.received;
+    pair.server->registerHandler([&, received](const dap::TestRequest& req) {
+      if (std::this_thread::get_id() == feedThread) {
+        handledOnFeedThread = true;
+      }
+      received->push_back(req.i);
+      auto response = createResponse();
+      response.i = req.i;
+      return response;
+    });
+    // The servers have no Reader, and are all fed by this thread.
+    pair.client2server = std::make_shared<BufferWriter>();
+    auto server2client = dap::pipe();
+    pair.client->bind(server2client, pair.client2server);
+    pair.server->connect(nullptr, server2client);
+  }
+
+  std::vector<dap::future<dap::ResponseOrError<dap::TestResponse>>> responses;
+  for (int i = 0; i < numRequests; i++) {
+    for (auto& pair : pairs) {
+      auto request = createRequest();
+      request.i = i;
+      responses.emplace_back(pair.client->send(request));
+    }
+  }
+
+  // Feed the requests in small chunks, alternating between the sessions.
+  constexpr size_t kChunk = 64;
+  for (size_t offset = 0;; offset += kChunk) {
+    bool fed = false;
+    for (auto& pair : pairs) {
+      auto& data = pair.client2server->data;
+      if (offset < data.size()) {
+        auto n = std::min(kChunk, data.size() - offset);
+        ASSERT_TRUE(pair.server->feed(&data[offset], n).empty());
+        fed = true;
+      }
+    }
+    if (!fed) {
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < responses.size(); i++) {
+    auto got = responses[i].get();
+    ASSERT_FALSE(got.error);
+    ASSERT_EQ(got.response.i, dap::integer(i / numSessions));
+  }
+  ASSERT_FALSE(handledOnFeedThread);
+  for (auto& pair : pairs) {
+    pair.server.reset();
+    ASSERT_EQ(pair.received.size(), size_t(numRequests));
+    for (int i = 0; i < numRequests; i++) {
+      ASSERT_EQ(pair.received[i], dap::integer(i));
+    }
+  }
+}
+
+TEST_F(SessionTest, OutputAggregation) {
+  dap::Chan<std::string> received;
+  server->registerHandler([&](const dap::OutputEvent& e) {
+    received.put(e.category.value("") + ":" + e.output);
+  });
+  server->registerHandler(
+      [&](const dap::TestEvent&) { received.put("TestEvent"); });
+
+  bind();
+
+  auto output = [&](const char* category, const char* text) {
+    dap::OutputEvent event;
+    event.category = category;
+    event.output = text;
+    client->send(event);
+  };
+
+  // Merged output is flushed before any other message.
+  client->setOutputAggregation(std::chrono::seconds(10), 1024);
+  output("stdout", "a");
+  output("stdout", "b");
+  output("stderr", "c");
+  output("stderr", "d");
+  client->send(createEvent());
+  ASSERT_EQ(received.take().value(), "stdout:ab");
+  ASSERT_EQ(received.take().value(), "stderr:cd");
+  ASSERT_EQ(received.take().value(), "TestEvent");
+
+  // Merged output is flushed once it reaches maxBytes, or the window elapses.
+  client->setOutputAggregation(std::chrono::milliseconds(10), 4);
+  output("stdout", "aa");
+  output("stdout", "bb");
+  output("stdout", "cc");
+  ASSERT_EQ(received.take().value(), "stdout:aabb");
+  ASSERT_EQ(received.take().value(), "stdout:cc");
+
+  // Output is only merged with output from the same source.
+  client->setOutputAggregation(std::chrono::seconds(10), 1024);
+  auto sourced = [&](const char* path, const char* text) {
+    dap::OutputEvent event;
+    event.category = "stdout";
+    event.output = text;
+    event.source = dap::Source();
+    event.source->path = path;
+    client->send(event);
+  };
+  sourced("a.cpp", "a");
+  sourced("a.cpp", "b");
+  sourced("b.cpp", "c");
+  client->send(createEvent());
+  ASSERT_EQ(received.take().value(), "stdout:ab");
+  ASSERT_EQ(received.take().value(), "stdout:c");
+  ASSERT_EQ(received.take().value(), "TestEvent");
+}
+
+TEST_F(SessionTest, SendOutput) {
+  dap::Chan<dap::OutputEvent> received;
+  server->registerHandler(
+      [&](const dap::OutputEvent& e) { received.put(e); });
+
+  bind();
+
+  std::string output = "line 1\n\"quoted\"\t\\path\\\x01 caf\xc3\xa9";
+  ASSERT_TRUE(client->sendOutput(output.data(), output.size(), "stdout"));
+  auto got = received.take();
+  ASSERT_TRUE(got.has_value());
+  ASSERT_EQ(got->category.value(""), "stdout");
+  ASSERT_EQ(got->output, output);
+
+  // A null category is omitted, and invalid UTF-8 is replaced.
+  ASSERT_TRUE(client->sendOutput("a\xff" "b", 3));
+  got = received.take();
+  ASSERT_TRUE(got.has_value());
+  ASSERT_FALSE(got->category.has_value());
+  ASSERT_EQ(got->output, "a\xef\xbf\xbd" "b");
+
+  // Output is aggregated with other OutputEvents, and invalid UTF-8 is only
+  // replaced once the merged output is sent.
+  client->setOutputAggregation(std::chrono::seconds(10), 16);
+  dap::OutputEvent event;
+  event.category = "stdout";
+  event.output = "aggregated ";
+  client->send(event);
+  ASSERT_TRUE(client->sendOutput("caf\xc3", 4, "stdout"));
+  ASSERT_TRUE(client->sendOutput("\xa9 \xff", 3, "stdout"));
+  ASSERT_TRUE(client->sendOutput("err", 3, "stderr"));
+  got = received.take();
+  ASSERT_EQ(got->category.value(""), "stdout");
+  ASSERT_EQ(got->output, "aggregated caf\xc3\xa9 \xef\xbf\xbd");
+
+  // Output larger than maxBytes is sent directly, after the pending output.
+  std::string large(32, 'x');
+  ASSERT_TRUE(client->sendOutput(large.data(), large.size(), "stdout"));
+  ASSERT_EQ(received.take()->output, "err");
+  ASSERT_EQ(received.take()->output, large);
+
+  auto stats = client->stats();
+  ASSERT_EQ(stats.events["output"].sent, 5u);
+}
+
+namespace {
+
+// GatedWriter blocks the first write until released.
+class GatedWriter : public dap::Writer {
+ public:
+  GatedWriter(const std::shared_ptr<dap::Writer>& inner) : inner(inner) {}
+  bool isOpen() override { return inner->isOpen(); }
+  void close() override { inner->close(); }
+  bool write(const void* buffer, size_t n) override {
+    if (!gated.exchange(true)) {
+      entered.put(true);
+      release.take();
+    }
+    return inner->write(buffer, n);
+  }
+  dap::Chan<bool> entered;
+  dap::Chan<bool> release;
+
+ private:
+  std::shared_ptr<dap::Writer> inner;
+  std::atomic<bool> gated = {false};
+};
+
+}  // anonymous namespace
+
+TEST_F(SessionTest, EventConflation) {
+  dap::Chan<std::string> received;
+  client->registerHandler(
+      [&](const dap::TestEvent&) { received.put("TestEvent"); });
+  client->registerHandler([&](const dap::ProgressUpdateEvent& e) {
+    received.put(e.progressId + ":" + e.message.value(""));
+  });
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  auto gate = std::make_shared<GatedWriter>(server2client);
+  client->bind(server2client, client2server);
+  server->bind(client2server, gate);
+
+  server->setEventConflation<dap::ProgressUpdateEvent>(
+      [](const dap::ProgressUpdateEvent& e) { return e.progressId; });
+
+  // The first event blocks in the writer, so the following events wait in
+  // the outbox.
+  std::thread thread([&] { server->send(createEvent()); });
+  gate->entered.take();
+
+  auto progress = [&](const char* id, const char* message) {
+    dap::ProgressUpdateEvent event;
+    event.progressId = id;
+    event.message = message;
+    server->send(event);
+  };
+  progress("a", "10%");
+  progress("b", "10%");
+  progress("a", "20%");
+  progress("a", "30%");
+  progress("b", "20%");
+
+  gate->release.put(true);
+  thread.join();
+
+  ASSERT_EQ(received.take().value(), "TestEvent");
+  ASSERT_EQ(received.take().value(), "a:30%");
+  ASSERT_EQ(received.take().value(), "b:20%");
+
+  // Events are sent immediately when the writer is not busy.
+  progress("a", "40%");
+  ASSERT_EQ(received.take().value(), "a:40%");
+
+  // Once conflation is disabled, messages are written by the sending thread.
+  server->setEventConflation<dap::ProgressUpdateEvent>(nullptr);
+  progress("a", "50%");
+  progress("a", "60%");
+  ASSERT_EQ(received.take().value(), "a:50%");
+  ASSERT_EQ(received.take().value(), "a:60%");
+  ASSERT_EQ(server->stats().outboxDepth, 0u);
+}
+
+TEST_F(SessionTest, SendOutputOutbox) {
+  dap::Chan<std::string> received;
+  client->registerHandler(
+      [&](const dap::TestEvent&) { received.put("TestEvent"); });
+  client->registerHandler(
+      [&](const dap::OutputEvent& e) { received.put(e.output); });
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  auto gate = std::make_shared<GatedWriter>(server2client);
+  client->bind(server2client, client2server);
+  server->bind(client2server, gate);
+
+  server->setEventConflation<dap::ProgressUpdateEvent>(
+      [](const dap::ProgressUpdateEvent& e) { return e.progressId; });
+
+  // The first event blocks in the writer, so the output waits in the outbox
+  // behind it, in order.
+  std::thread thread([&] { server->send(createEvent()); });
+  gate->entered.take();
+  ASSERT_TRUE(server->sendOutput("a", 1));
+  ASSERT_TRUE(server->sendOutput("b", 1));
+  ASSERT_EQ(server->stats().outboxDepth, 2u);
+  gate->release.put(true);
+  thread.join();
+
+  ASSERT_EQ(received.take().value(), "TestEvent");
+  ASSERT_EQ(received.take().value(), "a");
+  ASSERT_EQ(received.take().value(), "b");
+
+  // Output is conflated when OutputEvents have a conflation key.
+  server->setEventConflation<dap::OutputEvent>(
+      [](const dap::OutputEvent& e) { return e.category.value(""); });
+  ASSERT_TRUE(server->sendOutput("c", 1, "console"));
+  ASSERT_EQ(received.take().value(), "c");
+}
+
+TEST_F(SessionTest, OutboxLimit) {
+  dap::Chan<int> received;
+  client->registerHandler(
+      [&](const dap::TestEvent& e) { received.put(int(e.i)); });
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  auto gate = std::make_shared<GatedWriter>(server2client);
+  client->bind(server2client, client2server);
+  server->bind(client2server, gate);
+
+  server->setEventConflation<dap::ProgressUpdateEvent>(
+      [](const dap::ProgressUpdateEvent& e) { return e.progressId; });
+
+  // The first event blocks in the writer, and the following events fill the
+  // outbox.
+  auto event = createEvent();
+  event.i = 0;
+  server->send(event);
+  gate->entered.take();
+  const int kMaxOutboxMessages = 1024;
+  for (int i = 1; i <= kMaxOutboxMessages; i++) {
+    event.i = i;
+    server->send(event);
+  }
+  ASSERT_EQ(server->stats().outboxDepth, size_t(kMaxOutboxMessages));
+
+  // Sending blocks until the outbox has room.
+  std::atomic<bool> sent = {false};
+  std::thread thread([&] {
+    event.i = kMaxOutboxMessages + 1;
+    server->send(event);
+    sent = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(sent.load());
+
+  gate->release.put(true);
+  thread.join();
+  for (int i = 0; i <= kMaxOutboxMessages + 1; i++) {
+    ASSERT_EQ(received.take().value(), i);
+  }
+}
+
+TEST_F(SessionTest, OutboxFailures) {
+  // FailingWriter fails all writes, while remaining open.
+  class FailingWriter : public dap::Writer {
+   public:
+    bool isOpen() override { return true; }
+    void close() override {}
+    bool write(const void*, size_t) override { return false; }
+  };
+
+  std::mutex errorsMutex;
+  std::vector<std::string> errors;
+  server->onError([&](const std::string& err) {
+    std::unique_lock<std::mutex> lock(errorsMutex);
+    errors.push_back(err);
+  });
+  auto gate = std::make_shared<GatedWriter>(std::make_shared<FailingWriter>());
+  server->connect(dap::pipe(), gate);
+  server->setEventConflation<dap::ProgressUpdateEvent>(
+      [](const dap::ProgressUpdateEvent& e) { return e.progressId; });
+  server->setOutboxLimit(1, std::chrono::milliseconds(10));
+
+  // The first event blocks in the writer, and the second fills the outbox.
+  auto event = createEvent();
+  auto typeinfo = dap::TypeOf<dap::TestEvent>::type();
+  ASSERT_TRUE(server->send(typeinfo, &event));
+  gate->entered.take();
+  ASSERT_TRUE(server->send(typeinfo, &event));
+
+  // The third event is rejected once the wait has elapsed.
+  ASSERT_FALSE(server->send(typeinfo, &event));
+
+  // The failed writes of the queued events are counted and reported.
+  gate->release.put(true);
+  while (server->stats().outboxWriteFailures < 2) {
+    std::this_thread::yield();
+  }
+  auto stats = server->stats();
+  ASSERT_EQ(stats.outboxRejected, 1u);
+  ASSERT_EQ(stats.outboxWriteFailures, 2u);
+
+  std::unique_lock<std::mutex> lock(errorsMutex);
+  ASSERT_EQ(std::count(errors.begin(), errors.end(),
+                       "Failed to send a message as the outbox is full"),
+            1);
+  ASSERT_EQ(std::count(errors.begin(), errors.end(),
+                       "Failed to write a message from the outbox"),
+            2);
+}
+
+TEST_F(SessionTest, Stats) {
+  server->registerHandler([&](const dap::TestRequest&) {
+    server->send(createEvent());
+    return createResponse();
+  });
+  client->registerHandler([&](const dap::TestEvent&) {});
+  dap::Chan<dap::SessionStats> reported;
+  server->onStats(std::chrono::milliseconds(10),
+                  [&](const dap::SessionStats& stats) { reported.put(stats); });
+
+  bind();
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_FALSE(client->send(createRequest()).get().error);
+  }
+
+  // The handler time is recorded once the handler returns, which can be
+  // after the response has been received.
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (server->stats().handlerTime["test-request"].count < 3) {
+    ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+    std::this_thread::yield();
+  }
+
+  auto server2client = server->stats();
+  ASSERT_EQ(server2client.requests["test-request"].received, 3u);
+  ASSERT_GT(server2client.requests["test-request"].bytesReceived, 0u);
+  ASSERT_EQ(server2client.responses["test-request"].sent, 3u);
+  ASSERT_EQ(server2client.events["test-event"].sent, 3u);
+  ASSERT_EQ(server2client.handlerTime["test-request"].count, 3u);
+  ASSERT_EQ(server2client.parseTime.count, 3u);
+  ASSERT_EQ(server2client.serializeTime.count, 6u);
+
+  auto client2server = client->stats();
+  ASSERT_EQ(client2server.requests["test-request"].sent, 3u);
+  ASSERT_EQ(client2server.responses["test-request"].received, 3u);
+  ASSERT_EQ(client2server.responses["test-request"].bytesReceived,
+            server2client.responses["test-request"].bytesSent);
+  ASSERT_EQ(client2server.pendingRequests.pending, 0u);
+  ASSERT_TRUE(client2server.handlerTime.empty());
+  ASSERT_TRUE(client2server.errors.empty());
+
+  // The periodic callback reports the stats.
+  while (reported.take().value().requests["test-request"].received < 3) {
+  }
+  server->onStats(std::chrono::milliseconds(0), {});
+
+  // Errors are counted by kind.
+  server->send(dap::StoppedEvent());  // no handler registered on the client
+  client->send(createEvent());        // flushes the events to the client
+  while (client->stats().errors.empty()) {
+    std::this_thread::yield();
+  }
+  auto errorStats = client->stats();
+  ASSERT_EQ(errorStats.errors.size(), 1u);
+  ASSERT_EQ(errorStats.errors["No event handler registered for event '%s'"],
+            1u);
+}
+
+TEST_F(SessionTest, Tracing) {
+  class TraceWriter : public dap::Writer {
+   public:
+    bool isOpen() override { return true; }
+    void close() override {}
+    bool write(const void* buffer, size_t n) override {
+      std::unique_lock<std::mutex> lock(mutex);
+      str.append(reinterpret_cast<const char*>(buffer), n);
+      return true;
+    }
+    std::string get() {
+      std::unique_lock<std::mutex> lock(mutex);
+      return str;
+    }
+
+   private:
+    std::mutex mutex;
+    std::string str;
+  };
+
+  server->registerHandler([&](const dap::TestRequest&) {
+    server->send(createEvent());
+    return createResponse();
+  });
+  client->registerHandler([&](const dap::TestEvent&) {});
+
+  auto trace = std::make_shared<TraceWriter>();
+  server->setTracer(dap::Tracer::create(trace));
+
+  bind();
+
+  ASSERT_FALSE(client->send(createRequest()).get().error);
+  server.reset();  // waits for the handler to return
+
+  auto got = trace->get();
+  for (auto stage : {"read", "parse", "queued", "handle", "serialize",
+                     "write"}) {
+    ASSERT_THAT(got, testing::HasSubstr("\"name\":\"" + std::string(stage) +
+                                        "\""));
+  }
+  ASSERT_THAT(got, testing::HasSubstr("\"cat\":\"request\""));
+  ASSERT_THAT(got, testing::HasSubstr("\"cat\":\"response\""));
+  ASSERT_THAT(got, testing::HasSubstr("\"cat\":\"event\""));
+  ASSERT_THAT(got, testing::HasSubstr("\"test-request\""));
+  ASSERT_THAT(got, testing::HasSubstr("\"test-event\""));
+}
+
+TEST(SessionExecutorTest, TracingThreads) {
+  // RecordingTracer records the thread of each stage of the received
+  // requests.
+  class RecordingTracer : public dap::Tracer {
+   public:
+    bool sample() override { return true; }
+    void span(const char* stage,
+              const Message& message,
+              Clock::time_point,
+              Clock::time_point,
+              uint32_t thread) override {
+      if (message.type == "request") {
+        std::unique_lock<std::mutex> lock(mutex);
+        threads[stage] = thread;
+      }
+    }
+    std::mutex mutex;
+    std::map<std::string, uint32_t> threads;
+  };
+
+  dap::Session::Options options;
+  options.executor = dap::Executor::create(1);
+  auto client = dap::Session::create();
+  auto server = dap::Session::create(options);
+  auto tracer = std::make_shared<RecordingTracer>();
+  server->setTracer(tracer);
+  std::atomic<uint32_t> handlerThread = {0};
+  server->registerHandler([&](const dap::TestRequest&) {
+    handlerThread = dap::Tracer::currentThread();
+    return createResponse();
+  });
+
+  auto client2server = dap::pipe();
+  auto server2client = dap::pipe();
+  client->bind(server2client, client2server);
+  server->bind(client2server, server2client);
+  ASSERT_FALSE(client->send(createRequest()).get().error);
+  server.reset();
+
+  // The message is read on the receive thread, and parsed and handled on the
+  // executor.
+  std::unique_lock<std::mutex> lock(tracer->mutex);
+  ASSERT_EQ(tracer->threads.size(), 4u);
+  ASSERT_EQ(tracer->threads["parse"], handlerThread.load());
+  ASSERT_EQ(tracer->threads["handle"], handlerThread.load());
+  ASSERT_NE(tracer->threads["read"], handlerThread.load());
+  ASSERT_NE(tracer->threads["read"], dap::Tracer::currentThread());
+}
+
+TEST_F(SessionTest, StringPool) {
+  auto pool = dap::StringPool::create();
+  server->setStringPool(pool);
+
+  std::vector<dap::interned_string> received;
+  server->registerHandler([&](const dap::TestInternedRequest& req) {
+    received.push_back(req.s);
+    return createResponse();
+  });
+
+  bind();
+
+  auto request = createRequest();
+  ASSERT_FALSE(client->send(request).get().error);
+  ASSERT_FALSE(client->send(request).get().error);
+  ASSERT_EQ(received.size(), 2u);
+  ASSERT_EQ(received[0].str(), request.s);
+  ASSERT_EQ(&received[0].str(), &received[1].str());
+  ASSERT_EQ(pool->size(), 1u);
+}
+
+TEST_F(SessionTest, StringPoolReleased) {
+  auto pool = dap::StringPool::create();
+  server->setStringPool(pool);
+  server->registerHandler(
+      [&](const dap::TestInternedRequest&) { return createResponse(); });
+
+  bind();
+
+  ASSERT_FALSE(client->send(createRequest()).get().error);
+
+  // A replaced pool is released once no message is using it.
+  server->setStringPool(dap::StringPool::create());
+  server->setStringPool(nullptr);
+  ASSERT_EQ(pool.use_count(), 1);
+}
+
+TEST_F(SessionTest, PairInProcess) {
+  dap::TestRequest received;
+  server->registerHandler([&](const dap::TestRequest& req) {
+    received = req;
+    server->send(createEvent());
+    return createResponse();
+  });
+  dap::Chan<dap::TestEvent> events;
+  client->registerHandler(
+      [&](const dap::TestEvent& event) { events.put(event); });
+
+  dap::Session::pairInProcess(client.get(), server.get());
+
+  auto request = createRequest();
+  auto got = client->send(request).get();
+  ASSERT_FALSE(got.error);
+  ASSERT_EQ(received.i, request.i);
+  ASSERT_EQ(received.a, request.a);
+  ASSERT_EQ(received.o["c"].get<dap::string>(), "3");
+  ASSERT_EQ(received.s, request.s);
+  ASSERT_EQ(received.o2, request.o2);
+
+  auto response = createResponse();
+  ASSERT_EQ(got.response.i, response.i);
+  ASSERT_EQ(got.response.a, response.a);
+  ASSERT_EQ(got.response.s, response.s);
+  ASSERT_EQ(got.response.o1, response.o1);
+
+  auto event = events.take();
+  ASSERT_TRUE(event.has_value());
+  ASSERT_EQ(event->s, "event");
+
+  // Nothing is serialized or parsed.
+  auto stats = client->stats();
+  ASSERT_EQ(stats.requests["test-request"].sent, 1u);
+  ASSERT_EQ(stats.requests["test-request"].bytesSent, 0u);
+  ASSERT_EQ(stats.responses["test-request"].received, 1u);
+  ASSERT_EQ(stats.serializeTime.count, 0u);
+  ASSERT_EQ(stats.parseTime.count, 0u);
+}
+
+TEST_F(SessionTest, PairInProcessError) {
+  server->registerHandler(
+      [&](const dap::TestRequest&) -> dap::ResponseOrError<dap::TestResponse> {
+        return dap::Error("Oh noes!");
+      });
+
+  dap::Session::pairInProcess(client.get(), server.get());
+
+  auto got = client->send(createRequest()).get();
+  ASSERT_TRUE(got.error);
+  ASSERT_EQ(got.error.message, "Oh noes!");
+}
+
+TEST_F(SessionTest, PairInProcessConvertsTypes) {
+  dap::TestRequestSubset received;
+  server->registerHandler([&](const dap::TestRequestSubset& req) {
+    received = req;
+    return createResponse();
+  });
+
+  dap::Session::pairInProcess(client.get(), server.get());
+
+  auto request = createRequest();
+  ASSERT_FALSE(client->send(request).get().error);
+  ASSERT_EQ(received.i, request.i);
+  ASSERT_EQ(received.s, request.s);
+}
+
+TEST_F(SessionTest, PairInProcessClose) {
+  server->registerHandler(
+      [&](const dap::TestRequest&) { return createResponse(); });
+
+  dap::Session::pairInProcess(client.get(), server.get());
+
+  ASSERT_FALSE(client->send(createRequest()).get().error);
+  server.reset();
+
+  // Sending to the destructed session fails.
+  ASSERT_TRUE(client->send(createRequest()).get().error);
+}
+
+TEST_F(SessionTest, PairInProcessClosedHandler) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool clientClosed = false;
+  dap::Session::pairInProcess(client.get(), server.get(), [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    clientClosed = true;
+    cv.notify_all();
+  });
+
+  // Destructing the server notifies the client.
+  server.reset();
+  std::unique_lock<std::mutex> lock(mutex);
+  ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5),
+                          [&] { return clientClosed; }));
+}
+
+TEST_F(SessionTest, PairInProcessRequestView) {
+  dap::string s;
+  dap::TestRequestSubset received;
+  server->registerHandler(
+      [&](const dap::RequestView<dap::TestRequestSubset>& req) {
+        EXPECT_TRUE(req.field("req_s", &s));
+        received = req.get();
+        return createResponse();
+      });
+
+  dap::Session::pairInProcess(client.get(), server.get());
+
+  auto request = createRequest();
+  ASSERT_FALSE(client->send(request).get().error);
+  ASSERT_EQ(s, request.s);
+  ASSERT_EQ(received.i, request.i);
+  ASSERT_EQ(received.s, request.s);
+}
+
+TEST_F(SessionTest, PairInProcessSendOutput) {
+  dap::Chan<dap::OutputEvent> received;
+  server->registerHandler(
+      [&](const dap::OutputEvent& e) { received.put(e); });
+
+  dap::Session::pairInProcess(client.get(), server.get());
+
+  ASSERT_TRUE(client->sendOutput("hello\n", 6, "console"));
+  auto got = received.take();
+  ASSERT_TRUE(got.has_value());
+  ASSERT_EQ(got->category.value(""), "console");
+  ASSERT_EQ(got->output, "hello\n");
+}
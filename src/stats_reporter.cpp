@@ -0,0 +1,50 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "stats_reporter.h"
+
+namespace dap {
+
+StatsReporter::StatsReporter(TimerWheel* timers, const Get& get)
+    : timers(timers), get(get) {}
+
+void StatsReporter::set(std::chrono::milliseconds i, const Handler& h) {
+  std::unique_lock<std::mutex> lock(mutex);
+  timers->cancel(timer);
+  generation++;
+  interval = i;
+  handler = h;
+  if (handler && interval.count() > 0) {
+    scheduleLocked();
+  }
+}
+
+void StatsReporter::scheduleLocked() {
+  auto scheduled = generation;
+  timer = timers->schedule(interval, [this, scheduled] {
+    Handler h;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (scheduled != generation) {
+        return;  // replaced by a later call to set()
+      }
+      h = handler;
+      scheduleLocked();
+    }
+    h(get());
+  });
+}
+
+}  // namespace dap
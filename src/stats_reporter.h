@@ -0,0 +1,68 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef dap_stats_reporter_h
+#define dap_stats_reporter_h
+
+#include "timer_wheel.h"
+
+#include "dap/session.h"
+
+#include <stdint.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+namespace dap {
+
+// StatsReporter periodically passes the stats of a Session to the handler set
+// by Session::onStats(). The handler is called on the TimerWheel's thread.
+class StatsReporter {
+ public:
+  using Handler = Session::StatsHandler;
+
+  // Get is the function that returns the current stats of the Session.
+  using Get = std::function<SessionStats()>;
+
+  // timers is used to schedule the calls to the handler, and must outlive the
+  // StatsReporter's timers.
+  StatsReporter(TimerWheel* timers, const Get& get);
+
+  // set() replaces the handler and the interval between its calls. The
+  // handler is no longer called if it is empty or the interval is zero.
+  void set(std::chrono::milliseconds interval, const Handler& handler);
+
+ private:
+  StatsReporter(const StatsReporter&) = delete;
+  StatsReporter& operator=(const StatsReporter&) = delete;
+
+  // scheduleLocked() schedules the next call to the handler.
+  // mutex must be held.
+  void scheduleLocked();
+
+  TimerWheel* const timers;
+  const Get get;
+  std::mutex mutex;
+  Handler handler;                          // guarded by mutex
+  std::chrono::milliseconds interval = {};  // guarded by mutex
+  TimerWheel::Id timer = 0;                 // guarded by mutex
+  // Incremented by set(), so that a timer that fires after the handler has
+  // been replaced does nothing.
+  uint64_t generation = 0;  // guarded by mutex
+};
+
+}  // namespace dap
+
+#endif  // dap_stats_reporter_h
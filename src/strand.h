@@ -0,0 +1,128 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_strand_h
+#define dap_strand_h
+
+#include "dap/executor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace dap {
+
+// Strand runs tasks on an Executor one at a time, in the order they were
+// posted. Tasks posted to different Strands may run concurrently.
+class Strand {
+ public:
+  using Task = std::function<void()>;
+
+  inline Strand(const std::shared_ptr<Executor>& executor);
+  inline ~Strand();
+
+  // post() schedules task to run once all previously posted tasks have
+  // completed. Returns false if the strand has been closed.
+  inline bool post(Task&& task);
+
+  // close() discards any tasks that have not yet started, and blocks until the
+  // currently running task, if any, has returned. close() must not be called
+  // from a task running on the strand.
+  inline void close();
+
+ private:
+  // The maximum number of tasks run before yielding the executor thread to
+  // other work.
+  static constexpr int kMaxBatch = 32;
+
+  // State is shared with the tasks enqueued on the executor, which may run
+  // after the Strand has been destructed.
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Task> tasks;
+    bool scheduled = false;  // a drain() task is enqueued on the executor
+    bool running = false;    // a posted task is currently running
+    bool closed = false;
+  };
+
+  // drain() runs the posted tasks. The executor is passed as a raw pointer, as
+  // the executor must not be destructed by one of its own tasks.
+  inline static void drain(Executor* executor,
+                           const std::shared_ptr<State>& state);
+
+  Strand(const Strand&) = delete;
+  Strand& operator=(const Strand&) = delete;
+
+  const std::shared_ptr<Executor> executor;
+  const std::shared_ptr<State> state;
+};
+
+Strand::Strand(const std::shared_ptr<Executor>& executor)
+    : executor(executor), state(std::make_shared<State>()) {}
+
+Strand::~Strand() {
+  close();
+}
+
+bool Strand::post(Task&& task) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  if (state->closed) {
+    return false;
+  }
+  state->tasks.emplace_back(std::move(task));
+  if (!state->scheduled) {
+    state->scheduled = true;
+    lock.unlock();
+    auto e = executor.get();
+    auto s = state;
+    executor->enqueue([e, s] { drain(e, s); });
+  }
+  return true;
+}
+
+void Strand::close() {
+  std::deque<Task> discarded;
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->closed = true;
+  std::swap(discarded, state->tasks);
+  state->cv.wait(lock, [&] { return !state->running; });
+}
+
+void Strand::drain(Executor* executor, const std::shared_ptr<State>& state) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  for (int i = 0; i < kMaxBatch; i++) {
+    if (state->closed || state->tasks.empty()) {
+      state->scheduled = false;
+      return;
+    }
+    auto task = std::move(state->tasks.front());
+    state->tasks.pop_front();
+    state->running = true;
+    lock.unlock();
+    task();
+    task = nullptr;
+    lock.lock();
+    state->running = false;
+    state->cv.notify_all();
+  }
+  // Yield to other work, then continue with the remaining tasks.
+  lock.unlock();
+  executor->enqueue([executor, state] { drain(executor, state); });
+}
+
+}  // namespace dap
+
+#endif  // dap_strand_h
@@ -0,0 +1,182 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef dap_timer_wheel_h
+#define dap_timer_wheel_h
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dap {
+
+// TimerWheel is a hashed timing wheel that calls functions after a delay.
+// All timers are serviced by a single thread, which is only started when the
+// first timer is scheduled, and which sleeps while there are no timers.
+// Timer callbacks are called on the TimerWheel thread, and must not block.
+class TimerWheel {
+ public:
+  using Callback = std::function<void()>;
+  using Id = uint64_t;
+
+  // resolution is the duration of a single tick of the wheel. Timers fire on
+  // the first tick at or after their deadline.
+  // numSlots is the number of slots in the wheel. Timers with a delay longer
+  // than resolution * numSlots wrap around the wheel.
+  inline TimerWheel(
+      std::chrono::milliseconds resolution = std::chrono::milliseconds(10),
+      size_t numSlots = 512);
+  inline ~TimerWheel();
+
+  // schedule() calls callback once delay has elapsed, returning an identifier
+  // that can be passed to cancel().
+  inline Id schedule(std::chrono::milliseconds delay, Callback&& callback);
+
+  // cancel() prevents the timer with the given identifier from firing.
+  // Returns true if the timer was cancelled, or false if the timer has already
+  // fired or was already cancelled.
+  inline bool cancel(Id id);
+
+  // size() returns the number of timers that have not yet fired.
+  inline size_t size();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Timer {
+    uint64_t rounds;  // number of times around the wheel before firing
+    Callback callback;
+  };
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  inline void run();
+
+  const Clock::duration resolution;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::unordered_map<Id, Timer>> slots;
+  std::unordered_map<Id, size_t> slotOf;  // timer id to slots index
+  size_t cursor = 0;
+  Clock::time_point nextTick;
+  Id nextId = 1;
+  bool shutdown = false;
+  std::thread thread;
+};
+
+TimerWheel::TimerWheel(std::chrono::milliseconds resolution, size_t numSlots)
+    : resolution(resolution), slots(numSlots) {}
+
+TimerWheel::~TimerWheel() {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    shutdown = true;
+    cv.notify_all();
+  }
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+TimerWheel::Id TimerWheel::schedule(std::chrono::milliseconds delay,
+                                    Callback&& callback) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!thread.joinable()) {
+    nextTick = Clock::now() + resolution;
+    thread = std::thread([this] { run(); });
+  }
+  auto numTicks = static_cast<uint64_t>(
+      (std::chrono::duration_cast<Clock::duration>(delay) + resolution -
+       Clock::duration(1)) /
+      resolution);
+  if (numTicks == 0) {
+    numTicks = 1;
+  }
+  auto slot = (cursor + numTicks) % slots.size();
+  auto id = nextId++;
+  slots[slot].emplace(id, Timer{(numTicks - 1) / slots.size(),
+                                std::move(callback)});
+  slotOf.emplace(id, slot);
+  if (slotOf.size() == 1) {
+    nextTick = Clock::now() + resolution;
+    cv.notify_all();
+  }
+  return id;
+}
+
+bool TimerWheel::cancel(Id id) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto it = slotOf.find(id);
+  if (it == slotOf.end()) {
+    return false;
+  }
+  slots[it->second].erase(id);
+  slotOf.erase(it);
+  return true;
+}
+
+size_t TimerWheel::size() {
+  std::unique_lock<std::mutex> lock(mutex);
+  return slotOf.size();
+}
+
+void TimerWheel::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  std::vector<Callback> expired;
+  while (!shutdown) {
+    if (slotOf.empty()) {
+      cv.wait(lock, [&] { return shutdown || !slotOf.empty(); });
+      continue;
+    }
+    if (cv.wait_until(lock, nextTick, [&] { return shutdown; })) {
+      break;
+    }
+    // Advance the wheel by each tick that has elapsed.
+    auto now = Clock::now();
+    while (nextTick <= now) {
+      nextTick += resolution;
+      cursor = (cursor + 1) % slots.size();
+      auto& slot = slots[cursor];
+      for (auto it = slot.begin(); it != slot.end();) {
+        if (it->second.rounds == 0) {
+          expired.emplace_back(std::move(it->second.callback));
+          slotOf.erase(it->first);
+          it = slot.erase(it);
+        } else {
+          it->second.rounds--;
+          ++it;
+        }
+      }
+    }
+    if (!expired.empty()) {
+      lock.unlock();
+      for (auto& callback : expired) {
+        callback();
+      }
+      expired.clear();
+      lock.lock();
+    }
+  }
+}
+
+}  // namespace dap
+
+#endif  // dap_timer_wheel_h
@@ -0,0 +1,51 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "timer_wheel.h"
+
+#include "chan.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+TEST(TimerWheel, FiresInOrder) {
+  dap::TimerWheel timers(std::chrono::milliseconds(1), 4);
+  dap::Chan<int> fired;
+  // Delays longer than the wheel wrap around it.
+  timers.schedule(std::chrono::milliseconds(30), [&] { fired.put(3); });
+  timers.schedule(std::chrono::milliseconds(2), [&] { fired.put(1); });
+  timers.schedule(std::chrono::milliseconds(15), [&] { fired.put(2); });
+  ASSERT_EQ(fired.take().value(), 1);
+  ASSERT_EQ(fired.take().value(), 2);
+  ASSERT_EQ(fired.take().value(), 3);
+  ASSERT_EQ(timers.size(), 0U);
+}
+
+TEST(TimerWheel, Cancel) {
+  dap::TimerWheel timers(std::chrono::milliseconds(1));
+  dap::Chan<int> fired;
+  auto id = timers.schedule(std::chrono::milliseconds(5), [&] { fired.put(1); });
+  timers.schedule(std::chrono::milliseconds(20), [&] { fired.put(2); });
+  ASSERT_TRUE(timers.cancel(id));
+  ASSERT_FALSE(timers.cancel(id));
+  ASSERT_EQ(fired.take().value(), 2);
+}
+
+TEST(TimerWheel, DestructWithPendingTimers) {
+  dap::TimerWheel timers;
+  timers.schedule(std::chrono::milliseconds(60000), [] { FAIL(); });
+  ASSERT_EQ(timers.size(), 1U);
+}
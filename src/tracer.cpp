@@ -0,0 +1,118 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/tracer.h"
+#include "dap/io.h"
+
+#include "json_string.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+
+namespace {
+
+// appendMicroseconds() appends the duration to out as a number of
+// microseconds, with up to three decimal places.
+void appendMicroseconds(std::chrono::nanoseconds duration, std::string* out) {
+  auto ns = static_cast<long long>(duration.count());
+  auto abs = llabs(ns);
+  char buf[32];
+  int n = snprintf(buf, sizeof(buf), "%s%lld.%03d", ns < 0 ? "-" : "",
+                   abs / 1000, static_cast<int>(abs % 1000));
+  // Trim the trailing zeros, and the decimal point if there is no fraction.
+  while (buf[n - 1] == '0') {
+    n--;
+  }
+  if (buf[n - 1] == '.') {
+    n--;
+  }
+  out->append(buf, n);
+}
+
+// appendString() appends str to out as a JSON string.
+void appendString(const std::string& str, std::string* out) {
+  out->push_back('"');
+  dap::json::escapeString(str.data(), str.size(), out);
+  out->push_back('"');
+}
+
+class ChromeTracer : public dap::Tracer {
+ public:
+  ChromeTracer(const std::shared_ptr<dap::Writer>& writer, uint32_t sampleEvery)
+      : writer(writer),
+        sampleEvery(sampleEvery > 0 ? sampleEvery : 1),
+        epoch(Clock::now()) {
+    writer->write("[\n", 2);
+  }
+
+  bool sample() override {
+    return counter.fetch_add(1, std::memory_order_relaxed) % sampleEvery == 0;
+  }
+
+  // span() writes the trace event as a single line of compact JSON, formatted
+  // directly so that the output does not depend on the JSON library.
+  void span(const char* stage,
+            const Message& message,
+            Clock::time_point start,
+            Clock::time_point end,
+            uint32_t thread) override {
+    std::string line;
+    line += "{\"name\":\"";
+    dap::json::escapeString(stage, strlen(stage), &line);
+    line += "\",\"cat\":";
+    appendString(message.type, &line);
+    line += ",\"ph\":\"X\",\"ts\":";
+    appendMicroseconds(start - epoch, &line);
+    line += ",\"dur\":";
+    appendMicroseconds(end - start, &line);
+    line += ",\"pid\":1,\"tid\":";
+    line += std::to_string(thread);
+    line += ",\"args\":{\"name\":";
+    appendString(message.name, &line);
+    line += ",\"seq\":";
+    line += std::to_string(static_cast<int64_t>(message.seq));
+    line += "}},\n";
+    std::unique_lock<std::mutex> lock(mutex);
+    writer->write(line.data(), line.size());
+  }
+
+ private:
+  const std::shared_ptr<dap::Writer> writer;
+  const uint32_t sampleEvery;
+  const Clock::time_point epoch;
+  std::atomic<uint32_t> counter = {0};
+  std::mutex mutex;
+};
+
+}  // anonymous namespace
+
+namespace dap {
+
+Tracer::~Tracer() = default;
+
+uint32_t Tracer::currentThread() {
+  static std::atomic<uint32_t> nextId = {1};
+  thread_local uint32_t id = nextId++;
+  return id;
+}
+
+std::shared_ptr<Tracer> Tracer::create(const std::shared_ptr<Writer>& w,
+                                       uint32_t sampleEvery /* = 1 */) {
+  return std::make_shared<ChromeTracer>(w, sampleEvery);
+}
+
+}  // namespace dap
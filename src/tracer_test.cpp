@@ -0,0 +1,96 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dap/tracer.h"
+#include "dap/io.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+namespace {
+
+class StringWriter : public dap::Writer {
+ public:
+  bool isOpen() override { return true; }
+  void close() override {}
+  bool write(const void* buffer, size_t n) override {
+    str.append(reinterpret_cast<const char*>(buffer), n);
+    return true;
+  }
+
+  std::string str;
+};
+
+}  // anonymous namespace
+
+TEST(Tracer, ChromeTraceFormat) {
+  auto writer = std::make_shared<StringWriter>();
+  auto tracer = dap::Tracer::create(writer);
+
+  dap::Tracer::Message message;
+  message.type = "request";
+  message.name = "launch";
+  message.seq = 3;
+  auto start = dap::Tracer::Clock::now();
+  tracer->span("parse", message, start, start + std::chrono::microseconds(5),
+               7);
+
+  ASSERT_EQ(writer->str.substr(0, 2), "[\n");
+  ASSERT_THAT(writer->str, testing::HasSubstr(
+                               "{\"name\":\"parse\",\"cat\":\"request\","
+                               "\"ph\":\"X\",\"ts\":"));
+  ASSERT_THAT(writer->str, testing::HasSubstr(
+                               ",\"dur\":5,\"pid\":1,\"tid\":7,\"args\":"
+                               "{\"name\":\"launch\",\"seq\":3}},\n"));
+  ASSERT_EQ(writer->str.substr(writer->str.size() - 2), ",\n");
+}
+
+TEST(Tracer, Durations) {
+  auto writer = std::make_shared<StringWriter>();
+  auto tracer = dap::Tracer::create(writer);
+
+  dap::Tracer::Message message;
+  message.type = "event";
+  message.name = "quote\"d";
+  auto start = dap::Tracer::Clock::now();
+  tracer->span("write", message, start, start + std::chrono::nanoseconds(1250),
+               1);
+  tracer->span("write", message, start, start + std::chrono::nanoseconds(40),
+               1);
+
+  ASSERT_THAT(writer->str, testing::HasSubstr("\"dur\":1.25,"));
+  ASSERT_THAT(writer->str, testing::HasSubstr("\"dur\":0.04,"));
+  ASSERT_THAT(writer->str, testing::HasSubstr("\"name\":\"quote\\\"d\""));
+}
+
+TEST(Tracer, CurrentThread) {
+  auto id = dap::Tracer::currentThread();
+  ASSERT_EQ(dap::Tracer::currentThread(), id);
+  uint32_t other = 0;
+  std::thread([&] { other = dap::Tracer::currentThread(); }).join();
+  ASSERT_NE(other, id);
+}
+
+TEST(Tracer, Sampling) {
+  auto tracer = dap::Tracer::create(std::make_shared<StringWriter>(), 4);
+  int sampled = 0;
+  for (int i = 0; i < 100; i++) {
+    if (tracer->sample()) {
+      sampled++;
+    }
+  }
+  ASSERT_EQ(sampled, 25);
+}
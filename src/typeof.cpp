@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "dap/bytes.h"
+#include "dap/interned_string.h"
+#include "dap/raw_json.h"
 #include "dap/typeof.h"
 
 #include <atomic>
@@ -60,13 +63,42 @@ struct TypeInfos {
     }
   };
 
+  struct InternedStringTI : public dap::TypeInfo {
+    using interned_string = dap::interned_string;
+    inline std::string name() const override { return "interned_string"; }
+    inline size_t size() const override { return sizeof(interned_string); }
+    inline size_t alignment() const override {
+      return alignof(interned_string);
+    }
+    inline void construct(void* ptr) const override {
+      new (ptr) interned_string();
+    }
+    inline void copyConstruct(void* dst, const void* src) const override {
+      new (dst)
+          interned_string(*reinterpret_cast<const interned_string*>(src));
+    }
+    inline void destruct(void* ptr) const override {
+      reinterpret_cast<interned_string*>(ptr)->~interned_string();
+    }
+    inline bool deserialize(const dap::Deserializer* d,
+                            void* ptr) const override {
+      return d->deserialize(reinterpret_cast<interned_string*>(ptr));
+    }
+    inline bool serialize(dap::Serializer* s, const void* ptr) const override {
+      return s->serialize(reinterpret_cast<const interned_string*>(ptr)->str());
+    }
+  };
+
   dap::BasicTypeInfo<dap::boolean> boolean = {"boolean"};
   dap::BasicTypeInfo<dap::string> string = {"string"};
   dap::BasicTypeInfo<dap::integer> integer = {"integer"};
   dap::BasicTypeInfo<dap::number> number = {"number"};
   dap::BasicTypeInfo<dap::object> object = {"object"};
   dap::BasicTypeInfo<dap::any> any = {"any"};
+  dap::BasicTypeInfo<dap::raw_json> raw_json = {"raw_json"};
+  dap::BasicTypeInfo<dap::bytes> bytes = {"bytes"};
   NullTI null;
+  InternedStringTI internedString;
   std::vector<std::unique_ptr<dap::TypeInfo>> types;
 
  private:
@@ -129,6 +161,18 @@ const TypeInfo* TypeOf<null>::type() {
   return &TypeInfos::get()->null;
 }
 
+const TypeInfo* TypeOf<raw_json>::type() {
+  return &TypeInfos::get()->raw_json;
+}
+
+const TypeInfo* TypeOf<bytes>::type() {
+  return &TypeInfos::get()->bytes;
+}
+
+const TypeInfo* TypeOf<interned_string>::type() {
+  return &TypeInfos::get()->internedString;
+}
+
 void TypeInfo::deleteOnExit(TypeInfo* ti) {
   TypeInfos::get()->types.emplace_back(std::unique_ptr<TypeInfo>(ti));
 }